@@ -0,0 +1,56 @@
+/// AnalysisBench.cpp
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "Analysis.h"
+#include "Compressor.h"
+
+namespace {
+auto make_compressors(const size_t count) -> std::vector<Compressor<float>> {
+    std::vector<Compressor<float>> processors;
+    processors.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        processors.push_back(*Compressor<float>::create(
+                {.sampleRate = 48000,
+                 .threshold = -40.0f + static_cast<float>(i % 40),
+                 .attack = std::chrono::milliseconds(1 + i % 30),
+                 .release = std::chrono::milliseconds(20 + i % 300),
+                 .ratio = 1.5f + static_cast<float>(i % 10),
+                 .makeupGain = 1.0f,
+                 .kneeWidth = 6.0f}));
+    }
+    return processors;
+}
+} // namespace
+
+/// One gain-reduction curve of 256 points per processor
+static void BM_TransferCurves(benchmark::State &state) {
+    const std::vector<Compressor<float>> processors =
+            make_compressors(static_cast<size_t>(state.range(0)));
+    std::vector<float> levels(256);
+    for (size_t i = 0; i < levels.size(); i++) {
+        levels[i] = -96.0f + 0.4f * static_cast<float>(i);
+    }
+    std::vector<float> curves(processors.size() * levels.size());
+    for (auto _: state) {
+        transfer_curves<Compressor<float>>(processors, levels, curves);
+        benchmark::DoNotOptimize(curves.data());
+    }
+    state.SetItemsProcessed(state.iterations() * curves.size());
+}
+BENCHMARK(BM_TransferCurves)->Arg(1)->Arg(100)->Arg(1000);
+
+/// 100 ms step responses
+static void BM_StepResponses(benchmark::State &state) {
+    const std::vector<Compressor<float>> processors =
+            make_compressors(static_cast<size_t>(state.range(0)));
+    constexpr size_t length = 4800;
+    std::vector<float> responses(processors.size() * length);
+    for (auto _: state) {
+        step_responses<Compressor<float>>(processors, -80.0f, -6.0f, length,
+                                          responses);
+        benchmark::DoNotOptimize(responses.data());
+    }
+    state.SetItemsProcessed(state.iterations() * responses.size());
+}
+BENCHMARK(BM_StepResponses)->Arg(1)->Arg(100)->Arg(1000);
@@ -0,0 +1,84 @@
+/// AutomixerBench.cpp
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "Automixer.h"
+#include "NoiseGate.h"
+
+/// Gain sharing across many microphones, interleaved and planar, against
+/// running a noise gate on every microphone.
+
+namespace {
+constexpr size_t frames = 512;
+
+auto make_config(const size_t channels) -> AutomixerConfiguration<float> {
+    return {.sampleRate = 48000,
+            .channels = channels,
+            .attack = std::chrono::milliseconds(1),
+            .release = std::chrono::milliseconds(50)};
+}
+
+auto make_samples(const size_t count) -> std::vector<float> {
+    std::vector<float> samples(count);
+    for (size_t i = 0; i < count; i++) {
+        samples[i] = static_cast<float>(((i * 37) % 101) / 101.0 - 0.5);
+    }
+    return samples;
+}
+} // namespace
+
+static void BM_AutomixerInterleaved(benchmark::State &state) {
+    const auto channels = static_cast<size_t>(state.range(0));
+    auto automixer = Automixer<float>::create(make_config(channels));
+    std::vector<float> samples = make_samples(channels * frames);
+    for (auto _: state) {
+        automixer->process(samples.data(), samples.size());
+        benchmark::DoNotOptimize(samples.data());
+    }
+    state.SetItemsProcessed(state.iterations() * channels * frames);
+}
+BENCHMARK(BM_AutomixerInterleaved)
+        ->ArgName("channels")
+        ->Arg(16)
+        ->Arg(32)
+        ->Arg(64);
+
+static void BM_AutomixerPlanar(benchmark::State &state) {
+    const auto channels = static_cast<size_t>(state.range(0));
+    auto automixer = Automixer<float>::create(make_config(channels));
+    std::vector<std::vector<float>> samples(channels, make_samples(frames));
+    std::vector<float *> pointers;
+    for (std::vector<float> &channel: samples) {
+        pointers.push_back(channel.data());
+    }
+    for (auto _: state) {
+        automixer->process(pointers.data(), frames);
+        benchmark::DoNotOptimize(samples.data());
+    }
+    state.SetItemsProcessed(state.iterations() * channels * frames);
+}
+BENCHMARK(BM_AutomixerPlanar)->ArgName("channels")->Arg(16)->Arg(32)->Arg(64);
+
+static void BM_NoiseGatePerChannel(benchmark::State &state) {
+    const auto channels = static_cast<size_t>(state.range(0));
+    std::vector<NoiseGate<float>> gates(
+            channels,
+            *NoiseGate<float>::create({.sampleRate = 48000,
+                                       .threshold = -40.0f,
+                                       .attack = std::chrono::milliseconds(1),
+                                       .release =
+                                               std::chrono::milliseconds(50)}));
+    std::vector<std::vector<float>> samples(channels, make_samples(frames));
+    for (auto _: state) {
+        for (size_t c = 0; c < channels; c++) {
+            gates[c].process(samples[c].data(), frames);
+        }
+        benchmark::DoNotOptimize(samples.data());
+    }
+    state.SetItemsProcessed(state.iterations() * channels * frames);
+}
+BENCHMARK(BM_NoiseGatePerChannel)
+        ->ArgName("channels")
+        ->Arg(16)
+        ->Arg(32)
+        ->Arg(64);
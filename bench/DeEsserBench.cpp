@@ -0,0 +1,45 @@
+/// DeEsserBench.cpp
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "DeEsser.h"
+
+/// Cost per sample of the de-esser as the channel count grows. The sidechain
+/// filter runs across channels; the gain computer's log and exp per channel
+/// dominate what remains.
+
+namespace {
+constexpr size_t frames = 1024;
+} // namespace
+
+template<typename T, typename S>
+static void BM_DeEsser(benchmark::State &state) {
+    const auto channels = static_cast<size_t>(state.range(0));
+    const auto mode = static_cast<DeEsserMode>(state.range(1));
+    std::optional<DeEsser<T, S>> deEsser = DeEsser<T, S>::create(
+            {.sampleRate = 48000,
+             .threshold = static_cast<T>(-30),
+             .attack = std::chrono::milliseconds(1),
+             .release = std::chrono::milliseconds(50),
+             .ratio = static_cast<T>(6),
+             .mode = mode,
+             .channels = channels});
+    std::vector<T> input(frames * channels);
+    for (size_t i = 0; i < input.size(); i++) {
+        input[i] = static_cast<T>(0.05 + 0.9 * ((i * 37) % 101) / 101.0);
+    }
+    std::vector<T> samples = input;
+    for (auto _: state) {
+        samples = input;
+        deEsser->process(samples.data(), samples.size());
+        benchmark::DoNotOptimize(samples.data());
+    }
+    state.SetItemsProcessed(state.iterations() * samples.size());
+}
+BENCHMARK(BM_DeEsser<float, float>)
+        ->ArgsProduct({{1, 2, 8, 16},
+                       {static_cast<int64_t>(DeEsserMode::Wideband),
+                        static_cast<int64_t>(DeEsserMode::SplitBand)}});
+BENCHMARK(BM_DeEsser<double, double>)
+        ->ArgsProduct({{1, 2, 8, 16},
+                       {static_cast<int64_t>(DeEsserMode::SplitBand)}});
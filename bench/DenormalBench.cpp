@@ -0,0 +1,116 @@
+/// DenormalBench.cpp
+
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "Compressor.h"
+#include "LoudnessNormalizer.h"
+#include "NoiseGate.h"
+
+/// Per-sample cost of each processor on signal, in long silence and across the
+/// transition between the two. With the denormal guard and flushed state,
+/// silence is never slower than signal.
+
+namespace {
+constexpr size_t blockSize = 4096;
+
+/** Samples of silence run before measuring, long enough for float envelopes
+ * to decay below the smallest normal value */
+constexpr size_t settleLength = 48000 * 30;
+
+enum Phase : int64_t { Signal = 0, Silence = 1, Transition = 2 };
+
+auto make_block(const int64_t phase) -> std::vector<float> {
+    std::vector<float> samples(blockSize, 0.0f);
+    for (size_t i = 0; i < blockSize; i++) {
+        const float signal =
+                std::sin(static_cast<float>(i) * 0.05f) * 0.8f;
+        if (phase == Signal || (phase == Transition && i < blockSize / 8)) {
+            samples[i] = signal;
+        }
+    }
+    return samples;
+}
+
+template<typename P>
+auto run(benchmark::State &state, P &processor) -> void {
+    const int64_t phase = state.range(0);
+    std::vector<float> samples = make_block(Signal);
+    processor.process(samples.data(), samples.size());
+    if (phase != Signal) {
+        std::vector<float> silence(blockSize, 0.0f);
+        for (size_t i = 0; i < settleLength; i += blockSize) {
+            silence.assign(blockSize, 0.0f);
+            processor.process(silence.data(), silence.size());
+        }
+    }
+    const std::vector<float> input = make_block(phase);
+    for (auto _: state) {
+        samples = input;
+        processor.process(samples.data(), samples.size());
+        benchmark::DoNotOptimize(samples.data());
+    }
+    state.SetItemsProcessed(state.iterations() * blockSize);
+}
+} // namespace
+
+static void BM_CompressorSilence(benchmark::State &state) {
+    constexpr auto config = CompressorConfiguration<float>{
+            .sampleRate = 48000,
+            .threshold = -20.0f,
+            .attack = std::chrono::milliseconds(10),
+            .release = std::chrono::milliseconds(100),
+            .ratio = 4.0f,
+            .makeupGain = 1.0f};
+    std::optional<Compressor<float>> compressor =
+            Compressor<float>::create(config);
+    run(state, *compressor);
+}
+BENCHMARK(BM_CompressorSilence)->Arg(Signal)->Arg(Silence)->Arg(Transition);
+
+static void BM_NoiseGateSilence(benchmark::State &state) {
+    constexpr auto config = NoiseGateConfiguration<float>{
+            .sampleRate = 48000,
+            .threshold = -20.0f,
+            .attack = std::chrono::milliseconds(10),
+            .release = std::chrono::milliseconds(100)};
+    std::optional<NoiseGate<float>> noiseGate =
+            NoiseGate<float>::create(config);
+    run(state, *noiseGate);
+}
+BENCHMARK(BM_NoiseGateSilence)->Arg(Signal)->Arg(Silence)->Arg(Transition);
+
+static void BM_LoudnessNormalizerSilence(benchmark::State &state) {
+    constexpr auto config = LoudnessNormalizerConfiguration<float>{
+            .sampleRate = 48000,
+            .attack = std::chrono::milliseconds(100),
+            .release = std::chrono::milliseconds(1000)};
+    std::optional<LoudnessNormalizer<float>> normalizer =
+            LoudnessNormalizer<float>::create(config);
+    run(state, *normalizer);
+}
+BENCHMARK(BM_LoudnessNormalizerSilence)
+        ->Arg(Signal)
+        ->Arg(Silence)
+        ->Arg(Transition);
+
+/// Reference: the same one-pole decay without the guard or flushing, which
+/// slows down once the state goes subnormal.
+static void BM_UnguardedDecay(benchmark::State &state) {
+    const float release = std::exp(-std::log10(9.0f) / (0.1f * 48000.0f));
+    float envelope = state.range(0) == Signal
+                             ? 1.0f
+                             : std::numeric_limits<float>::denorm_min() * 1e6f;
+    for (auto _: state) {
+        for (size_t i = 0; i < blockSize; i++) {
+            envelope = release * envelope;
+            benchmark::DoNotOptimize(envelope);
+        }
+        if (state.range(0) == Signal && envelope < 1e-30f) {
+            envelope = 1.0f;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * blockSize);
+}
+BENCHMARK(BM_UnguardedDecay)->Arg(Signal)->Arg(Silence);
@@ -0,0 +1,40 @@
+/// HibernationBench.cpp
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "Compressor.h"
+#include "Hibernation.h"
+
+namespace {
+auto make_compressor() -> Compressor<float> {
+    return *Compressor<float>::create({.sampleRate = 48000,
+                                       .threshold = -20.0f,
+                                       .attack = std::chrono::milliseconds(5),
+                                       .release = std::chrono::milliseconds(50),
+                                       .ratio = 4.0f});
+}
+} // namespace
+
+/// A muted stream, processed in full
+static void BM_SilentBlock(benchmark::State &state) {
+    Compressor<float> compressor = make_compressor();
+    std::vector<float> samples(512, 0.0f);
+    for (auto _: state) {
+        compressor.process(samples.data(), samples.size());
+        benchmark::DoNotOptimize(samples.data());
+    }
+    state.SetItemsProcessed(state.iterations() * samples.size());
+}
+BENCHMARK(BM_SilentBlock);
+
+/// The same muted stream, hibernating
+static void BM_HibernatedBlock(benchmark::State &state) {
+    auto compressor = Hibernating<Compressor<float>>::create(make_compressor());
+    std::vector<float> samples(512, 0.0f);
+    for (auto _: state) {
+        compressor->process(samples.data(), samples.size());
+        benchmark::DoNotOptimize(samples.data());
+    }
+    state.SetItemsProcessed(state.iterations() * samples.size());
+}
+BENCHMARK(BM_HibernatedBlock);
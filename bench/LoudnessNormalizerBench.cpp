@@ -0,0 +1,63 @@
+/// LoudnessNormalizerBench.cpp
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "Compressor.h"
+#include "LoudnessNormalizer.h"
+
+namespace {
+constexpr size_t blockSize = 4096;
+
+auto make_signal() -> std::vector<float> {
+    std::vector<float> samples(blockSize);
+    for (size_t i = 0; i < blockSize; i++) {
+        samples[i] = static_cast<float>(0.05 + 0.9 * ((i * 37) % 101) / 101.0);
+    }
+    return samples;
+}
+} // namespace
+
+/// Baseline: a plain compressor over the same block
+static void BM_Compressor(benchmark::State &state) {
+    std::optional<Compressor<float>> compressor =
+            Compressor<float>::create(CompressorConfiguration<float>{
+                    .sampleRate = 48000,
+                    .threshold = -10.0f,
+                    .attack = std::chrono::milliseconds(10),
+                    .release = std::chrono::milliseconds(100),
+                    .ratio = 4.0f,
+                    .makeupGain = 1.0f});
+    const std::vector<float> input = make_signal();
+    std::vector<float> samples = input;
+    for (auto _: state) {
+        samples = input;
+        compressor->process(samples.data(), samples.size());
+        benchmark::DoNotOptimize(samples.data());
+    }
+    state.SetItemsProcessed(state.iterations() * blockSize);
+}
+BENCHMARK(BM_Compressor);
+
+static void BM_LoudnessNormalizer(benchmark::State &state) {
+    std::optional<LoudnessNormalizer<float, double>> normalizer =
+            LoudnessNormalizer<float, double>::create(
+                    LoudnessNormalizerConfiguration<float>{
+                            .sampleRate = 48000,
+                            .targetLoudness = -23.0f,
+                            .window = static_cast<LoudnessWindow>(
+                                    state.range(0)),
+                            .attack = std::chrono::milliseconds(100),
+                            .release = std::chrono::milliseconds(1000)});
+    const std::vector<float> input = make_signal();
+    std::vector<float> samples = input;
+    for (auto _: state) {
+        samples = input;
+        normalizer->process(samples.data(), samples.size());
+        benchmark::DoNotOptimize(samples.data());
+    }
+    state.SetItemsProcessed(state.iterations() * blockSize);
+}
+BENCHMARK(BM_LoudnessNormalizer)
+        ->Arg(static_cast<int>(LoudnessWindow::Momentary))
+        ->Arg(static_cast<int>(LoudnessWindow::ShortTerm))
+        ->Arg(static_cast<int>(LoudnessWindow::Integrated));
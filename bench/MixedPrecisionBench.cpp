@@ -0,0 +1,67 @@
+/// MixedPrecisionBench.cpp
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "Compressor.h"
+#include "NoiseGate.h"
+
+namespace {
+constexpr size_t blockSize = 4096;
+
+template<typename T>
+auto make_signal() -> std::vector<T> {
+    std::vector<T> samples(blockSize);
+    for (size_t i = 0; i < blockSize; i++) {
+        samples[i] = static_cast<T>(0.05 + 0.9 * ((i * 37) % 101) / 101.0);
+    }
+    return samples;
+}
+} // namespace
+
+template<typename T, typename S>
+static void BM_Compressor(benchmark::State &state) {
+    constexpr auto config = CompressorConfiguration<T>{
+            .sampleRate = 48000,
+            .threshold = static_cast<T>(-10),
+            .attack = std::chrono::milliseconds(10),
+            .release = std::chrono::milliseconds(100),
+            .ratio = static_cast<T>(4),
+            .makeupGain = static_cast<T>(1),
+            .kneeWidth = static_cast<T>(6)};
+    std::optional<Compressor<T, S>> compressor =
+            Compressor<T, S>::create(config);
+    const std::vector<T> input = make_signal<T>();
+    std::vector<T> samples = input;
+    for (auto _: state) {
+        samples = input;
+        compressor->process(samples.data(), samples.size());
+        benchmark::DoNotOptimize(samples.data());
+    }
+    state.SetItemsProcessed(state.iterations() * blockSize);
+    state.SetBytesProcessed(state.iterations() * blockSize * sizeof(T));
+}
+BENCHMARK(BM_Compressor<float, float>);
+BENCHMARK(BM_Compressor<float, double>);
+BENCHMARK(BM_Compressor<double, double>);
+
+template<typename T, typename S>
+static void BM_NoiseGate(benchmark::State &state) {
+    constexpr auto config = NoiseGateConfiguration<T>{
+            .sampleRate = 48000,
+            .threshold = static_cast<T>(-10),
+            .attack = std::chrono::milliseconds(10),
+            .release = std::chrono::milliseconds(100)};
+    std::optional<NoiseGate<T, S>> noiseGate = NoiseGate<T, S>::create(config);
+    const std::vector<T> input = make_signal<T>();
+    std::vector<T> samples = input;
+    for (auto _: state) {
+        samples = input;
+        noiseGate->process(samples.data(), samples.size());
+        benchmark::DoNotOptimize(samples.data());
+    }
+    state.SetItemsProcessed(state.iterations() * blockSize);
+    state.SetBytesProcessed(state.iterations() * blockSize * sizeof(T));
+}
+BENCHMARK(BM_NoiseGate<float, float>);
+BENCHMARK(BM_NoiseGate<float, double>);
+BENCHMARK(BM_NoiseGate<double, double>);
@@ -0,0 +1,39 @@
+/// QualityTierBench.cpp
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "Compressor.h"
+#include "QualityTier.h"
+
+namespace {
+auto make_signal(const size_t count) -> std::vector<float> {
+    std::vector<float> samples(count);
+    for (size_t i = 0; i < count; i++) {
+        samples[i] = 0.05f + 0.9f * static_cast<float>((i * 37) % 101) / 101.0f;
+    }
+    return samples;
+}
+} // namespace
+
+/// One 512-sample block per iteration at each tier
+static void BM_Tier(benchmark::State &state) {
+    const Compressor<float> compressor = *Compressor<float>::create(
+            {.sampleRate = 48000,
+             .threshold = -20.0f,
+             .attack = std::chrono::milliseconds(5),
+             .release = std::chrono::milliseconds(50),
+             .ratio = 4.0f,
+             .makeupGain = 1.0f,
+             .kneeWidth = 6.0f});
+    auto tiered = TieredProcessor<Compressor<float>>::create(compressor);
+    tiered->set_tier(static_cast<QualityTier>(state.range(0)));
+    const std::vector<float> input = make_signal(512);
+    std::vector<float> samples = input;
+    for (auto _: state) {
+        samples = input;
+        tiered->process(samples.data(), samples.size());
+        benchmark::DoNotOptimize(samples.data());
+    }
+    state.SetItemsProcessed(state.iterations() * samples.size());
+}
+BENCHMARK(BM_Tier)->ArgName("tier")->Arg(0)->Arg(1)->Arg(2);
@@ -0,0 +1,44 @@
+/// SpectralProcessorBench.cpp
+
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <vector>
+#include "Compressor.h"
+#include "SpectralProcessor.h"
+
+/// One channel at 48 kHz, 512-sample blocks, frame size from the argument and
+/// a hop of a quarter frame. Reports the latency and the fraction of real time
+/// the channel takes
+static void BM_SpectralChannel(benchmark::State &state) {
+    constexpr int sampleRate = 48000;
+    const Compressor<float> compressor = *Compressor<float>::create(
+            {.sampleRate = sampleRate,
+             .threshold = -30.0f,
+             .attack = std::chrono::milliseconds(5),
+             .release = std::chrono::milliseconds(50),
+             .ratio = 4.0f,
+             .makeupGain = 1.0f,
+             .kneeWidth = 6.0f});
+    const auto size = static_cast<size_t>(state.range(0));
+    auto spectral = SpectralProcessor<Compressor<float>>::create(
+            compressor, {.fftSize = size, .hopSize = size / 4});
+    std::vector<float> input(512);
+    for (size_t n = 0; n < input.size(); n++) {
+        input[n] = 0.5f * std::sin(0.13f * static_cast<float>(n));
+    }
+    std::vector<float> samples = input;
+    for (auto _: state) {
+        samples = input;
+        spectral->process(samples.data(), samples.size());
+        benchmark::DoNotOptimize(samples.data());
+    }
+    state.SetItemsProcessed(state.iterations() * samples.size());
+    state.counters["latency_ms"] =
+            1000.0 * static_cast<double>(spectral->latency()) / sampleRate;
+    /// Seconds of processing per second of audio:
+    state.counters["realtime"] = benchmark::Counter(
+            static_cast<double>(state.iterations() * samples.size()) /
+                    sampleRate,
+            benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+BENCHMARK(BM_SpectralChannel)->ArgName("fft")->Arg(256)->Arg(1024)->Arg(4096);
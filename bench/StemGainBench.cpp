@@ -0,0 +1,105 @@
+/// StemGainBench.cpp
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "Compressor.h"
+#include "StemGain.h"
+
+/// Driving N stems from one compressor analysis: running the compressor on
+/// every stem, against one compute_gain() plus apply_gain(). Then apply_gain()
+/// alone, tiled, against one full pass per stem over a buffer larger than L2.
+
+namespace {
+constexpr size_t frames = 4096;
+
+auto make_compressor() -> Compressor<float> {
+    return *Compressor<float>::create({.sampleRate = 48000,
+                                       .threshold = -20.0f,
+                                       .attack = std::chrono::milliseconds(1),
+                                       .release = std::chrono::milliseconds(50),
+                                       .ratio = 4.0f,
+                                       .makeupGain = 1.0f});
+}
+
+auto make_stems(const size_t count, const size_t length)
+        -> std::vector<std::vector<float>> {
+    std::vector<std::vector<float>> stems(count, std::vector<float>(length));
+    for (size_t k = 0; k < count; k++) {
+        for (size_t i = 0; i < length; i++) {
+            stems[k][i] = static_cast<float>(
+                    0.05 + 0.9 * (((i + k) * 37) % 101) / 101.0);
+        }
+    }
+    return stems;
+}
+
+auto pointers(std::vector<std::vector<float>> &stems) -> std::vector<float *> {
+    std::vector<float *> result;
+    for (std::vector<float> &stem: stems) {
+        result.push_back(stem.data());
+    }
+    return result;
+}
+} // namespace
+
+static void BM_ProcessEveryStem(benchmark::State &state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    std::vector<Compressor<float>> compressors(count, make_compressor());
+    std::vector<std::vector<float>> stems = make_stems(count, frames);
+    for (auto _: state) {
+        for (size_t k = 0; k < count; k++) {
+            compressors[k].process(stems[k].data(), frames);
+        }
+        benchmark::DoNotOptimize(stems.data());
+    }
+    state.SetItemsProcessed(state.iterations() * count * frames);
+}
+BENCHMARK(BM_ProcessEveryStem)->ArgName("stems")->Arg(4)->Arg(16);
+
+static void BM_ComputeGainOnce(benchmark::State &state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    Compressor<float> compressor = make_compressor();
+    std::vector<std::vector<float>> stems = make_stems(count, frames);
+    const std::vector<float *> stemPointers = pointers(stems);
+    const std::vector<float> mix = make_stems(1, frames)[0];
+    std::vector<float> gains(frames);
+    for (auto _: state) {
+        compressor.compute_gain(mix.data(), gains.data(), frames);
+        apply_gain(gains.data(), stemPointers.data(), count, frames);
+        benchmark::DoNotOptimize(stems.data());
+    }
+    state.SetItemsProcessed(state.iterations() * count * frames);
+}
+BENCHMARK(BM_ComputeGainOnce)->ArgName("stems")->Arg(4)->Arg(16);
+
+static void BM_ApplyGainTiled(benchmark::State &state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    constexpr size_t length = 1 << 16;
+    std::vector<std::vector<float>> stems = make_stems(count, length);
+    const std::vector<float *> stemPointers = pointers(stems);
+    const std::vector<float> gains(length, 0.999f);
+    for (auto _: state) {
+        apply_gain(gains.data(), stemPointers.data(), count, length);
+        benchmark::DoNotOptimize(stems.data());
+    }
+    state.SetItemsProcessed(state.iterations() * count * length);
+}
+BENCHMARK(BM_ApplyGainTiled)->ArgName("stems")->Arg(16)->Arg(64);
+
+static void BM_ApplyGainPerStem(benchmark::State &state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    constexpr size_t length = 1 << 16;
+    std::vector<std::vector<float>> stems = make_stems(count, length);
+    const std::vector<float> gains(length, 0.999f);
+    for (auto _: state) {
+        for (size_t k = 0; k < count; k++) {
+            float *stem = stems[k].data();
+            for (size_t i = 0; i < length; i++) {
+                stem[i] *= gains[i];
+            }
+        }
+        benchmark::DoNotOptimize(stems.data());
+    }
+    state.SetItemsProcessed(state.iterations() * count * length);
+}
+BENCHMARK(BM_ApplyGainPerStem)->ArgName("stems")->Arg(16)->Arg(64);
@@ -0,0 +1,61 @@
+/// TraceRecorderBench.cpp
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "Compressor.h"
+#include "TraceRecorder.h"
+
+/// Cost of tracing on the audio thread: a compressor processing 512-sample
+/// blocks, plain and traced. The ring is drained after every block into a
+/// file too small to keep anything, so only the audio thread side is timed.
+
+namespace {
+constexpr size_t frames = 512;
+
+constexpr auto config = CompressorConfiguration<float>{
+        .sampleRate = 48000,
+        .threshold = -20.0f,
+        .attack = std::chrono::milliseconds(1),
+        .release = std::chrono::milliseconds(50),
+        .ratio = 4.0f,
+        .makeupGain = 1.0f};
+
+auto make_input() -> std::vector<float> {
+    std::vector<float> input(frames);
+    for (size_t i = 0; i < input.size(); i++) {
+        input[i] = static_cast<float>(0.05 + 0.9 * ((i * 37) % 101) / 101.0);
+    }
+    return input;
+}
+} // namespace
+
+static void BM_Plain(benchmark::State &state) {
+    Compressor<float> compressor = *Compressor<float>::create(config);
+    const std::vector<float> input = make_input();
+    std::vector<float> samples = input;
+    for (auto _: state) {
+        samples = input;
+        compressor.process(samples.data(), samples.size());
+        benchmark::DoNotOptimize(samples.data());
+    }
+    state.SetItemsProcessed(state.iterations() * samples.size());
+}
+BENCHMARK(BM_Plain);
+
+static void BM_Traced(benchmark::State &state) {
+    std::optional<TraceRecorder> recorder = TraceRecorder::create(1 << 16);
+    std::optional<TraceFile> file = TraceFile::create("/tmp/bench.trace", 0);
+    auto traced = TracedProcessor<Compressor<float>>::create(config, *recorder);
+    const std::vector<float> input = make_input();
+    std::vector<float> samples = input;
+    for (auto _: state) {
+        samples = input;
+        traced->process(samples.data(), samples.size());
+        benchmark::DoNotOptimize(samples.data());
+        state.PauseTiming();
+        recorder->flush(*file);
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * samples.size());
+}
+BENCHMARK(BM_Traced);
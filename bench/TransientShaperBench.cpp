@@ -0,0 +1,85 @@
+/// TransientShaperBench.cpp
+
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <vector>
+#include "Compressor.h"
+#include "Expander.h"
+#include "TransientShaper.h"
+
+/// Transient shaping as a fast-attack compressor chained into an expander,
+/// two passes over the buffer, against one transient shaper pass. Then the
+/// multichannel shaper, unlinked and linked.
+
+namespace {
+constexpr size_t frames = 4096;
+
+auto make_samples(const size_t count) -> std::vector<float> {
+    std::vector<float> samples(count);
+    for (size_t i = 0; i < count; i++) {
+        samples[i] = std::sin(0.03f * static_cast<float>(i)) *
+                     std::exp(-0.002f * static_cast<float>(i % 4000));
+    }
+    return samples;
+}
+
+auto make_config(const size_t channels, const bool linked)
+        -> TransientShaperConfiguration<float> {
+    return {.sampleRate = 48000,
+            .attackGain = 6.0f,
+            .sustainGain = -3.0f,
+            .channels = channels,
+            .linked = linked};
+}
+} // namespace
+
+static void BM_CompressorExpanderChain(benchmark::State &state) {
+    auto compressor = *Compressor<float>::create(
+            {.sampleRate = 48000,
+             .threshold = -20.0f,
+             .attack = std::chrono::milliseconds(1),
+             .release = std::chrono::milliseconds(20),
+             .ratio = 4.0f,
+             .makeupGain = 0.0f});
+    auto expander = *Expander<float>::create(
+            {.sampleRate = 48000,
+             .threshold = -30.0f,
+             .attack = std::chrono::milliseconds(20),
+             .release = std::chrono::milliseconds(200),
+             .ratio = 2.0f,
+             .makeupGain = 0.0f});
+    std::vector<float> samples = make_samples(frames);
+    for (auto _: state) {
+        compressor.process(samples.data(), frames);
+        expander.process(samples.data(), frames);
+        benchmark::DoNotOptimize(samples.data());
+    }
+    state.SetItemsProcessed(state.iterations() * frames);
+}
+BENCHMARK(BM_CompressorExpanderChain);
+
+static void BM_TransientShaper(benchmark::State &state) {
+    auto shaper = TransientShaper<float>::create(make_config(1, false));
+    std::vector<float> samples = make_samples(frames);
+    for (auto _: state) {
+        shaper->process(samples.data(), frames);
+        benchmark::DoNotOptimize(samples.data());
+    }
+    state.SetItemsProcessed(state.iterations() * frames);
+}
+BENCHMARK(BM_TransientShaper);
+
+static void BM_TransientShaperInterleaved(benchmark::State &state) {
+    const auto channels = static_cast<size_t>(state.range(0));
+    const bool linked = state.range(1) != 0;
+    auto shaper = TransientShaper<float>::create(make_config(channels, linked));
+    std::vector<float> samples = make_samples(channels * frames);
+    for (auto _: state) {
+        shaper->process(samples.data(), samples.size());
+        benchmark::DoNotOptimize(samples.data());
+    }
+    state.SetItemsProcessed(state.iterations() * channels * frames);
+}
+BENCHMARK(BM_TransientShaperInterleaved)
+        ->ArgNames({"channels", "linked"})
+        ->ArgsProduct({{2, 8}, {0, 1}});
@@ -0,0 +1,124 @@
+/// Analysis.h
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ANALYSIS_H
+#define ANALYSIS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+#include "Denormal.h"
+
+/**
+ * @brief Steady-state transfer curves of many processors at once, for
+ * drawing or tuning
+ * @details Evaluates the level each processor settles at for every input
+ * level, `input + (staticCharacteristic - input) * makeupGain`, which is what
+ * process() converges to on a constant input. The processors are only read.
+ * @tparam P Type of the processors, Limiter, Compressor or Expander
+ * @param processors Processors
+ * @param inputDecibels Input levels in decibels, shared by every processor
+ * @param output Output levels in decibels, one row of `inputDecibels.size()`
+ * values per processor
+ */
+template<typename P>
+auto transfer_curves(std::span<const P> processors,
+                     std::span<const typename P::sample_type> inputDecibels,
+                     std::span<typename P::sample_type> output) -> void {
+    using T = typename P::sample_type;
+    const size_t count = inputDecibels.size();
+    if (output.size() < processors.size() * count) {
+        return;
+    }
+    for (size_t k = 0; k < processors.size(); k++) {
+        const std::span<T> row = output.subspan(k * count, count);
+        processors[k].static_characteristic(inputDecibels, row);
+        const T makeupGain = processors[k].makeup_gain();
+        for (size_t i = 0; i < count; i++) {
+            row[i] = inputDecibels[i] +
+                     (row[i] - inputDecibels[i]) * makeupGain;
+        }
+    }
+}
+
+/**
+ * @brief Gain smoothing step responses of many processors at once, for
+ * drawing or tuning attack and release
+ * @details Each processor starts settled at `fromDecibels` and sees the input
+ * jump to `toDecibels` on the first sample. The result is the smoothed gain in
+ * decibels, before makeup gain, for every sample, which is what process()
+ * computes for the same input. The processors are only read.
+ *
+ * The input level is constant after the step, so the target gain is too and
+ * the smoothed gain moves monotonically towards it. Each processor therefore
+ * uses one smoothing coefficient for the whole response, and every time step
+ * is a single element-wise loop across processors, which vectorizes. The
+ * output is time-major so those stores are contiguous; use
+ * `StridedView{output.data() + k, length,
+ * static_cast<std::ptrdiff_t>(processors.size())}` for the response of
+ * processor k.
+ * @tparam P Type of the processors, Limiter, Compressor or Expander
+ * @param processors Processors
+ * @param fromDecibels Input level before the step, in decibels
+ * @param toDecibels Input level after the step, in decibels
+ * @param length Number of samples to simulate
+ * @param output Smoothed gains in decibels, `length * processors.size()`
+ * values, sample n of processor k at `n * processors.size() + k`
+ * @param resource Memory resource for the per-processor scratch state
+ */
+template<typename P>
+auto step_responses(std::span<const P> processors,
+                    const typename P::sample_type fromDecibels,
+                    const typename P::sample_type toDecibels,
+                    const size_t length,
+                    std::span<typename P::state_type> output,
+                    std::pmr::memory_resource *resource =
+                            std::pmr::get_default_resource()) -> void {
+    using S = typename P::state_type;
+    const size_t count = processors.size();
+    if (output.size() < count * length) {
+        return;
+    }
+    std::pmr::vector<S> state(count, resource);
+    std::pmr::vector<S> target(count, resource);
+    std::pmr::vector<S> alpha(count, resource);
+    for (size_t k = 0; k < count; k++) {
+        state[k] = static_cast<S>(processors[k].target_gain(fromDecibels));
+        target[k] = static_cast<S>(processors[k].target_gain(toDecibels));
+        alpha[k] = processors[k].smoothing_coefficient(state[k], target[k]);
+    }
+    for (size_t n = 0; n < length; n++) {
+        S *row = output.data() + n * count;
+        for (size_t k = 0; k < count; k++) {
+            state[k] = flush_denormal<S>(alpha[k] * state[k] +
+                                         (1.0 - alpha[k]) * target[k]);
+            row[k] = state[k];
+        }
+    }
+}
+
+#endif // ANALYSIS_H
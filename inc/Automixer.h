@@ -0,0 +1,320 @@
+/// Automixer.h
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef AUTOMIXER_H
+#define AUTOMIXER_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "Denormal.h"
+#include "NoiseGate.h"
+
+/**
+ * @brief Automixer configuration
+ * @tparam T Type of the automixer
+ */
+template<typename T = double>
+struct AutomixerConfiguration {
+    /** Sample rate */
+    int sampleRate = 0;
+
+    /** Number of microphones */
+    size_t channels = 0;
+
+    /** Attack time of the level detectors in milliseconds */
+    std::chrono::milliseconds attack = std::chrono::milliseconds(0);
+
+    /** Release time of the level detectors in milliseconds */
+    std::chrono::milliseconds release = std::chrono::milliseconds(0);
+
+    /** Total level in decibels below which nobody is considered talking */
+    T holdThreshold = static_cast<T>(-60);
+
+    /** Whether to keep the last gains while nobody is talking, so the last
+     * talker's microphone stays open, instead of sharing the gain equally */
+    bool lastMicHold = true;
+
+    /** Samples between gain updates, with the gains ramped linearly in
+     * between. 1 updates the gains every sample */
+    size_t controlInterval = 32;
+};
+
+/**
+ * @brief Automixer class. Implements Dugan-style gain sharing across many
+ * microphones.
+ * @details Every microphone has a peak envelope follower with the attack and
+ * release coefficients of a NoiseGate. Each microphone's gain is its share of
+ * the total envelope, `env[c] / sum(env)`, so the gains always add up to one:
+ * a single talker passes at unity while the other microphones are pulled
+ * down, and two equal talkers each get -6 dB, keeping the sum of open
+ * microphones constant. While the total falls below the hold threshold
+ * nobody is talking, and the gains either hold, which keeps the last talker's
+ * microphone open, or relax to an equal share.
+ *
+ * The detectors and gain ramps run across channels for every frame, so with
+ * interleaved input those loops are element-wise over contiguous samples and
+ * vectorize; planar input is gathered one control interval at a time. Gains
+ * are updated once per control interval and ramped linearly across it, and
+ * the cost per sample is linear in the number of microphones.
+ * @tparam T Type of the automixer input and output samples
+ * @tparam S Type of the envelope and gain state and coefficients
+ */
+template<typename T = double, typename S = T>
+class Automixer {
+public:
+    /** Type of the input and output samples */
+    using sample_type = T;
+
+    /** Type of the envelope and gain state and coefficients */
+    using state_type = S;
+
+    /**
+     * @brief Public constructor that verifies the configuration and creates an
+     * automixer object
+     * @param configuration Automixer configuration
+     * @param resource Memory resource for the per-channel state
+     * @return An Automixer object if the configuration is valid, std::nullopt
+     * otherwise
+     */
+    auto static create(AutomixerConfiguration<T> configuration,
+                       std::pmr::memory_resource *resource =
+                               std::pmr::get_default_resource())
+            -> std::optional<Automixer> {
+        if (configuration.channels == 0 ||
+            configuration.controlInterval == 0 || resource == nullptr) {
+            return std::nullopt;
+        }
+        std::optional<NoiseGate<T, S>> detector = NoiseGate<T, S>::create(
+                {.sampleRate = configuration.sampleRate,
+                 .attack = configuration.attack,
+                 .release = configuration.release});
+        if (!detector.has_value()) {
+            return std::nullopt;
+        }
+        return Automixer(configuration, *detector, resource);
+    }
+
+    /**
+     * @brief Processes interleaved frames in-place
+     * @param samples Pointer to the samples
+     * @param count Number of samples, a multiple of the channel count
+     */
+    auto process(T *samples, const size_t count) -> void {
+        DenormalGuard guard;
+        const size_t channels = m_config.channels;
+        const size_t frames = count / channels;
+        const size_t interval = m_config.controlInterval;
+        for (size_t i = 0; i < frames; i += interval) {
+            const size_t length = std::min(interval, frames - i);
+            process_interval(samples + i * channels, length);
+        }
+    }
+
+    /**
+     * @brief Processes a contiguous span of interleaved frames in-place
+     * @param samples Span of samples
+     */
+    auto process(std::span<T> samples) -> void {
+        process(samples.data(), samples.size());
+    }
+
+    /**
+     * @brief Processes planar channels in-place
+     * @param channels One pointer per channel
+     * @param frames Number of samples in each channel
+     */
+    auto process(T *const *channels, const size_t frames) -> void {
+        DenormalGuard guard;
+        const size_t count = m_config.channels;
+        const size_t interval = m_config.controlInterval;
+        for (size_t i = 0; i < frames; i += interval) {
+            const size_t length = std::min(interval, frames - i);
+            for (size_t c = 0; c < count; c++) {
+                const T *channel = channels[c] + i;
+                for (size_t n = 0; n < length; n++) {
+                    m_tile[n * count + c] = channel[n];
+                }
+            }
+            process_interval(m_tile.data(), length);
+            for (size_t c = 0; c < count; c++) {
+                T *channel = channels[c] + i;
+                for (size_t n = 0; n < length; n++) {
+                    channel[n] = m_tile[n * count + c];
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Resets the automixer to silence with equal gains
+     */
+    auto reset() -> void {
+        const S share = static_cast<S>(1) / static_cast<S>(m_config.channels);
+        std::fill(m_envelope.begin(), m_envelope.end(), static_cast<S>(0));
+        std::fill(m_gain.begin(), m_gain.end(), share);
+        std::fill(m_target.begin(), m_target.end(), share);
+    }
+
+    /**
+     * @brief Current gain of a channel
+     * @param channel Channel index
+     * @return The linear gain
+     */
+    [[nodiscard]] auto gain(const size_t channel) const -> S {
+        return m_gain[channel];
+    }
+
+    /**
+     * @brief Current envelope of a channel
+     * @param channel Channel index
+     * @return The linear level
+     */
+    [[nodiscard]] auto envelope(const size_t channel) const -> S {
+        return m_envelope[channel];
+    }
+
+    /**
+     * @brief Number of channels
+     * @return The number of microphones
+     */
+    [[nodiscard]] auto channels() const -> size_t { return m_config.channels; }
+
+private:
+    /**
+     * @brief Private constructor
+     * @param configuration Automixer configuration
+     * @param detector Noise gate providing the detector coefficients
+     * @param resource Memory resource for the per-channel state
+     */
+    Automixer(AutomixerConfiguration<T> configuration,
+              const NoiseGate<T, S> &detector,
+              std::pmr::memory_resource *resource) :
+        m_config(configuration),
+        m_attackValue(detector.attack_coefficient()),
+        m_releaseValue(detector.release_coefficient()),
+        m_holdLevel(static_cast<S>(
+                std::pow(10.0, configuration.holdThreshold / 20.0))),
+        m_envelope(configuration.channels, resource),
+        m_gain(configuration.channels, resource),
+        m_target(configuration.channels, resource),
+        m_step(configuration.channels, resource),
+        m_tile(configuration.channels * configuration.controlInterval,
+               resource) {
+        reset();
+    }
+
+    /**
+     * @brief Detect, update the gain targets and apply the gain ramps over one
+     * control interval of interleaved frames
+     * @param frames Pointer to the first sample of the interval
+     * @param length Number of frames in the interval
+     */
+    auto process_interval(T *frames, const size_t length) -> void {
+        const size_t channels = m_config.channels;
+        S *envelope = m_envelope.data();
+        const S attack = m_attackValue;
+        const S release = m_releaseValue;
+        constexpr S ceiling = static_cast<S>(1e10);
+        /// Peak followers, element-wise across channels. A NaN reads as
+        /// silence and infinities are clamped, so the envelopes stay finite:
+        for (size_t n = 0; n < length; n++) {
+            const T *frame = frames + n * channels;
+            for (size_t c = 0; c < channels; c++) {
+                S level = static_cast<S>(std::fabs(frame[c]));
+                level = level >= static_cast<S>(0) ? std::min(level, ceiling)
+                                                   : static_cast<S>(0);
+                const S coefficient = level > envelope[c] ? attack : release;
+                envelope[c] = flush_denormal(
+                        coefficient * (envelope[c] - level) + level);
+            }
+        }
+
+        /// Gain sharing:
+        S total = static_cast<S>(0);
+        for (size_t c = 0; c < channels; c++) {
+            total += envelope[c];
+        }
+        if (total > m_holdLevel) {
+            const S scale = static_cast<S>(1) / total;
+            for (size_t c = 0; c < channels; c++) {
+                m_target[c] = envelope[c] * scale;
+            }
+        } else if (!m_config.lastMicHold) {
+            std::fill(m_target.begin(), m_target.end(),
+                      static_cast<S>(1) / static_cast<S>(channels));
+        }
+
+        /// Linear ramps to the new gains, element-wise across channels:
+        S *gain = m_gain.data();
+        S *step = m_step.data();
+        const S inverse = static_cast<S>(1) / static_cast<S>(length);
+        for (size_t c = 0; c < channels; c++) {
+            step[c] = (m_target[c] - gain[c]) * inverse;
+        }
+        for (size_t n = 0; n < length; n++) {
+            T *frame = frames + n * channels;
+            for (size_t c = 0; c < channels; c++) {
+                gain[c] += step[c];
+                frame[c] *= static_cast<T>(gain[c]);
+            }
+        }
+        std::copy(m_target.begin(), m_target.end(), m_gain.begin());
+    }
+
+    /** Automixer configuration */
+    AutomixerConfiguration<T> m_config;
+
+    /** Detector attack coefficient */
+    S m_attackValue;
+
+    /** Detector release coefficient */
+    S m_releaseValue;
+
+    /** Linear total level below which the gains hold */
+    S m_holdLevel;
+
+    /** Envelope, one per channel */
+    std::pmr::vector<S> m_envelope;
+
+    /** Current gain, one per channel */
+    std::pmr::vector<S> m_gain;
+
+    /** Gain at the end of the current interval, one per channel */
+    std::pmr::vector<S> m_target;
+
+    /** Gain increment per frame over the current interval, one per channel */
+    std::pmr::vector<S> m_step;
+
+    /** Interleaved copy of one control interval of planar input */
+    std::pmr::vector<T> m_tile;
+};
+
+#endif // AUTOMIXER_H
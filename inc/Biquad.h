@@ -0,0 +1,270 @@
+/// Biquad.h
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef BIQUAD_H
+#define BIQUAD_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <memory_resource>
+#include <numbers>
+#include <vector>
+
+#include "Denormal.h"
+
+/**
+ * @brief Normalized biquad coefficients (a0 = 1)
+ * @tparam S Type of the coefficients
+ */
+template<typename S = double>
+struct BiquadCoefficients {
+    S b0 = static_cast<S>(1);
+    S b1 = static_cast<S>(0);
+    S b2 = static_cast<S>(0);
+    S a1 = static_cast<S>(0);
+    S a2 = static_cast<S>(0);
+};
+
+/**
+ * @brief Biquad filter in transposed direct form II
+ * @details Used on detector paths, where it runs once per sample ahead of the
+ * level detector. The filter keeps two state values, flushed to zero when they
+ * decay into the subnormal range, and never allocates. A NaN or an infinity
+ * would stay in the state, so inputs go through finite_sample() first.
+ * @tparam S Type of the filter state and coefficients
+ */
+template<typename S = double>
+class Biquad {
+public:
+    Biquad() = default;
+
+    /**
+     * @brief Constructor
+     * @param coefficients Filter coefficients
+     */
+    explicit Biquad(BiquadCoefficients<S> coefficients) :
+        m_coefficients(coefficients) {}
+
+    /**
+     * @brief Filter a single sample
+     * @param input Sample to filter
+     * @return The filtered sample
+     */
+    auto process(const S input) -> S {
+        const S output = m_coefficients.b0 * input + m_z1;
+        m_z1 = flush_denormal(m_coefficients.b1 * input -
+                              m_coefficients.a1 * output + m_z2);
+        m_z2 = flush_denormal(m_coefficients.b2 * input -
+                              m_coefficients.a2 * output);
+        return output;
+    }
+
+    /**
+     * @brief Resets the filter state
+     */
+    auto reset() -> void {
+        m_z1 = static_cast<S>(0);
+        m_z2 = static_cast<S>(0);
+    }
+
+    /**
+     * @brief Set the filter coefficients, keeping the filter state
+     * @param coefficients Filter coefficients
+     */
+    auto set_coefficients(BiquadCoefficients<S> coefficients) -> void {
+        m_coefficients = coefficients;
+    }
+
+private:
+    /** Filter coefficients */
+    BiquadCoefficients<S> m_coefficients;
+
+    S m_z1 = static_cast<S>(0);
+    S m_z2 = static_cast<S>(0);
+};
+
+/**
+ * @brief Bank of identical biquads in transposed direct form II, one per
+ * channel
+ * @details The state is stored as one array per state variable rather than one
+ * filter per channel, so a step over all channels is a set of independent
+ * element-wise loops the compiler vectorizes across channels.
+ * @tparam S Type of the filter state and coefficients
+ */
+template<typename S = double>
+class BiquadBank {
+public:
+    /**
+     * @brief Constructor
+     * @param coefficients Filter coefficients, shared by every channel
+     * @param channels Number of channels
+     * @param resource Memory resource for the state
+     */
+    BiquadBank(BiquadCoefficients<S> coefficients, const size_t channels,
+               std::pmr::memory_resource *resource =
+                       std::pmr::get_default_resource()) :
+        m_coefficients(coefficients), m_z1(channels, resource),
+        m_z2(channels, resource) {}
+
+    /**
+     * @brief Filter one sample of every channel
+     * @param input One sample per channel
+     * @param output One filtered sample per channel, may alias input
+     */
+    auto process(const S *input, S *output) -> void {
+        const BiquadCoefficients<S> c = m_coefficients;
+        S *z1 = m_z1.data();
+        S *z2 = m_z2.data();
+        const size_t channels = m_z1.size();
+        for (size_t i = 0; i < channels; i++) {
+            const S x = input[i];
+            const S y = c.b0 * x + z1[i];
+            z1[i] = flush_denormal(c.b1 * x - c.a1 * y + z2[i]);
+            z2[i] = flush_denormal(c.b2 * x - c.a2 * y);
+            output[i] = y;
+        }
+    }
+
+    /**
+     * @brief Resets the state of every channel
+     */
+    auto reset() -> void {
+        std::fill(m_z1.begin(), m_z1.end(), static_cast<S>(0));
+        std::fill(m_z2.begin(), m_z2.end(), static_cast<S>(0));
+    }
+
+    /**
+     * @brief Number of channels
+     * @return The number of channels
+     */
+    [[nodiscard]] auto channels() const -> size_t { return m_z1.size(); }
+
+private:
+    /** Filter coefficients */
+    BiquadCoefficients<S> m_coefficients;
+
+    /** First state variable of every channel */
+    std::pmr::vector<S> m_z1;
+
+    /** Second state variable of every channel */
+    std::pmr::vector<S> m_z2;
+};
+
+/**
+ * @brief Design the first stage of the ITU-R BS.1770 K-weighting filter, a
+ * high shelf modelling the acoustic effect of the head
+ * @tparam S Type of the coefficients
+ * @param sampleRate Sample rate in Hz
+ * @return The filter coefficients
+ */
+template<typename S = double>
+auto k_weighting_shelf(const int sampleRate) -> BiquadCoefficients<S> {
+    const double f0 = 1681.974450955533;
+    const double gain = 3.999843853973347;
+    const double q = 0.7071752369554196;
+    const double k = std::tan(std::numbers::pi * f0 / sampleRate);
+    const double vh = std::pow(10.0, gain / 20.0);
+    const double vb = std::pow(vh, 0.4996667741545416);
+    const double a0 = 1.0 + k / q + k * k;
+    return BiquadCoefficients<S>{
+            .b0 = static_cast<S>((vh + vb * k / q + k * k) / a0),
+            .b1 = static_cast<S>(2.0 * (k * k - vh) / a0),
+            .b2 = static_cast<S>((vh - vb * k / q + k * k) / a0),
+            .a1 = static_cast<S>(2.0 * (k * k - 1.0) / a0),
+            .a2 = static_cast<S>((1.0 - k / q + k * k) / a0)};
+}
+
+/**
+ * @brief Design the second stage of the ITU-R BS.1770 K-weighting filter, the
+ * revised low-frequency B-curve high pass
+ * @tparam S Type of the coefficients
+ * @param sampleRate Sample rate in Hz
+ * @return The filter coefficients
+ */
+template<typename S = double>
+auto k_weighting_highpass(const int sampleRate) -> BiquadCoefficients<S> {
+    const double f0 = 38.13547087602444;
+    const double q = 0.5003270373238773;
+    const double k = std::tan(std::numbers::pi * f0 / sampleRate);
+    const double a0 = 1.0 + k / q + k * k;
+    return BiquadCoefficients<S>{.b0 = static_cast<S>(1.0),
+                                 .b1 = static_cast<S>(-2.0),
+                                 .b2 = static_cast<S>(1.0),
+                                 .a1 = static_cast<S>(2.0 * (k * k - 1.0) / a0),
+                                 .a2 = static_cast<S>((1.0 - k / q + k * k) /
+                                                      a0)};
+}
+
+/**
+ * @brief Design a constant 0 dB peak gain band pass (RBJ cookbook)
+ * @tparam S Type of the coefficients
+ * @param sampleRate Sample rate in Hz
+ * @param frequency Centre frequency in Hz
+ * @param q Quality factor
+ * @return The filter coefficients
+ */
+template<typename S = double>
+auto band_pass(const int sampleRate, const double frequency, const double q)
+        -> BiquadCoefficients<S> {
+    const double w0 = 2.0 * std::numbers::pi * frequency / sampleRate;
+    const double alpha = std::sin(w0) / (2.0 * q);
+    const double a0 = 1.0 + alpha;
+    return BiquadCoefficients<S>{.b0 = static_cast<S>(alpha / a0),
+                                 .b1 = static_cast<S>(0.0),
+                                 .b2 = static_cast<S>(-alpha / a0),
+                                 .a1 = static_cast<S>(-2.0 * std::cos(w0) / a0),
+                                 .a2 = static_cast<S>((1.0 - alpha) / a0)};
+}
+
+/**
+ * @brief Design a high shelf (RBJ cookbook)
+ * @tparam S Type of the coefficients
+ * @param sampleRate Sample rate in Hz
+ * @param frequency Shelf midpoint frequency in Hz
+ * @param q Quality factor
+ * @param gain Shelf gain in decibels
+ * @return The filter coefficients
+ */
+template<typename S = double>
+auto high_shelf(const int sampleRate, const double frequency, const double q,
+                const double gain) -> BiquadCoefficients<S> {
+    const double a = std::pow(10.0, gain / 40.0);
+    const double w0 = 2.0 * std::numbers::pi * frequency / sampleRate;
+    const double cosW0 = std::cos(w0);
+    const double alpha = std::sin(w0) / (2.0 * q);
+    const double root = 2.0 * std::sqrt(a) * alpha;
+    const double a0 = (a + 1.0) - (a - 1.0) * cosW0 + root;
+    return BiquadCoefficients<S>{
+            .b0 = static_cast<S>(a * ((a + 1.0) + (a - 1.0) * cosW0 + root) /
+                                 a0),
+            .b1 = static_cast<S>(-2.0 * a * ((a - 1.0) + (a + 1.0) * cosW0) /
+                                 a0),
+            .b2 = static_cast<S>(a * ((a + 1.0) + (a - 1.0) * cosW0 - root) /
+                                 a0),
+            .a1 = static_cast<S>(2.0 * ((a - 1.0) - (a + 1.0) * cosW0) / a0),
+            .a2 = static_cast<S>(((a + 1.0) - (a - 1.0) * cosW0 - root) / a0)};
+}
+
+#endif // BIQUAD_H
@@ -0,0 +1,230 @@
+/// BlockAdapter.h
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef BLOCK_ADAPTER_H
+#define BLOCK_ADAPTER_H
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Block adapter configuration
+ */
+struct BlockAdapterConfiguration {
+    /** Size of the sub-blocks the processor sees, a power of two */
+    size_t blockSize = 64;
+
+    /** Whether to process in place without delay. Sub-blocks are then aligned
+     * to the stream but not to memory, and the first and last of every call
+     * may be shorter */
+    bool zeroLatency = false;
+};
+
+/**
+ * @brief Block adapter class. Re-chunks host buffers of any size into
+ * power-of-two sub-blocks for a processor.
+ * @details In the default mode the adapter is a FIFO of one block: every call
+ * copies its samples into a 64-byte aligned input block and takes the same
+ * number of samples out of the previously processed block, and the processor
+ * runs whenever the input block is full. The processor therefore only ever
+ * sees full, aligned blocks of `blockSize` samples, and the output is delayed
+ * by `blockSize` samples. A call costs one copy loop per block boundary it
+ * crosses, whatever its size.
+ *
+ * In zero-latency mode the samples are processed in place, split at every
+ * multiple of `blockSize` counted from the start of the stream. Every
+ * sub-block but the first and last of a call is full, and block-rate or
+ * control-rate logic in the processor stays on the same grid whatever the
+ * host block sizes are.
+ *
+ * Either way the processor's state carries over between sub-blocks and calls.
+ * @tparam P Type of the processor, anything with a block process() and reset(),
+ * e.g. a TieredProcessor or a Hibernating processor
+ */
+template<typename P>
+class BlockAdapter {
+public:
+    using T = typename P::sample_type;
+
+    /**
+     * @brief Public constructor that verifies the configuration and creates a
+     * block adapter object
+     * @param processor Processor to feed
+     * @param configuration Block adapter configuration
+     * @param resource Memory resource for the blocks
+     * @return A BlockAdapter object if the configuration is valid,
+     * std::nullopt otherwise
+     */
+    auto static create(P processor, BlockAdapterConfiguration configuration,
+                       std::pmr::memory_resource *resource =
+                               std::pmr::get_default_resource())
+            -> std::optional<BlockAdapter> {
+        if (!std::has_single_bit(configuration.blockSize) ||
+            resource == nullptr) {
+            return std::nullopt;
+        }
+        return BlockAdapter(std::move(processor), configuration, resource);
+    }
+
+    BlockAdapter(BlockAdapter &&) noexcept = default;
+    BlockAdapter(const BlockAdapter &) = delete;
+    auto operator=(const BlockAdapter &) -> BlockAdapter & = delete;
+    auto operator=(BlockAdapter &&) -> BlockAdapter & = delete;
+
+    /**
+     * @brief Processes an array of samples in-place
+     * @param samples Pointer to the samples
+     * @param count Number of samples
+     */
+    auto process(T *samples, size_t count) -> void {
+        const size_t blockSize = m_config.blockSize;
+        if (m_config.zeroLatency) {
+            while (count > 0) {
+                const size_t length = std::min(blockSize - m_fill, count);
+                m_processor.process(samples, length);
+                m_fill = (m_fill + length) & (blockSize - 1);
+                samples += length;
+                count -= length;
+            }
+            return;
+        }
+        T *input = m_storage.data() + m_input;
+        T *output = m_storage.data() + m_output;
+        while (count > 0) {
+            const size_t length = std::min(blockSize - m_fill, count);
+            /// One pass swapping the host samples with the delayed ones,
+            /// inlined rather than two memcpy calls for the tiny host blocks:
+            T *in = input + m_fill;
+            const T *out = output + m_fill;
+            for (size_t i = 0; i < length; i++) {
+                in[i] = samples[i];
+                samples[i] = out[i];
+            }
+            m_fill += length;
+            samples += length;
+            count -= length;
+            if (m_fill == blockSize) {
+                m_processor.process(input, blockSize);
+                std::swap(input, output);
+                std::swap(m_input, m_output);
+                m_fill = 0;
+            }
+        }
+    }
+
+    /**
+     * @brief Processes a contiguous span of samples in-place
+     * @param samples Span of samples
+     */
+    auto process(std::span<T> samples) -> void {
+        process(samples.data(), samples.size());
+    }
+
+    /**
+     * @brief Resets the processor and empties the blocks
+     */
+    auto reset() -> void {
+        m_processor.reset();
+        std::fill(m_storage.begin(), m_storage.end(), static_cast<T>(0));
+        m_fill = 0;
+    }
+
+    /**
+     * @brief Delay the adapter adds
+     * @return The latency in samples, 0 in zero-latency mode
+     */
+    [[nodiscard]] auto latency() const -> size_t {
+        return m_config.zeroLatency ? 0 : m_config.blockSize;
+    }
+
+    /**
+     * @brief The processor fed by the adapter
+     * @return The processor
+     */
+    [[nodiscard]] auto processor() -> P & { return m_processor; }
+
+    /**
+     * @brief The processor fed by the adapter
+     * @return The processor, read-only
+     */
+    [[nodiscard]] auto processor() const -> const P & { return m_processor; }
+
+private:
+    /** Alignment of the blocks in bytes */
+    static constexpr size_t blockAlignment = 64;
+
+    /**
+     * @brief Private constructor
+     * @param processor Processor to feed
+     * @param configuration Block adapter configuration
+     * @param resource Memory resource for the blocks
+     */
+    BlockAdapter(P processor, const BlockAdapterConfiguration configuration,
+                 std::pmr::memory_resource *resource) :
+        m_processor(std::move(processor)), m_config(configuration),
+        m_storage(resource) {
+        if (m_config.zeroLatency) {
+            return;
+        }
+        /// Two blocks, each starting on an alignment boundary:
+        const size_t block = m_config.blockSize * sizeof(T);
+        const size_t stride =
+                (block + blockAlignment - 1) / blockAlignment * blockAlignment;
+        m_storage.resize((stride + stride + blockAlignment) / sizeof(T) + 1);
+        void *start = m_storage.data();
+        size_t space = m_storage.size() * sizeof(T);
+        std::align(blockAlignment, block, start, space);
+        m_input = static_cast<size_t>(static_cast<T *>(start) -
+                                      m_storage.data());
+        m_output = m_input + stride / sizeof(T);
+    }
+
+    /** Processor fed by the adapter */
+    P m_processor;
+
+    /** Block adapter configuration */
+    BlockAdapterConfiguration m_config;
+
+    /** Input and output blocks, empty in zero-latency mode */
+    std::pmr::vector<T> m_storage;
+
+    /** Offset of the input block in m_storage */
+    size_t m_input = 0;
+
+    /** Offset of the output block in m_storage */
+    size_t m_output = 0;
+
+    /** Samples in the input block, or position in the block grid in
+     * zero-latency mode */
+    size_t m_fill = 0;
+};
+
+#endif // BLOCK_ADAPTER_H
@@ -25,7 +25,16 @@ SOFTWARE.
 #ifndef COMPRESSOR_H
 #define COMPRESSOR_H
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <optional>
+#include <span>
+
+#include "Denormal.h"
+#include "Hibernation.h"
+#include "ParameterEvent.h"
+#include "SampleView.h"
 
 /**
  * @brief Compressor configuration
@@ -67,11 +76,20 @@ struct CompressorConfiguration {
  * parameter determines the width of the knee of the compressor's characteristic
  * curve. A larger knee width results in a smoother transition between the
  * compressed and uncompressed regions of the characteristic curve.
- * @tparam T Type of the compressor
+ * @tparam T Type of the compressor input and output samples
+ * @tparam S Type of the compressor gain smoothing state and coefficients. Use
+ * `Compressor<float, double>` to keep float I/O and full-width SIMD gain
+ * application while running the smoothing recursion in double precision
  */
-template<typename T = double>
+template<typename T = double, typename S = T>
 class Compressor {
 public:
+    /** Type of the input and output samples */
+    using sample_type = T;
+
+    /** Type of the gain smoothing state and coefficients */
+    using state_type = S;
+
     /**
      * @brief Public constructor that verifies the configuration and creates a
      * compressor object
@@ -94,15 +112,7 @@ public:
      * @brief Process a sample in-place
      * @param sample Sample to process
      */
-    auto process(T &sample) -> void {
-        T inputDecibels = 20.0 * std::log10(sample);
-        T xSc = calculate_static_characteristic(inputDecibels);
-        update_gain_smoothing(xSc, inputDecibels);
-        T gM = m_gainSmoothing * m_config.makeupGain.value();
-        T gLin = std::pow(10.0, gM / 20.0);
-
-        sample *= gLin;
-    }
+    auto process(T &sample) -> void { sample *= next_gain(sample); }
 
     /**
      * @brief Processes an array of samples in-place
@@ -110,11 +120,98 @@ public:
      * @param count Number of samples
      */
     auto process(T *samples, const size_t count) -> void {
-        for (int i = 0; i < count; i++) {
+        DenormalGuard guard;
+        for (size_t i = 0; i < count; i++) {
+            process(samples[i]);
+        }
+    }
+
+    /**
+     * @brief Computes the linear gain of every sample without modifying the
+     * samples
+     * @details Advances the gain smoothing exactly like process(), which
+     * multiplies each sample by the same gain, so the gains can drive any
+     * number of other signals, e.g. with apply_gain().
+     * @param samples Pointer to the samples to detect
+     * @param gains Pointer to `count` linear gains
+     * @param count Number of samples
+     */
+    auto compute_gain(const T *samples, T *gains, const size_t count) -> void {
+        DenormalGuard guard;
+        for (size_t i = 0; i < count; i++) {
+            gains[i] = next_gain(samples[i]);
+        }
+    }
+
+    /**
+     * @brief Computes the gain of every sample of a contiguous span without
+     * modifying the samples
+     * @param samples Span of samples to detect
+     * @param gains Span of gains, one per sample
+     */
+    auto compute_gain(std::span<const T> samples, std::span<T> gains) -> void {
+        compute_gain(samples.data(), gains.data(),
+                     std::min(samples.size(), gains.size()));
+    }
+
+    /**
+     * @brief Processes a contiguous span of samples in-place
+     * @param samples Span of samples
+     */
+    auto process(std::span<T> samples) -> void {
+        process(samples.data(), samples.size());
+    }
+
+    /**
+     * @brief Processes a strided view of samples in-place, e.g. one channel of
+     * an interleaved buffer
+     * @param samples Strided view of samples
+     */
+    auto process(const StridedView<T> samples) -> void {
+        if (samples.stride == 1) {
+            process(samples.data, samples.count);
+            return;
+        }
+        DenormalGuard guard;
+        for (size_t i = 0; i < samples.count; i++) {
             process(samples[i]);
         }
     }
 
+    /**
+     * @brief Processes non-contiguous segments of one signal in-place, in
+     * order, as if they were a single contiguous buffer
+     * @param segments Spans of samples
+     */
+    auto process(std::span<const std::span<T>> segments) -> void {
+        for (const std::span<T> segment: segments) {
+            process(segment);
+        }
+    }
+
+    /**
+     * @brief Processes an array of samples in-place while applying
+     * timestamped parameter events at their exact sample offsets
+     * @details The block kernel runs uninterrupted on the segments between
+     * events. Ramped events are interpolated linearly in the dB domain and may
+     * continue into the next block.
+     * @param samples Pointer to the samples
+     * @param count Number of samples
+     * @param events Events sorted by offset
+     */
+    auto process(T *samples, const size_t count,
+                 std::span<const ParameterEvent<T>> events) -> void {
+        DenormalGuard guard;
+        m_automation.process(
+                samples, count, events,
+                [this](const Parameter parameter) {
+                    return automatable_parameter(parameter);
+                },
+                [this](T *segment, const size_t length) {
+                    process(segment, length);
+                });
+    }
+
     /**
      * @brief Resets the compressor
      */
@@ -126,10 +223,155 @@ public:
      */
     auto set_configuration(CompressorConfiguration<T> configuration) -> void {
         m_config = configuration;
+        m_automation.cancel();
         calculate_intermediate_values();
     }
 
+    /**
+     * @brief Target gain for an input level, before gain smoothing
+     * @param inputDecibels Input in decibels
+     * @return The static characteristic minus the input, in decibels
+     */
+    [[nodiscard]] auto target_gain(T inputDecibels) const -> T {
+        return calculate_static_characteristic(inputDecibels) - inputDecibels;
+    }
+
+    /**
+     * @brief Static characteristic of the compressor over an array of input
+     * levels, without touching the processor state
+     * @details Branch-free, so the loop vectorizes. Every output is identical
+     * to what the compressor computes for that level while processing.
+     * @param inputDecibels Input levels in decibels
+     * @param output Static characteristic of every input level, in decibels
+     */
+    auto static_characteristic(std::span<const T> inputDecibels,
+                               std::span<T> output) const -> void {
+        const size_t count = std::min(inputDecibels.size(), output.size());
+        const T threshold = m_config.threshold;
+        const T ratio = m_config.ratio;
+        if (!m_config.kneeWidth.has_value()) {
+            for (size_t i = 0; i < count; i++) {
+                const T x = inputDecibels[i];
+                const T compressorThreshold =
+                        threshold - ((threshold - x) / ratio);
+                output[i] = x < compressorThreshold ? x : compressorThreshold;
+            }
+            return;
+        }
+        const T kneeWidth = m_config.kneeWidth.value();
+        for (size_t i = 0; i < count; i++) {
+            const T x = inputDecibels[i];
+            const T compressorThreshold = threshold - ((threshold - x) / ratio);
+            const auto offset = x - compressorThreshold + (kneeWidth / 2.0);
+            const T numerator = offset * offset;
+            const T knee = x - (numerator / (2.0 * kneeWidth));
+            const T above = x > (compressorThreshold + (kneeWidth / 2.0))
+                                    ? compressorThreshold
+                                    : knee;
+            output[i] = x < (compressorThreshold - (kneeWidth / 2.0)) ? x
+                                                                       : above;
+        }
+    }
+
+    /**
+     * @brief Gain smoothing coefficient of an attack or release time
+     * @param time Attack or release time
+     * @param sampleRate Sample rate
+     * @return The smoothing coefficient
+     */
+    [[nodiscard]] auto static time_coefficient(std::chrono::milliseconds time,
+                                               const int sampleRate) -> S {
+        return static_cast<S>(std::exp(
+                -std::log10(9.0) /
+                ((static_cast<S>(time.count()) / 1000.0) * sampleRate)));
+    }
+
+    /**
+     * @brief Gain smoothing coefficient used while the gain is decreasing
+     * @return The attack coefficient
+     */
+    [[nodiscard]] auto attack_coefficient() const -> S {
+        return m_attackValue;
+    }
+
+    /**
+     * @brief Gain smoothing coefficient used while the gain is increasing
+     * @return The release coefficient
+     */
+    [[nodiscard]] auto release_coefficient() const -> S {
+        return m_releaseValue;
+    }
+
+    /**
+     * @brief Gain smoothing coefficient for one step of the recursion
+     * @param gainSmoothing Current smoothed gain
+     * @param gC Target gain
+     * @return The attack coefficient if the gain is moving towards more gain
+     * reduction, the release coefficient otherwise
+     */
+    [[nodiscard]] auto smoothing_coefficient(S gainSmoothing, S gC) const
+            -> S {
+        if (gC <= gainSmoothing) {
+            return m_attackValue;
+        }
+        return m_releaseValue;
+    }
+
+    /**
+     * @brief One step of the attack/release gain smoothing recursion, without
+     * touching the processor state
+     * @param gainSmoothing Current smoothed gain
+     * @param gC Target gain
+     * @return The next smoothed gain
+     */
+    [[nodiscard]] auto smooth_gain(S gainSmoothing, S gC) const -> S {
+        S alpha = smoothing_coefficient(gainSmoothing, gC);
+        return flush_denormal<S>(alpha * gainSmoothing +
+                                 (1.0 - alpha) * gC);
+    }
+
+    /**
+     * @brief Makeup gain applied to the smoothed gain
+     * @return The makeup gain
+     */
+    [[nodiscard]] auto makeup_gain() const -> T {
+        return m_config.makeupGain.value();
+    }
+
+    /**
+     * @brief Whether processing a block would leave both the block and the
+     * compressor unchanged
+     * @details The gain smoothing has to be at its fixed point for silence,
+     * where it stays, and every sample has to be zero (or NaN), which any
+     * gain leaves as it is.
+     * @param samples Pointer to the samples
+     * @param count Number of samples
+     * @return True if the block is idle
+     */
+    [[nodiscard]] auto is_idle(const T *samples, const size_t count) const
+            -> bool {
+        const T inputDecibels = level_decibels(static_cast<T>(0));
+        const T xSc = calculate_static_characteristic(inputDecibels);
+        const S gC = static_cast<S>(xSc) - static_cast<S>(inputDecibels);
+        return smooth_gain(m_gainSmoothing, gC) == m_gainSmoothing &&
+               all_below(samples, count, static_cast<T>(0));
+    }
+
 private:
+    /**
+     * @brief Detect a sample and advance the gain smoothing
+     * @param sample Sample to detect
+     * @return The linear gain of the sample, makeup gain included
+     */
+    auto next_gain(const T sample) -> T {
+        T inputDecibels = level_decibels(sample);
+        T xSc = calculate_static_characteristic(inputDecibels);
+        update_gain_smoothing(xSc, inputDecibels);
+        T gM = static_cast<T>(m_gainSmoothing) * m_config.makeupGain.value();
+        T gLin = std::pow(10.0, gM / 20.0);
+        return gLin;
+    }
+
     /**
      * @brief Private constructor
      * @param configuration Compressor configuration
@@ -147,14 +389,32 @@ private:
      * @brief Calculate intermediate values
      */
     auto calculate_intermediate_values() -> void {
-        m_attackValue =
-                std::exp(-log10(9.0) /
-                         ((static_cast<T>(m_config.attack.count()) / 1000.0) *
-                          m_config.sampleRate));
+        m_attackValue = time_coefficient(m_config.attack, m_config.sampleRate);
         m_releaseValue =
-                std::exp(-log10(9.0) /
-                         ((static_cast<T>(m_config.release.count()) / 1000.0) *
-                          m_config.sampleRate));
+                time_coefficient(m_config.release, m_config.sampleRate);
+    }
+
+    /**
+     * @brief Resolve an automatable parameter
+     * @param parameter Parameter to resolve
+     * @return Pointer to the parameter in the configuration, or nullptr if the
+     * compressor does not have it
+     */
+    auto automatable_parameter(const Parameter parameter) -> T * {
+        switch (parameter) {
+            case Parameter::Threshold:
+                return &m_config.threshold;
+            case Parameter::Ratio:
+                return &m_config.ratio;
+            case Parameter::MakeupGain:
+                return &m_config.makeupGain.value();
+            case Parameter::KneeWidth:
+                if (m_config.kneeWidth.has_value()) {
+                    return &m_config.kneeWidth.value();
+                }
+                return nullptr;
+        }
+        return nullptr;
     }
 
     /**
@@ -162,7 +422,7 @@ private:
      * @param inputDecibels Input in decibels
      * @return The static characteristic
      */
-    T calculate_static_characteristic(T inputDecibels) {
+    T calculate_static_characteristic(T inputDecibels) const {
         T compressorThreshold =
                 m_config.threshold -
                 ((m_config.threshold - inputDecibels) / m_config.ratio);
@@ -195,24 +455,21 @@ private:
      * @param inputDecibels Input in decibels
      */
     void update_gain_smoothing(T xSc, T inputDecibels) {
-        T gC = xSc - inputDecibels;
-        T alpha = [this, &gC]() -> T {
-            if (gC <= m_gainSmoothing) {
-                return m_attackValue;
-            }
-            return m_releaseValue;
-        }();
-        m_gainSmoothing = alpha * m_gainSmoothing + (1.0 - alpha) * gC;
+        S gC = static_cast<S>(xSc) - static_cast<S>(inputDecibels);
+        m_gainSmoothing = smooth_gain(m_gainSmoothing, gC);
     }
 
     /** Compressor configuration */
     CompressorConfiguration<T> m_config;
 
     /** Gain smoothing */
-    T m_gainSmoothing = 0;
+    S m_gainSmoothing = 0;
+
+    S m_attackValue = 0;
+    S m_releaseValue = 0;
 
-    T m_attackValue = 0;
-    T m_releaseValue = 0;
+    /** Sample-accurate parameter automation */
+    ParameterAutomation<T> m_automation;
 };
 
 #endif // COMPRESSOR_H
@@ -0,0 +1,358 @@
+/// DeEsser.h
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef DE_ESSER_H
+#define DE_ESSER_H
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "Biquad.h"
+#include "Compressor.h"
+#include "Denormal.h"
+
+/**
+ * @brief Sidechain filter of the de-esser detector
+ */
+enum class DeEsserDetector {
+    /** Band pass around the sibilance frequency */
+    BandPass,
+
+    /** High shelf boosting everything above the sibilance frequency */
+    HighShelf
+};
+
+/**
+ * @brief Where the de-esser applies its gain
+ */
+enum class DeEsserMode {
+    /** To the whole signal */
+    Wideband,
+
+    /** To the sibilance band only, leaving the rest of the signal untouched */
+    SplitBand
+};
+
+/**
+ * @brief De-esser configuration
+ * @tparam T Type of the de-esser
+ */
+template<typename T = double>
+struct DeEsserConfiguration {
+    /** Sample rate */
+    int sampleRate = 0;
+
+    /** Centre (band pass) or midpoint (high shelf) frequency in Hz */
+    T frequency = static_cast<T>(6000);
+
+    /** Quality factor of the sidechain filter. Keep the high shelf at about
+     * 0.7 so it does not overshoot */
+    T q = static_cast<T>(2);
+
+    /** Sidechain filter */
+    DeEsserDetector detector = DeEsserDetector::BandPass;
+
+    /** Gain of the high shelf in decibels */
+    T shelfGain = static_cast<T>(12);
+
+    /** Threshold in decibels */
+    T threshold = static_cast<T>(0);
+
+    /** Attack time in milliseconds */
+    std::chrono::milliseconds attack = std::chrono::milliseconds(0);
+
+    /** Release time in milliseconds */
+    std::chrono::milliseconds release = std::chrono::milliseconds(0);
+
+    /** The ratio of the de-esser */
+    T ratio = static_cast<T>(0);
+
+    /** Knee width in decibels */
+    std::optional<T> kneeWidth = std::nullopt;
+
+    /** Where the gain is applied */
+    DeEsserMode mode = DeEsserMode::SplitBand;
+
+    /** Number of interleaved channels */
+    size_t channels = 1;
+};
+
+/**
+ * @brief De-esser class. Implements a frequency-selective compressor for
+ * sibilance.
+ * @details The detector runs a biquad band pass or high shelf on the
+ * sidechain, inline, and feeds its level to the gain computer and gain
+ * smoothing of a Compressor. In wideband mode the smoothed gain is applied to
+ * the whole signal. In split-band mode it is applied to the sibilance band
+ * only, as `x + (g - 1) * band`, so the output is bit-identical to the input
+ * while the de-esser is idle. With the high shelf the band is the part of the
+ * signal the shelf boosts, which is only in phase with the input well above
+ * the midpoint, so place the midpoint about an octave below the sibilance.
+ * Either way the input is read and written once, without a filtered copy.
+ *
+ * Multichannel input is interleaved or planar. Every channel has its own
+ * detector and gain. The per-frame filter loop runs across channels so it
+ * vectorizes; the gain computer evaluates log10 and pow per channel and
+ * stays scalar. The single-sample overload is for mono de-essers only.
+ *
+ * The per-channel state lives in the memory resource passed to create(), so
+ * a de-esser can be moved but not copied.
+ * @tparam T Type of the de-esser input and output samples
+ * @tparam S Type of the filter and gain smoothing state and coefficients
+ */
+template<typename T = double, typename S = T>
+class DeEsser {
+public:
+    /** Type of the input and output samples */
+    using sample_type = T;
+
+    /** Type of the filter and gain smoothing state and coefficients */
+    using state_type = S;
+
+    /**
+     * @brief Public constructor that verifies the configuration and creates a
+     * de-esser object
+     * @param configuration De-esser configuration
+     * @param resource Memory resource for the per-channel state
+     * @return A DeEsser object
+     */
+    auto static create(DeEsserConfiguration<T> configuration,
+                       std::pmr::memory_resource *resource =
+                               std::pmr::get_default_resource())
+            -> std::optional<DeEsser> {
+        if (configuration.sampleRate <= 0 || configuration.channels == 0 ||
+            resource == nullptr) {
+            return std::nullopt;
+        }
+        if (configuration.frequency <= static_cast<T>(0) ||
+            configuration.frequency >=
+                    static_cast<T>(configuration.sampleRate) / 2 ||
+            configuration.q <= static_cast<T>(0)) {
+            return std::nullopt;
+        }
+        if (configuration.detector == DeEsserDetector::HighShelf &&
+            configuration.shelfGain <= static_cast<T>(0)) {
+            return std::nullopt;
+        }
+        std::optional<Compressor<T, S>> compressor =
+                Compressor<T, S>::create(CompressorConfiguration<T>{
+                        .sampleRate = configuration.sampleRate,
+                        .threshold = configuration.threshold,
+                        .attack = configuration.attack,
+                        .release = configuration.release,
+                        .ratio = configuration.ratio,
+                        .makeupGain = static_cast<T>(1),
+                        .kneeWidth = configuration.kneeWidth});
+        if (!compressor.has_value()) {
+            return std::nullopt;
+        }
+        return DeEsser(configuration, *compressor, resource);
+    }
+
+    DeEsser(DeEsser &&) noexcept = default;
+    DeEsser(const DeEsser &) = delete;
+    auto operator=(const DeEsser &) -> DeEsser & = delete;
+    auto operator=(DeEsser &&) -> DeEsser & = delete;
+
+    /**
+     * @brief Process a sample in-place
+     * @details Only a mono de-esser has single-sample frames. With more
+     * channels the sample is left untouched and the state does not advance;
+     * process one interleaved frame with process(samples, channels) instead.
+     * @param sample Sample to process
+     */
+    auto process(T &sample) -> void {
+        if (m_config.channels == 1) {
+            process_frame(&sample);
+        }
+    }
+
+    /**
+     * @brief Processes an array of interleaved samples in-place
+     * @param samples Pointer to the samples
+     * @param count Number of samples, a multiple of the channel count
+     */
+    auto process(T *samples, const size_t count) -> void {
+        DenormalGuard guard;
+        const size_t channels = m_config.channels;
+        for (size_t i = 0; i + channels <= count; i += channels) {
+            process_frame(samples + i);
+        }
+    }
+
+    /**
+     * @brief Processes a contiguous span of interleaved samples in-place
+     * @param samples Span of samples
+     */
+    auto process(std::span<T> samples) -> void {
+        process(samples.data(), samples.size());
+    }
+
+    /**
+     * @brief Processes planar channels in-place
+     * @param channels One pointer per channel
+     * @param frames Number of samples in each channel
+     */
+    auto process(T *const *channels, const size_t frames) -> void {
+        DenormalGuard guard;
+        for (size_t i = 0; i < frames; i++) {
+            for (size_t c = 0; c < m_config.channels; c++) {
+                m_frame[c] = channels[c][i];
+            }
+            process_frame(m_frame.data());
+            for (size_t c = 0; c < m_config.channels; c++) {
+                channels[c][i] = m_frame[c];
+            }
+        }
+    }
+
+    /**
+     * @brief Resets the de-esser
+     */
+    auto reset() -> void {
+        m_filter.reset();
+        std::fill(m_gainSmoothing.begin(), m_gainSmoothing.end(),
+                  static_cast<S>(0));
+    }
+
+    /**
+     * @brief Current smoothed gain of a channel
+     * @param channel Channel index
+     * @return The gain in decibels
+     */
+    [[nodiscard]] auto gain(const size_t channel = 0) const -> S {
+        return m_gainSmoothing[channel];
+    }
+
+private:
+    /**
+     * @brief Private constructor
+     * @param configuration De-esser configuration
+     * @param compressor Gain computer
+     * @param resource Memory resource for the per-channel state
+     */
+    DeEsser(DeEsserConfiguration<T> configuration,
+            Compressor<T, S> compressor, std::pmr::memory_resource *resource) :
+        m_config(configuration), m_compressor(compressor),
+        m_filter(design_filter(configuration), configuration.channels,
+                 resource),
+        m_input(configuration.channels, resource),
+        m_filtered(configuration.channels, resource),
+        m_gainSmoothing(configuration.channels, resource),
+        m_frame(configuration.channels, resource) {
+        if (m_config.detector == DeEsserDetector::HighShelf) {
+            const S boost = static_cast<S>(
+                    std::pow(10.0, m_config.shelfGain / 20.0));
+            m_bandScale = static_cast<S>(1) / (boost - static_cast<S>(1));
+        }
+    }
+
+    /**
+     * @brief Design the sidechain filter
+     * @param configuration De-esser configuration
+     * @return The filter coefficients
+     */
+    static auto design_filter(const DeEsserConfiguration<T> &configuration)
+            -> BiquadCoefficients<S> {
+        if (configuration.detector == DeEsserDetector::HighShelf) {
+            return high_shelf<S>(configuration.sampleRate,
+                                 configuration.frequency, configuration.q,
+                                 configuration.shelfGain);
+        }
+        return band_pass<S>(configuration.sampleRate, configuration.frequency,
+                            configuration.q);
+    }
+
+    /**
+     * @brief Process one interleaved frame, every channel at once
+     * @param frame Pointer to the first sample of the frame
+     */
+    auto process_frame(T *frame) -> void {
+        const size_t channels = m_config.channels;
+        /// A NaN or an infinity would stay in the filter state for good:
+        for (size_t c = 0; c < channels; c++) {
+            m_input[c] = static_cast<S>(finite_sample(frame[c]));
+        }
+        m_filter.process(m_input.data(), m_filtered.data());
+
+        /// Detector level and gain computer, per channel:
+        for (size_t c = 0; c < channels; c++) {
+            T inputDecibels = level_decibels(static_cast<T>(m_filtered[c]));
+            S gC = static_cast<S>(m_compressor.target_gain(inputDecibels));
+            m_gainSmoothing[c] =
+                    m_compressor.smooth_gain(m_gainSmoothing[c], gC);
+        }
+
+        if (m_config.mode == DeEsserMode::Wideband) {
+            for (size_t c = 0; c < channels; c++) {
+                T gLin = std::pow(static_cast<T>(10.0),
+                                  static_cast<T>(m_gainSmoothing[c]) /
+                                          static_cast<T>(20.0));
+                frame[c] *= gLin;
+            }
+            return;
+        }
+        /// Split band: the band is the band pass output, or the part of the
+        /// signal the shelf boosts
+        const bool shelf = m_config.detector == DeEsserDetector::HighShelf;
+        for (size_t c = 0; c < channels; c++) {
+            const S band = shelf ? (m_filtered[c] - m_input[c]) * m_bandScale
+                                 : m_filtered[c];
+            const S gLin = std::pow(static_cast<S>(10.0),
+                                    m_gainSmoothing[c] / static_cast<S>(20.0));
+            frame[c] += static_cast<T>((gLin - static_cast<S>(1)) * band);
+        }
+    }
+
+    /** De-esser configuration */
+    DeEsserConfiguration<T> m_config;
+
+    /** Gain computer and gain smoothing */
+    Compressor<T, S> m_compressor;
+
+    /** Sidechain filter, one per channel */
+    BiquadBank<S> m_filter;
+
+    /** Input of the current frame */
+    std::pmr::vector<S> m_input;
+
+    /** Sidechain filter output of the current frame */
+    std::pmr::vector<S> m_filtered;
+
+    /** Gain smoothing, one per channel */
+    std::pmr::vector<S> m_gainSmoothing;
+
+    /** Gathered frame for planar input */
+    std::pmr::vector<T> m_frame;
+
+    /** Scale from the high shelf boost to the band it boosts */
+    S m_bandScale = static_cast<S>(1);
+};
+
+#endif // DE_ESSER_H
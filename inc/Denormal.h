@@ -0,0 +1,173 @@
+/// Denormal.h
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef DENORMAL_H
+#define DENORMAL_H
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#if defined(__SSE__) || defined(_M_X64) ||                                     \
+        (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define DENORMAL_GUARD_SSE 1
+#elif defined(__aarch64__)
+#define DENORMAL_GUARD_AARCH64 1
+#endif
+
+/**
+ * @brief RAII guard that flushes subnormal floating-point values to zero for
+ * the lifetime of the guard
+ * @details Recursive filters decaying towards zero in silence end up in the
+ * subnormal range, where arithmetic on x86 is 10-100x slower. On x86 the guard
+ * sets the flush-to-zero and denormals-are-zero bits of the MXCSR register; on
+ * AArch64 it sets the flush-to-zero bit of the FPCR register. The previous
+ * mode is restored on destruction. If the mode is already set, e.g. by a
+ * guard further up the stack or by the host, the register is not written at
+ * all, so nested guards are free. On other platforms the guard does nothing
+ * and the processors rely on flush_denormal() alone.
+ *
+ * The mode is per thread, so the guard has to be entered on the thread that
+ * does the processing.
+ */
+class DenormalGuard {
+public:
+    /** Whether the guard changes the floating-point mode on this platform */
+    static constexpr bool supported =
+#if defined(DENORMAL_GUARD_SSE) || defined(DENORMAL_GUARD_AARCH64)
+            true;
+#else
+            false;
+#endif
+
+    /**
+     * @brief Constructor. Enters flush-to-zero mode
+     */
+    DenormalGuard() {
+#if defined(DENORMAL_GUARD_SSE)
+        m_previous = _mm_getcsr();
+        if ((m_previous & sseMask) != sseMask) {
+            _mm_setcsr(m_previous | sseMask);
+            m_changed = true;
+        }
+#elif defined(DENORMAL_GUARD_AARCH64)
+        asm volatile("mrs %0, fpcr" : "=r"(m_previous));
+        if ((m_previous & fpcrMask) != fpcrMask) {
+            const uint64_t mode = m_previous | fpcrMask;
+            asm volatile("msr fpcr, %0" : : "r"(mode));
+            m_changed = true;
+        }
+#endif
+    }
+
+    /**
+     * @brief Destructor. Restores the previous mode
+     */
+    ~DenormalGuard() {
+#if defined(DENORMAL_GUARD_SSE)
+        if (m_changed) {
+            _mm_setcsr(m_previous);
+        }
+#elif defined(DENORMAL_GUARD_AARCH64)
+        if (m_changed) {
+            asm volatile("msr fpcr, %0" : : "r"(m_previous));
+        }
+#endif
+    }
+
+    DenormalGuard(const DenormalGuard &) = delete;
+    auto operator=(const DenormalGuard &) -> DenormalGuard & = delete;
+
+private:
+#if defined(DENORMAL_GUARD_SSE)
+    /** Flush-to-zero (bit 15) and denormals-are-zero (bit 6) */
+    static constexpr unsigned int sseMask = 0x8040;
+
+    /** MXCSR on entry */
+    unsigned int m_previous = 0;
+#elif defined(DENORMAL_GUARD_AARCH64)
+    /** Flush-to-zero (bit 24) */
+    static constexpr uint64_t fpcrMask = uint64_t{1} << 24;
+
+    /** FPCR on entry */
+    uint64_t m_previous = 0;
+#endif
+
+    /** Whether the constructor changed the mode */
+    [[maybe_unused]] bool m_changed = false;
+};
+
+/**
+ * @brief Flush a subnormal state value to zero
+ * @details Used on every recursive state update, so state decaying in silence
+ * stops at zero even where DenormalGuard is not supported or not entered, e.g.
+ * when processing one sample at a time.
+ * @tparam S Type of the state
+ * @param value State value
+ * @return The value, or zero if it is subnormal
+ */
+template<typename S>
+constexpr auto flush_denormal(const S value) -> S {
+    return std::fabs(value) < std::numeric_limits<S>::min() ? static_cast<S>(0)
+                                                            : value;
+}
+
+/**
+ * @brief Sanitized level detector, the level of a sample in decibels
+ * @details The magnitude is clamped to [-200 dB, +200 dB], so silence, negative
+ * samples, infinities and NaNs all produce a finite level instead of -inf or
+ * NaN flowing into the processor state. A NaN reads as silence.
+ * @tparam T Type of the sample
+ * @param sample Sample
+ * @return The level in decibels
+ */
+template<typename T>
+auto level_decibels(const T sample) -> T {
+    constexpr T floor = static_cast<T>(1e-10);
+    constexpr T ceiling = static_cast<T>(1e10);
+    T magnitude = std::fabs(sample);
+    if (!(magnitude > floor)) {
+        magnitude = floor;
+    } else if (magnitude > ceiling) {
+        magnitude = ceiling;
+    }
+    return static_cast<T>(20.0) * std::log10(magnitude);
+}
+
+/**
+ * @brief Sanitized filter input
+ * @details A recursive filter keeps a NaN or an infinity in its state for
+ * good, so detector filters are fed this instead of the raw sample. Like in
+ * level_decibels(), a NaN reads as silence, and so do infinities.
+ * @tparam T Type of the sample
+ * @param sample Sample
+ * @return The sample if it is finite, zero otherwise
+ */
+template<typename T>
+auto finite_sample(const T sample) -> T {
+    return std::isfinite(sample) ? sample : static_cast<T>(0);
+}
+
+#endif // DENORMAL_H
@@ -0,0 +1,241 @@
+/// Fft.h
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef FFT_H
+#define FFT_H
+
+#include <bit>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <memory_resource>
+#include <numbers>
+#include <optional>
+#include <vector>
+
+/**
+ * @brief Fft class. Real-input FFT of a fixed power-of-two size.
+ * @details A real signal of N samples is packed into N/2 complex samples,
+ * transformed with an iterative radix-2 FFT and split into the N/2 + 1
+ * non-negative frequency bins, which costs about half of a complex FFT of the
+ * same size. Twiddles and the bit-reversal permutation are precomputed, and
+ * the transforms do not allocate.
+ *
+ * Any type with the same create(), forward() and inverse() can be plugged
+ * into SpectralProcessor instead, e.g. a wrapper around a platform FFT.
+ * @tparam S Type of the samples and spectrum
+ */
+template<typename S = double>
+class Fft {
+public:
+    /**
+     * @brief Public constructor that creates an FFT object
+     * @param size Transform size, a power of two of at least 4
+     * @param resource Memory resource for the tables and scratch
+     * @return An Fft object if the arguments are valid, std::nullopt otherwise
+     */
+    auto static create(const size_t size,
+                       std::pmr::memory_resource *resource =
+                               std::pmr::get_default_resource())
+            -> std::optional<Fft> {
+        if (size < 4 || !std::has_single_bit(size) || resource == nullptr) {
+            return std::nullopt;
+        }
+        return Fft(size, resource);
+    }
+
+    /**
+     * @brief Transform size
+     * @return The number of real samples per transform
+     */
+    [[nodiscard]] auto size() const -> size_t { return m_size; }
+
+    /**
+     * @brief Forward transform
+     * @param input size() real samples
+     * @param spectrum size() / 2 + 1 bins, from DC to Nyquist
+     */
+    auto forward(const S *input, std::complex<S> *spectrum) -> void {
+        const size_t half = m_size / 2;
+        for (size_t n = 0; n < half; n++) {
+            m_real[m_reversed[n]] = input[2 * n];
+            m_imag[m_reversed[n]] = input[2 * n + 1];
+        }
+        transform(false);
+        /// Split the even and odd sample spectra and combine them:
+        for (size_t k = 0; k <= half; k++) {
+            const size_t i = k == half ? 0 : k;
+            const size_t j = k == 0 ? 0 : half - k;
+            const S zRe = m_real[i];
+            const S zIm = m_imag[i];
+            /// Conjugate of the mirrored bin:
+            const S zcRe = m_real[j];
+            const S zcIm = -m_imag[j];
+            const S evenRe = (zRe + zcRe) / 2;
+            const S evenIm = (zIm + zcIm) / 2;
+            /// (z - zc) / 2i:
+            const S oddRe = (zIm - zcIm) / 2;
+            const S oddIm = (zcRe - zRe) / 2;
+            const std::complex<S> w = m_split[k];
+            spectrum[k] = {evenRe + w.real() * oddRe - w.imag() * oddIm,
+                           evenIm + w.real() * oddIm + w.imag() * oddRe};
+        }
+    }
+
+    /**
+     * @brief Inverse transform, normalized so that it undoes forward()
+     * @param spectrum size() / 2 + 1 bins, from DC to Nyquist
+     * @param output size() real samples
+     */
+    auto inverse(const std::complex<S> *spectrum, S *output) -> void {
+        const size_t half = m_size / 2;
+        for (size_t k = 0; k < half; k++) {
+            const std::complex<S> x = spectrum[k];
+            const std::complex<S> xc = std::conj(spectrum[half - k]);
+            const S evenRe = (x.real() + xc.real()) / 2;
+            const S evenIm = (x.imag() + xc.imag()) / 2;
+            /// (x - xc) / 2 * conj(w):
+            const S dRe = (x.real() - xc.real()) / 2;
+            const S dIm = (x.imag() - xc.imag()) / 2;
+            const std::complex<S> w = m_split[k];
+            const S oddRe = dRe * w.real() + dIm * w.imag();
+            const S oddIm = dIm * w.real() - dRe * w.imag();
+            /// even + i odd:
+            m_real[m_reversed[k]] = evenRe - oddIm;
+            m_imag[m_reversed[k]] = evenIm + oddRe;
+        }
+        transform(true);
+        const S scale = static_cast<S>(1) / static_cast<S>(half);
+        for (size_t n = 0; n < half; n++) {
+            output[2 * n] = m_real[n] * scale;
+            output[2 * n + 1] = m_imag[n] * scale;
+        }
+    }
+
+private:
+    /**
+     * @brief Private constructor
+     * @param size Transform size
+     * @param resource Memory resource for the tables and scratch
+     */
+    Fft(const size_t size, std::pmr::memory_resource *resource) :
+        m_size(size), m_reversed(size / 2, resource),
+        m_twiddleReal(size / 2, resource), m_twiddleImag(size / 2, resource),
+        m_split(size / 2 + 1, resource), m_real(size / 2, resource),
+        m_imag(size / 2, resource) {
+        const size_t half = size / 2;
+        const int bits = std::countr_zero(half);
+        for (size_t n = 0; n < half; n++) {
+            size_t reversed = 0;
+            for (int b = 0; b < bits; b++) {
+                reversed |= ((n >> b) & 1) << (bits - 1 - b);
+            }
+            m_reversed[n] = reversed;
+        }
+        const double step = -2.0 * std::numbers::pi / static_cast<double>(size);
+        /// Stage of group length L uses e^(-2 pi i j / L), j < L / 2, stored
+        /// from offset L / 2 - 1:
+        for (size_t length = 2; length <= half; length *= 2) {
+            for (size_t j = 0; j < length / 2; j++) {
+                const double angle = -2.0 * std::numbers::pi *
+                                     static_cast<double>(j) /
+                                     static_cast<double>(length);
+                m_twiddleReal[length / 2 - 1 + j] =
+                        static_cast<S>(std::cos(angle));
+                m_twiddleImag[length / 2 - 1 + j] =
+                        static_cast<S>(std::sin(angle));
+            }
+        }
+        for (size_t k = 0; k < m_split.size(); k++) {
+            m_split[k] = {static_cast<S>(std::cos(step * k)),
+                          static_cast<S>(std::sin(step * k))};
+        }
+    }
+
+    /**
+     * @brief In-place radix-2 FFT of the bit-reversed scratch buffers
+     * @param inverse Whether to use the conjugate twiddles
+     */
+    auto transform(const bool inverse) -> void {
+        const size_t count = m_real.size();
+        const S sign = inverse ? static_cast<S>(-1) : static_cast<S>(1);
+        S *re = m_real.data();
+        S *im = m_imag.data();
+        /// The first stage has only the twiddle 1:
+        for (size_t a = 0; a < count; a += 2) {
+            const S tRe = re[a + 1];
+            const S tIm = im[a + 1];
+            re[a + 1] = re[a] - tRe;
+            im[a + 1] = im[a] - tIm;
+            re[a] += tRe;
+            im[a] += tIm;
+        }
+        for (size_t length = 4; length <= count; length *= 2) {
+            const size_t half = length / 2;
+            /// The twiddles of each stage are contiguous, so the butterflies
+            /// of one group vectorize:
+            const S *wRe = m_twiddleReal.data() + half - 1;
+            const S *wIm = m_twiddleImag.data() + half - 1;
+            for (size_t i = 0; i < count; i += length) {
+                S *aRe = re + i;
+                S *aIm = im + i;
+                S *bRe = aRe + half;
+                S *bIm = aIm + half;
+                for (size_t j = 0; j < half; j++) {
+                    const S twIm = sign * wIm[j];
+                    const S tRe = wRe[j] * bRe[j] - twIm * bIm[j];
+                    const S tIm = wRe[j] * bIm[j] + twIm * bRe[j];
+                    bRe[j] = aRe[j] - tRe;
+                    bIm[j] = aIm[j] - tIm;
+                    aRe[j] += tRe;
+                    aIm[j] += tIm;
+                }
+            }
+        }
+    }
+
+    /** Transform size */
+    size_t m_size;
+
+    /** Bit-reversal permutation of the half-size transform */
+    std::pmr::vector<size_t> m_reversed;
+
+    /** Twiddles of every stage of the half-size transform, real parts */
+    std::pmr::vector<S> m_twiddleReal;
+
+    /** Twiddles of every stage of the half-size transform, imaginary
+     * parts */
+    std::pmr::vector<S> m_twiddleImag;
+
+    /** Twiddles combining the even and odd sample spectra */
+    std::pmr::vector<std::complex<S>> m_split;
+
+    /** Half-size transform buffer, real parts */
+    std::pmr::vector<S> m_real;
+
+    /** Half-size transform buffer, imaginary parts */
+    std::pmr::vector<S> m_imag;
+};
+
+#endif // FFT_H
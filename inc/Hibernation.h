@@ -0,0 +1,270 @@
+/// Hibernation.h
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef HIBERNATION_H
+#define HIBERNATION_H
+
+#include <cmath>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <utility>
+
+#include "Denormal.h"
+
+/**
+ * @brief Hibernation statistics of a processor
+ */
+struct HibernationStatistics {
+    /** Number of times the processor went to sleep */
+    size_t hibernations = 0;
+
+    /** Number of blocks skipped while asleep */
+    size_t hibernatedBlocks = 0;
+
+    /** Number of times the processor woke up */
+    size_t wakes = 0;
+};
+
+/**
+ * @brief Whether no sample of a block has a magnitude above a level
+ * @details Branch-free, so the loop vectorizes. NaNs are not above any level,
+ * like in the processors' own comparisons.
+ * @tparam T Type of the samples
+ * @tparam L Type of the level, the samples are compared in this type
+ * @param samples Pointer to the samples
+ * @param count Number of samples
+ * @param level Level
+ * @return True if every magnitude is at most the level
+ */
+template<typename T, typename L>
+auto all_below(const T *samples, const size_t count, const L level) -> bool {
+    unsigned above = 0;
+    for (size_t i = 0; i < count; i++) {
+        above |= static_cast<unsigned>(
+                static_cast<L>(std::fabs(samples[i])) > level);
+    }
+    return above == 0;
+}
+
+/**
+ * @brief Hibernation class. Decides when a processor may skip its blocks.
+ * @details A block is idle when processing it would leave both the processor
+ * state and the samples unchanged: the state sits at the fixed point of its
+ * recursion for silence and the block is silent. After a configured number of
+ * consecutive idle blocks the processor hibernates and skips every further
+ * idle block, which is bit-identical to processing it. The first block that is
+ * not idle wakes it up and is processed as usual.
+ */
+class Hibernation {
+public:
+    /**
+     * @brief Record a block
+     * @param idle Whether the block is idle
+     * @param blocks Idle blocks before hibernating, 0 to never hibernate
+     * @return True if the block can be skipped
+     */
+    auto block(const bool idle, const size_t blocks) -> bool {
+        if (!idle) {
+            if (m_hibernating) {
+                m_hibernating = false;
+                m_statistics.wakes++;
+            }
+            m_idleBlocks = 0;
+            return false;
+        }
+        if (m_idleBlocks < blocks) {
+            m_idleBlocks++;
+            return false;
+        }
+        if (blocks == 0) {
+            return false;
+        }
+        if (!m_hibernating) {
+            m_hibernating = true;
+            m_statistics.hibernations++;
+        }
+        m_statistics.hibernatedBlocks++;
+        return true;
+    }
+
+    /**
+     * @brief Whether the processor is asleep
+     * @return True if the last block was skipped
+     */
+    [[nodiscard]] auto hibernating() const -> bool { return m_hibernating; }
+
+    /**
+     * @brief Hibernation statistics
+     * @return The statistics since construction
+     */
+    [[nodiscard]] auto statistics() const -> HibernationStatistics {
+        return m_statistics;
+    }
+
+private:
+    /** Consecutive idle blocks */
+    size_t m_idleBlocks = 0;
+
+    /** Whether the processor is asleep */
+    bool m_hibernating = false;
+
+    /** Hibernation statistics */
+    HibernationStatistics m_statistics;
+};
+
+/**
+ * @brief Hibernating processor class. Lets a Limiter, Compressor, Expander or
+ * NoiseGate sleep through muted or silent streams.
+ * @details Every block first asks the processor whether it is idle, which is
+ * a single comparison while the processor is still settling and a
+ * vectorized scan of the block once it has settled. After the configured
+ * number of consecutive idle blocks the processor hibernates: idle blocks
+ * are skipped outright, or zeroed for a closed NoiseGate, and the processor
+ * state is not touched, so it stays out of the cache. The first block that
+ * is not idle is processed in full, so the output is bit-identical to never
+ * having slept.
+ *
+ * The state is kept outside the processor so processor banks stay a cache
+ * line per processor. A gain processor settles once its gain smoothing has
+ * reached the gain for silence exactly, which takes seconds for float state
+ * and tens of seconds for double state.
+ * @tparam P Type of the processor
+ */
+template<typename P>
+class Hibernating {
+public:
+    /** Type of the input and output samples */
+    using sample_type = typename P::sample_type;
+
+    /** Type of the processor state */
+    using state_type = typename P::state_type;
+
+    /**
+     * @brief Public constructor that creates a hibernating processor object
+     * @param processor Processor to run
+     * @param idleBlocks Consecutive idle blocks before hibernating
+     * @return A Hibernating object if the arguments are valid, std::nullopt
+     * otherwise
+     */
+    auto static create(P processor, const size_t idleBlocks = 16)
+            -> std::optional<Hibernating> {
+        if (idleBlocks == 0) {
+            return std::nullopt;
+        }
+        return Hibernating(std::move(processor), idleBlocks);
+    }
+
+    /**
+     * @brief Process a sample in-place. Does not count towards hibernation
+     * @param sample Sample to process
+     */
+    auto process(sample_type &sample) -> void { m_processor.process(sample); }
+
+    /**
+     * @brief Processes an array of samples in-place, or skips it while
+     * hibernating
+     * @param samples Pointer to the samples
+     * @param count Number of samples
+     */
+    auto process(sample_type *samples, const size_t count) -> void {
+        DenormalGuard guard;
+        if (m_hibernation.block(m_processor.is_idle(samples, count),
+                                m_idleBlocks)) {
+            if constexpr (processes_idle) {
+                m_processor.process_idle(samples, count);
+            }
+            return;
+        }
+        m_processor.process(samples, count);
+    }
+
+    /**
+     * @brief Processes a contiguous span of samples in-place
+     * @param samples Span of samples
+     */
+    auto process(std::span<sample_type> samples) -> void {
+        process(samples.data(), samples.size());
+    }
+
+    /**
+     * @brief Resets the processor
+     */
+    auto reset() -> void { m_processor.reset(); }
+
+    /**
+     * @brief The processor, e.g. to change its configuration
+     * @return The processor
+     */
+    [[nodiscard]] auto processor() -> P & { return m_processor; }
+
+    /**
+     * @brief The processor
+     * @return The processor, read-only
+     */
+    [[nodiscard]] auto processor() const -> const P & { return m_processor; }
+
+    /**
+     * @brief Whether the processor is asleep
+     * @return True if the last block was skipped
+     */
+    [[nodiscard]] auto hibernating() const -> bool {
+        return m_hibernation.hibernating();
+    }
+
+    /**
+     * @brief Hibernation statistics
+     * @return How often the processor went to sleep and woke up, and how many
+     * blocks it skipped
+     */
+    [[nodiscard]] auto hibernation() const -> HibernationStatistics {
+        return m_hibernation.statistics();
+    }
+
+private:
+    /** Whether an idle block still has to be written, as for the NoiseGate */
+    static constexpr bool processes_idle =
+            requires(const P &processor, sample_type *samples) {
+                processor.process_idle(samples, size_t{0});
+            };
+
+    /**
+     * @brief Private constructor
+     * @param processor Processor to run
+     * @param idleBlocks Consecutive idle blocks before hibernating
+     */
+    Hibernating(P processor, const size_t idleBlocks) :
+        m_processor(std::move(processor)), m_idleBlocks(idleBlocks) {}
+
+    /** Processor */
+    P m_processor;
+
+    /** Consecutive idle blocks before hibernating */
+    size_t m_idleBlocks;
+
+    /** Idle block detection */
+    Hibernation m_hibernation;
+};
+
+#endif // HIBERNATION_H
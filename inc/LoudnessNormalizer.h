@@ -0,0 +1,521 @@
+/// LoudnessNormalizer.h
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef LOUDNESS_NORMALIZER_H
+#define LOUDNESS_NORMALIZER_H
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <span>
+
+#include "Biquad.h"
+#include "Denormal.h"
+#include "SampleView.h"
+
+/**
+ * @brief Loudness measurement that drives the normalizer gain
+ */
+enum class LoudnessWindow {
+    /** 400 ms sliding window */
+    Momentary,
+
+    /** 3 s sliding window */
+    ShortTerm,
+
+    /** Gated loudness of everything processed since the last reset */
+    Integrated
+};
+
+/**
+ * @brief Loudness normalizer configuration
+ * @tparam T Type of the loudness normalizer
+ */
+template<typename T = double>
+struct LoudnessNormalizerConfiguration {
+    /** Sample rate */
+    int sampleRate = 0;
+
+    /** Target loudness in LUFS */
+    T targetLoudness = static_cast<T>(-23);
+
+    /** Loudness measurement that drives the gain */
+    LoudnessWindow window = LoudnessWindow::ShortTerm;
+
+    /** Attack time in milliseconds, used when the gain decreases */
+    std::chrono::milliseconds attack = std::chrono::milliseconds(0);
+
+    /** Release time in milliseconds, used when the gain increases */
+    std::chrono::milliseconds release = std::chrono::milliseconds(0);
+
+    /** Maximum gain in decibels */
+    std::optional<T> maxGain = std::nullopt;
+
+    /** Makeup gain in decibels */
+    std::optional<T> makeupGain = std::nullopt;
+};
+
+/**
+ * @brief Loudness normalizer class. Implements an automatic gain control that
+ * drives a signal towards a target loudness as defined by ITU-R BS.1770 /
+ * EBU R128.
+ * @details The detector path runs the two-stage K-weighting filter and
+ * accumulates the mean square in 100 ms sub-blocks. Momentary (400 ms) and
+ * short-term (3 s) loudness are kept as running sums over a fixed ring of
+ * sub-blocks, so each update costs O(1). Integrated loudness is kept as a
+ * histogram of 400 ms gating blocks in 0.1 LU bins, which applies the absolute
+ * (-70 LUFS) and relative (-10 LU) gates without re-scanning history. The gain
+ * computed from the selected measurement is smoothed with the same
+ * attack/release recursion as the Compressor. The target only changes once per
+ * sub-block, so the recursion is advanced over a whole sub-block in closed
+ * form and the linear gain is ramped across it, which takes one power per
+ * 100 ms instead of one per sample. Nothing is allocated after creation.
+ * @tparam T Type of the loudness normalizer input and output samples
+ * @tparam S Type of the loudness normalizer filter, measurement and gain
+ * smoothing state
+ */
+template<typename T = double, typename S = T>
+class LoudnessNormalizer {
+public:
+    /**
+     * @brief Public constructor that verifies the configuration and creates a
+     * loudness normalizer object
+     * @param configuration Loudness normalizer configuration
+     * @return A LoudnessNormalizer object if the configuration is valid,
+     * std::nullopt otherwise
+     */
+    auto static create(LoudnessNormalizerConfiguration<T> configuration)
+            -> std::optional<LoudnessNormalizer> {
+        if (configuration.sampleRate < subBlocksPerSecond) {
+            return std::nullopt;
+        }
+        if (configuration.attack.count() <= 0 ||
+            configuration.release.count() <= 0) {
+            return std::nullopt;
+        }
+        return LoudnessNormalizer(configuration);
+    }
+
+    /**
+     * @brief Process a sample in-place
+     * @param sample Sample to process
+     */
+    auto process(T &sample) -> void {
+        if (m_subBlockPosition == 0) {
+            start_gain_ramp();
+        }
+        const S weighted = m_highpass.process(
+                m_shelf.process(static_cast<S>(finite_sample(sample))));
+        m_subBlockEnergy += weighted * weighted;
+        if (++m_subBlockPosition == m_subBlockLength) {
+            complete_sub_block();
+        }
+        m_linearGain += m_gainStep;
+        sample *= static_cast<T>(m_linearGain);
+    }
+
+    /**
+     * @brief Processes an array of samples in-place
+     * @param samples Pointer to the samples
+     * @param count Number of samples
+     */
+    auto process(T *samples, const size_t count) -> void {
+        DenormalGuard guard;
+        for (size_t i = 0; i < count; i++) {
+            process(samples[i]);
+        }
+    }
+
+    /**
+     * @brief Processes a contiguous span of samples in-place
+     * @param samples Span of samples
+     */
+    auto process(std::span<T> samples) -> void {
+        process(samples.data(), samples.size());
+    }
+
+    /**
+     * @brief Processes a strided view of samples in-place, e.g. one channel of
+     * an interleaved buffer
+     * @param samples Strided view of samples
+     */
+    auto process(const StridedView<T> samples) -> void {
+        if (samples.stride == 1) {
+            process(samples.data, samples.count);
+            return;
+        }
+        DenormalGuard guard;
+        for (size_t i = 0; i < samples.count; i++) {
+            process(samples[i]);
+        }
+    }
+
+    /**
+     * @brief Processes non-contiguous segments of one signal in-place, in
+     * order, as if they were a single contiguous buffer
+     * @param segments Spans of samples
+     */
+    auto process(std::span<const std::span<T>> segments) -> void {
+        for (const std::span<T> segment: segments) {
+            process(segment);
+        }
+    }
+
+    /**
+     * @brief Resets the loudness normalizer, clearing the filters, every
+     * loudness measurement and the gain
+     */
+    auto reset() -> void {
+        m_shelf.reset();
+        m_highpass.reset();
+        m_subBlocks.fill(static_cast<S>(0));
+        m_subBlockIndex = 0;
+        m_subBlocksFilled = 0;
+        m_subBlockPosition = 0;
+        m_subBlockEnergy = static_cast<S>(0);
+        m_momentarySum = static_cast<S>(0);
+        m_shortTermSum = static_cast<S>(0);
+        m_histogramCount.fill(0);
+        m_histogramEnergy.fill(static_cast<S>(0));
+        m_gatedCount = 0;
+        m_gatedEnergy = static_cast<S>(0);
+        m_integratedLoudness = -std::numeric_limits<S>::infinity();
+        m_targetGain = static_cast<S>(0);
+        m_gainSmoothing = static_cast<S>(0);
+        m_linearGain = makeup_linear_gain();
+        m_gainStep = static_cast<S>(0);
+    }
+
+    /**
+     * @brief Set the loudness normalizer configuration after creation
+     * @details Loudness measurements are kept unless the sample rate changes
+     * @param configuration Loudness normalizer configuration
+     */
+    auto set_configuration(LoudnessNormalizerConfiguration<T> configuration)
+            -> void {
+        const bool sampleRateChanged =
+                configuration.sampleRate != m_config.sampleRate;
+        m_config = configuration;
+        if (!m_config.makeupGain.has_value()) {
+            m_config.makeupGain = static_cast<T>(0);
+        }
+        calculate_intermediate_values();
+        if (sampleRateChanged) {
+            reset();
+        }
+    }
+
+    /**
+     * @brief Momentary loudness of the input
+     * @return Loudness over the last 400 ms in LUFS
+     */
+    [[nodiscard]] auto momentary_loudness() const -> T {
+        return static_cast<T>(
+                loudness(m_momentarySum,
+                         std::min(m_subBlocksFilled, momentarySubBlocks)));
+    }
+
+    /**
+     * @brief Short-term loudness of the input
+     * @return Loudness over the last 3 s in LUFS
+     */
+    [[nodiscard]] auto short_term_loudness() const -> T {
+        return static_cast<T>(loudness(m_shortTermSum, m_subBlocksFilled));
+    }
+
+    /**
+     * @brief Integrated loudness of the input
+     * @return Gated loudness since the last reset in LUFS, or -infinity if no
+     * gating block has passed the absolute gate yet
+     */
+    [[nodiscard]] auto integrated_loudness() const -> T {
+        return static_cast<T>(m_integratedLoudness);
+    }
+
+    /**
+     * @brief Smoothed gain at the end of the current sub-block, excluding
+     * makeup gain
+     * @return Gain in decibels
+     */
+    [[nodiscard]] auto gain() const -> T {
+        return static_cast<T>(m_gainSmoothing);
+    }
+
+private:
+    /** Sub-blocks per second, i.e. the 100 ms gating block step */
+    static constexpr int subBlocksPerSecond = 10;
+
+    /** Sub-blocks in the short-term window */
+    static constexpr size_t shortTermSubBlocks = 30;
+
+    /** Sub-blocks in the momentary window and in one gating block */
+    static constexpr size_t momentarySubBlocks = 4;
+
+    /** Lower edge of the integrated loudness histogram in LUFS */
+    static constexpr double histogramFloor = -70.0;
+
+    /** Width of one integrated loudness histogram bin in LU */
+    static constexpr double histogramResolution = 0.1;
+
+    /** Bins in the integrated loudness histogram, covering -70 to +5 LUFS */
+    static constexpr size_t histogramBins = 750;
+
+    /**
+     * @brief Private constructor
+     * @param configuration Loudness normalizer configuration
+     */
+    explicit LoudnessNormalizer(
+            LoudnessNormalizerConfiguration<T> configuration) :
+        m_config(configuration) {
+        /// If makeupGain is not specified, default to unity:
+        if (!m_config.makeupGain.has_value()) {
+            m_config.makeupGain = static_cast<T>(0);
+        }
+        calculate_intermediate_values();
+        m_linearGain = makeup_linear_gain();
+    }
+
+    /**
+     * @brief Calculate intermediate values
+     */
+    auto calculate_intermediate_values() -> void {
+        m_attackValue =
+                std::exp(-log10(9.0) /
+                         ((static_cast<S>(m_config.attack.count()) / 1000.0) *
+                          m_config.sampleRate));
+        m_releaseValue =
+                std::exp(-log10(9.0) /
+                         ((static_cast<S>(m_config.release.count()) / 1000.0) *
+                          m_config.sampleRate));
+        m_shelf.set_coefficients(k_weighting_shelf<S>(m_config.sampleRate));
+        m_highpass.set_coefficients(
+                k_weighting_highpass<S>(m_config.sampleRate));
+        m_subBlockLength =
+                static_cast<size_t>(m_config.sampleRate / subBlocksPerSecond);
+        const S subBlockLength = static_cast<S>(m_subBlockLength);
+        m_attackSubBlockValue = std::pow(m_attackValue, subBlockLength);
+        m_releaseSubBlockValue = std::pow(m_releaseValue, subBlockLength);
+    }
+
+    /**
+     * @brief Linear makeup gain, the linear gain while the smoothed gain is 0
+     * @return The linear gain
+     */
+    [[nodiscard]] auto makeup_linear_gain() const -> S {
+        return std::pow(static_cast<S>(10.0),
+                        static_cast<S>(m_config.makeupGain.value()) /
+                                static_cast<S>(20.0));
+    }
+
+    /**
+     * @brief Convert a sum of sub-block energies to loudness
+     * @param energy Sum of K-weighted squared samples
+     * @param subBlocks Number of sub-blocks in the sum
+     * @return Loudness in LUFS
+     */
+    [[nodiscard]] auto loudness(const S energy, const size_t subBlocks) const
+            -> S {
+        if (subBlocks == 0 || energy <= static_cast<S>(0)) {
+            return -std::numeric_limits<S>::infinity();
+        }
+        const S meanSquare =
+                energy / static_cast<S>(subBlocks * m_subBlockLength);
+        return static_cast<S>(-0.691) +
+               static_cast<S>(10.0) * std::log10(meanSquare);
+    }
+
+    /**
+     * @brief Close the current 100 ms sub-block, update every loudness
+     * measurement and compute a new target gain
+     */
+    auto complete_sub_block() -> void {
+        const size_t momentaryDropped =
+                (m_subBlockIndex + shortTermSubBlocks - momentarySubBlocks) %
+                shortTermSubBlocks;
+        m_momentarySum += m_subBlockEnergy - m_subBlocks[momentaryDropped];
+        m_shortTermSum += m_subBlockEnergy - m_subBlocks[m_subBlockIndex];
+        /// Running sums can drift slightly negative through cancellation:
+        m_momentarySum = std::max(m_momentarySum, static_cast<S>(0));
+        m_shortTermSum = std::max(m_shortTermSum, static_cast<S>(0));
+        m_subBlocks[m_subBlockIndex] = m_subBlockEnergy;
+        m_subBlockIndex = (m_subBlockIndex + 1) % shortTermSubBlocks;
+        if (m_subBlocksFilled < shortTermSubBlocks) {
+            m_subBlocksFilled++;
+        }
+        m_subBlockEnergy = static_cast<S>(0);
+        m_subBlockPosition = 0;
+
+        if (m_subBlocksFilled >= momentarySubBlocks) {
+            add_gating_block();
+        }
+
+        const S measured = [this]() -> S {
+            switch (m_config.window) {
+                case LoudnessWindow::Momentary:
+                    return loudness(m_momentarySum,
+                                    std::min(m_subBlocksFilled,
+                                             momentarySubBlocks));
+                case LoudnessWindow::ShortTerm:
+                    return loudness(m_shortTermSum, m_subBlocksFilled);
+                case LoudnessWindow::Integrated:
+                    return m_integratedLoudness;
+            }
+            return m_integratedLoudness;
+        }();
+        /// Hold the gain through silence instead of boosting the noise floor:
+        if (measured <= static_cast<S>(histogramFloor)) {
+            return;
+        }
+        m_targetGain = static_cast<S>(m_config.targetLoudness) - measured;
+        if (m_config.maxGain.has_value()) {
+            m_targetGain = std::min(m_targetGain,
+                                    static_cast<S>(m_config.maxGain.value()));
+        }
+    }
+
+    /**
+     * @brief Add the latest 400 ms gating block to the integrated loudness
+     * histogram and re-evaluate the relative gate
+     */
+    auto add_gating_block() -> void {
+        const S blockLoudness = loudness(m_momentarySum, momentarySubBlocks);
+        if (blockLoudness <= static_cast<S>(histogramFloor)) {
+            return;
+        }
+        const S meanSquare = m_momentarySum /
+                             static_cast<S>(momentarySubBlocks *
+                                            m_subBlockLength);
+        const size_t bin = bin_index(blockLoudness);
+        m_histogramCount[bin]++;
+        m_histogramEnergy[bin] += meanSquare;
+        m_gatedCount++;
+        m_gatedEnergy += meanSquare;
+
+        const S relativeGate =
+                static_cast<S>(-0.691) +
+                static_cast<S>(10.0) *
+                        std::log10(m_gatedEnergy /
+                                   static_cast<S>(m_gatedCount)) -
+                static_cast<S>(10.0);
+        size_t count = 0;
+        S energy = static_cast<S>(0);
+        for (size_t i = bin_index(relativeGate); i < histogramBins; i++) {
+            count += m_histogramCount[i];
+            energy += m_histogramEnergy[i];
+        }
+        m_integratedLoudness =
+                count == 0 ? -std::numeric_limits<S>::infinity()
+                           : static_cast<S>(-0.691) +
+                                     static_cast<S>(10.0) *
+                                             std::log10(energy /
+                                                        static_cast<S>(count));
+    }
+
+    /**
+     * @brief Histogram bin for a loudness value
+     * @param loudness Loudness in LUFS
+     * @return The bin index, clamped to the histogram
+     */
+    [[nodiscard]] static auto bin_index(const S loudness) -> size_t {
+        const S position = (loudness - static_cast<S>(histogramFloor)) /
+                           static_cast<S>(histogramResolution);
+        if (position <= static_cast<S>(0)) {
+            return 0;
+        }
+        return std::min(static_cast<size_t>(position), histogramBins - 1);
+    }
+
+    /**
+     * @brief Advance the gain smoothing to the end of the sub-block that is
+     * about to start and ramp the linear gain towards it
+     * @details The target is constant over the sub-block, so the smoothed gain
+     * moves in one direction and the per-sample recursion
+     * `g = alpha * g + (1 - alpha) * target` collapses to one step with the
+     * coefficient raised to the sub-block length.
+     */
+    auto start_gain_ramp() -> void {
+        const S gC = m_targetGain;
+        const S alpha = gC <= m_gainSmoothing ? m_attackSubBlockValue
+                                              : m_releaseSubBlockValue;
+        m_gainSmoothing =
+                flush_denormal<S>(alpha * m_gainSmoothing + (1.0 - alpha) * gC);
+        const S gM = m_gainSmoothing +
+                     static_cast<S>(m_config.makeupGain.value());
+        const S target =
+                std::pow(static_cast<S>(10.0), gM / static_cast<S>(20.0));
+        m_gainStep = (target - m_linearGain) /
+                     static_cast<S>(m_subBlockLength);
+    }
+
+    /** Loudness normalizer configuration */
+    LoudnessNormalizerConfiguration<T> m_config;
+
+    /** K-weighting filter stages */
+    Biquad<S> m_shelf;
+    Biquad<S> m_highpass;
+
+    /** Ring of sub-block energies covering the short-term window */
+    std::array<S, shortTermSubBlocks> m_subBlocks{};
+    size_t m_subBlockIndex = 0;
+    size_t m_subBlocksFilled = 0;
+
+    /** Sub-block currently being accumulated */
+    size_t m_subBlockLength = 0;
+    size_t m_subBlockPosition = 0;
+    S m_subBlockEnergy = 0;
+
+    /** Running sums over the momentary and short-term windows */
+    S m_momentarySum = 0;
+    S m_shortTermSum = 0;
+
+    /** Integrated loudness histogram of gating blocks */
+    std::array<size_t, histogramBins> m_histogramCount{};
+    std::array<S, histogramBins> m_histogramEnergy{};
+    size_t m_gatedCount = 0;
+    S m_gatedEnergy = 0;
+    S m_integratedLoudness = -std::numeric_limits<S>::infinity();
+
+    /** Gain smoothing */
+    S m_targetGain = 0;
+    S m_gainSmoothing = 0;
+
+    /** Linear gain applied to the last sample, makeup gain included */
+    S m_linearGain = 1;
+
+    /** Linear gain increment per sample over the current sub-block */
+    S m_gainStep = 0;
+
+    S m_attackValue = 0;
+    S m_releaseValue = 0;
+
+    /** Attack and release coefficients over a whole sub-block */
+    S m_attackSubBlockValue = 0;
+    S m_releaseSubBlockValue = 0;
+};
+
+#endif // LOUDNESS_NORMALIZER_H
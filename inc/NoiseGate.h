@@ -25,7 +25,15 @@ SOFTWARE.
 #ifndef NOISE_GATE_H
 #define NOISE_GATE_H
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <optional>
+#include <span>
+
+#include "Denormal.h"
+#include "Hibernation.h"
+#include "SampleView.h"
 
 /**
  * @brief Noise gate configuration
@@ -58,11 +66,20 @@ struct NoiseGateConfiguration {
  * @details A noise gate is a type of dynamic range compressor that attenuates
  * the signal when it falls below a certain threshold. The attenuation is
  * controlled by the attack and release times.
- * @tparam T Type of the limiter
+ * @tparam T Type of the noise gate input and output samples
+ * @tparam S Type of the noise gate envelope state and coefficients. Use
+ * `NoiseGate<float, double>` to keep float I/O while running the envelope
+ * recursion in double precision
  */
-template<typename T = double>
+template<typename T = double, typename S = T>
 class NoiseGate {
 public:
+    /** Type of the input and output samples */
+    using sample_type = T;
+
+    /** Type of the envelope state and coefficients */
+    using state_type = S;
+
     /**
      * @brief Public constructor
      * @param configuration Noise gate configuration
@@ -85,13 +102,7 @@ public:
      * @param sample Sample to process
      */
     auto process(T &sample) -> void {
-        T inputLevel = std::fabs(sample);
-        if (inputLevel > m_thresholdValue) {
-            m_envelope = m_attackValue * (m_envelope - inputLevel) + inputLevel;
-        } else {
-            m_envelope = m_releaseValue * m_envelope;
-        }
-        if (m_envelope < m_thresholdValue) {
+        if (!update_envelope(sample)) {
             sample = static_cast<T>(0);
         }
     }
@@ -102,17 +113,154 @@ public:
      * @param count Number of samples
      */
     auto process(T *samples, const size_t count) -> void {
-        for (int i = 0; i < count; i++) {
+        DenormalGuard guard;
+        for (size_t i = 0; i < count; i++) {
+            process(samples[i]);
+        }
+    }
+
+    /**
+     * @brief Computes the gain of every sample without modifying the samples
+     * @details Advances the envelope exactly like process(), so the gains, 0
+     * while the gate is closed and 1 while it is open, can drive any number
+     * of other signals, e.g. with apply_gain().
+     * @param samples Pointer to the samples to detect
+     * @param gains Pointer to `count` gains
+     * @param count Number of samples
+     */
+    auto compute_gain(const T *samples, T *gains, const size_t count) -> void {
+        DenormalGuard guard;
+        for (size_t i = 0; i < count; i++) {
+            gains[i] = update_envelope(samples[i]) ? static_cast<T>(1)
+                                                   : static_cast<T>(0);
+        }
+    }
+
+    /**
+     * @brief Computes the gain of every sample of a contiguous span without
+     * modifying the samples
+     * @param samples Span of samples to detect
+     * @param gains Span of gains, one per sample
+     */
+    auto compute_gain(std::span<const T> samples, std::span<T> gains) -> void {
+        compute_gain(samples.data(), gains.data(),
+                     std::min(samples.size(), gains.size()));
+    }
+
+    /**
+     * @brief Processes a contiguous span of samples in-place
+     * @param samples Span of samples
+     */
+    auto process(std::span<T> samples) -> void {
+        process(samples.data(), samples.size());
+    }
+
+    /**
+     * @brief Processes a strided view of samples in-place, e.g. one channel of
+     * an interleaved buffer
+     * @param samples Strided view of samples
+     */
+    auto process(const StridedView<T> samples) -> void {
+        if (samples.stride == 1) {
+            process(samples.data, samples.count);
+            return;
+        }
+        DenormalGuard guard;
+        for (size_t i = 0; i < samples.count; i++) {
             process(samples[i]);
         }
     }
 
+    /**
+     * @brief Processes non-contiguous segments of one signal in-place, in
+     * order, as if they were a single contiguous buffer
+     * @param segments Spans of samples
+     */
+    auto process(std::span<const std::span<T>> segments) -> void {
+        for (const std::span<T> segment: segments) {
+            process(segment);
+        }
+    }
+
     /**
      * @brief Resets the noise gate
      */
     auto reset() -> void { m_envelope = 0.0; }
 
+    /**
+     * @brief Envelope coefficient used while the input is above the threshold
+     * @return The attack coefficient
+     */
+    [[nodiscard]] auto attack_coefficient() const -> S {
+        return m_attackValue;
+    }
+
+    /**
+     * @brief Envelope coefficient used while the input is below the threshold
+     * @return The release coefficient
+     */
+    [[nodiscard]] auto release_coefficient() const -> S {
+        return m_releaseValue;
+    }
+
+    /**
+     * @brief Linear level the envelope is compared against
+     * @return The threshold level
+     */
+    [[nodiscard]] auto threshold_level() const -> S {
+        return m_thresholdValue;
+    }
+
+    /**
+     * @brief Current envelope
+     * @return The linear level
+     */
+    [[nodiscard]] auto envelope() const -> S { return m_envelope; }
+
+    /**
+     * @brief Whether processing a block would leave the envelope unchanged
+     * @details The envelope has to be at the fixed point of its release, and
+     * no sample may be above the threshold. Processing the block then only
+     * zeroes it if the gate is closed, see process_idle().
+     * @param samples Pointer to the samples
+     * @param count Number of samples
+     * @return True if the block is idle
+     */
+    [[nodiscard]] auto is_idle(const T *samples, const size_t count) const
+            -> bool {
+        return flush_denormal(m_releaseValue * m_envelope) == m_envelope &&
+               all_below(samples, count, m_thresholdValue);
+    }
+
+    /**
+     * @brief Processes an idle block in-place, without touching the envelope
+     * @details Bit-identical to process() for a block is_idle() accepts: a
+     * memset if the gate is closed, nothing otherwise.
+     * @param samples Pointer to the samples
+     * @param count Number of samples
+     */
+    auto process_idle(T *samples, const size_t count) const -> void {
+        if (m_envelope < m_thresholdValue) {
+            std::fill(samples, samples + count, static_cast<T>(0));
+        }
+    }
+
 private:
+    /**
+     * @brief Detect a sample and advance the envelope
+     * @param sample Sample to detect
+     * @return True if the gate is open
+     */
+    auto update_envelope(const T sample) -> bool {
+        S inputLevel = static_cast<S>(std::fabs(sample));
+        if (inputLevel > m_thresholdValue) {
+            m_envelope = m_attackValue * (m_envelope - inputLevel) + inputLevel;
+        } else {
+            m_envelope = flush_denormal(m_releaseValue * m_envelope);
+        }
+        return !(m_envelope < m_thresholdValue);
+    }
+
     /**
      * @brief Private constructor
      * @param configuration Noise gate configuration
@@ -127,20 +275,20 @@ private:
      */
     auto calculate_intermediate_values() -> void {
         m_attackValue = std::exp(
-                -1.0 / ((static_cast<T>(m_config.attack.count()) / 1000.0) *
+                -1.0 / ((static_cast<S>(m_config.attack.count()) / 1000.0) *
                         m_config.sampleRate));
         m_releaseValue = std::exp(
-                -1.0 / ((static_cast<T>(m_config.release.count()) / 1000.0) *
+                -1.0 / ((static_cast<S>(m_config.release.count()) / 1000.0) *
                         m_config.sampleRate));
     }
 
     /** Limiter configuration */
     NoiseGateConfiguration<T> m_config;
 
-    T m_attackValue = 0.0;
-    T m_releaseValue = 0.0;
-    T m_thresholdValue = 0.0;
-    T m_envelope = 0.0;
+    S m_attackValue = 0.0;
+    S m_releaseValue = 0.0;
+    S m_thresholdValue = 0.0;
+    S m_envelope = 0.0;
 };
 
 #endif // NOISE_GATE_H
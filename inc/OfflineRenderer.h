@@ -0,0 +1,265 @@
+/// OfflineRenderer.h
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef OFFLINE_RENDERER_H
+#define OFFLINE_RENDERER_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <memory_resource>
+#include <optional>
+#include <vector>
+
+#include "Denormal.h"
+
+/**
+ * @brief Offline renderer class. Runs a Limiter or Compressor non-causally
+ * over a whole signal in two passes.
+ * @details Pass one computes the per-sample target gain from the processor's
+ * static characteristic in large chunks. Pass two smooths it backward with the
+ * attack coefficient, so gain reduction ramps in before a peak instead of
+ * after it, then forward with the release coefficient. The smoothed gain never
+ * rises above the target gain, so peaks are caught with zero added latency and
+ * no overshoot.
+ *
+ * Input is streamed through a window of `chunkSize + lookahead` samples, where
+ * the lookahead is the number of samples after which the backward attack
+ * recursion has decayed below 1e-6. Memory use is therefore independent of the
+ * signal length, and multi-GB files can be rendered from chunked reads or a
+ * memory mapping. The processor is copied and its state is never touched.
+ * @tparam P Type of the processor, Limiter<T, S> or Compressor<T, S>
+ */
+template<typename P>
+class OfflineRenderer {
+public:
+    using T = typename P::sample_type;
+    using S = typename P::state_type;
+
+    /**
+     * @brief Public constructor that verifies the arguments and creates an
+     * offline renderer object
+     * @param processor Processor whose configuration is rendered
+     * @param chunkSize Number of samples written per chunk
+     * @param resource Memory resource for the streaming window
+     * @return An OfflineRenderer object if the arguments are valid,
+     * std::nullopt otherwise
+     */
+    auto static create(const P &processor, const size_t chunkSize = 65536,
+                       std::pmr::memory_resource *resource =
+                               std::pmr::get_default_resource())
+            -> std::optional<OfflineRenderer> {
+        if (chunkSize == 0 || resource == nullptr) {
+            return std::nullopt;
+        }
+        return OfflineRenderer(processor, chunkSize, resource);
+    }
+
+    /**
+     * @brief Render a stream of samples
+     * @tparam Reader Callable `size_t(T *destination, size_t maximum)` that
+     * reads up to `maximum` samples and returns how many were read, 0 at the
+     * end of the stream
+     * @tparam Writer Callable `void(const T *source, size_t count)` that
+     * receives rendered samples in order
+     * @param read Reader
+     * @param write Writer
+     * @return Number of samples rendered
+     */
+    template<typename Reader, typename Writer>
+    auto render(Reader &&read, Writer &&write) -> size_t {
+        DenormalGuard guard;
+        const size_t capacity = m_samples.size();
+        size_t total = 0;
+        size_t filled = 0;
+        bool finished = false;
+        S gain = static_cast<S>(0);
+        while (true) {
+            while (!finished && filled < capacity) {
+                const size_t count =
+                        read(m_samples.data() + filled, capacity - filled);
+                if (count == 0) {
+                    finished = true;
+                }
+                calculate_target_gains(filled, filled + count);
+                filled += count;
+            }
+            if (filled == 0) {
+                break;
+            }
+            const size_t emit = finished ? filled : m_chunkSize;
+            smooth_backward(filled);
+            gain = smooth_forward(emit, gain);
+            apply_gains(emit);
+            write(static_cast<const T *>(m_samples.data()), emit);
+            total += emit;
+
+            /// Keep the unwritten lookahead for the next window:
+            std::copy(m_samples.begin() + emit, m_samples.begin() + filled,
+                      m_samples.begin());
+            std::copy(m_targetGains.begin() + emit,
+                      m_targetGains.begin() + filled, m_targetGains.begin());
+            filled -= emit;
+        }
+        return total;
+    }
+
+    /**
+     * @brief Render an array of samples in-place, e.g. a memory-mapped file
+     * @param samples Pointer to the samples
+     * @param count Number of samples
+     */
+    auto render(T *samples, const size_t count) -> void {
+        size_t readPosition = 0;
+        size_t writePosition = 0;
+        render(
+                [&](T *destination, const size_t maximum) -> size_t {
+                    const size_t n = std::min(maximum, count - readPosition);
+                    std::copy(samples + readPosition,
+                              samples + readPosition + n, destination);
+                    readPosition += n;
+                    return n;
+                },
+                [&](const T *source, const size_t n) {
+                    std::copy(source, source + n, samples + writePosition);
+                    writePosition += n;
+                });
+    }
+
+    /**
+     * @brief Number of samples the backward pass looks ahead of each chunk
+     * @return The lookahead in samples
+     */
+    [[nodiscard]] auto lookahead() const -> size_t { return m_lookahead; }
+
+private:
+    /** Residual of the backward recursion at the end of the lookahead */
+    static constexpr double lookaheadTolerance = 1e-6;
+
+    /**
+     * @brief Private constructor
+     * @param processor Processor whose configuration is rendered
+     * @param chunkSize Number of samples written per chunk
+     * @param resource Memory resource for the streaming window
+     */
+    OfflineRenderer(const P &processor, const size_t chunkSize,
+                    std::pmr::memory_resource *resource) :
+        m_processor(processor), m_chunkSize(chunkSize),
+        m_lookahead(calculate_lookahead(processor.attack_coefficient())),
+        m_samples(chunkSize + m_lookahead, resource),
+        m_targetGains(chunkSize + m_lookahead, resource),
+        m_gains(chunkSize + m_lookahead, resource) {}
+
+    /**
+     * @brief Calculate how far the backward pass has to look ahead
+     * @param attack Attack coefficient
+     * @return The lookahead in samples
+     */
+    static auto calculate_lookahead(const S attack) -> size_t {
+        if (attack <= static_cast<S>(0)) {
+            return 1;
+        }
+        return static_cast<size_t>(std::ceil(std::log(lookaheadTolerance) /
+                                             std::log(attack))) +
+               1;
+    }
+
+    /**
+     * @brief Pass one: target gain for every sample in [begin, end)
+     * @param begin First sample
+     * @param end One past the last sample
+     */
+    auto calculate_target_gains(const size_t begin, const size_t end) -> void {
+        for (size_t i = begin; i < end; i++) {
+            m_targetGains[i] = level_decibels(m_samples[i]);
+        }
+        for (size_t i = begin; i < end; i++) {
+            m_targetGains[i] = m_processor.target_gain(m_targetGains[i]);
+        }
+    }
+
+    /**
+     * @brief Pass two, backward: ramp the gain reduction in ahead of peaks
+     * @param count Number of samples in the window
+     */
+    auto smooth_backward(const size_t count) -> void {
+        const S attack = m_processor.attack_coefficient();
+        S next = static_cast<S>(m_targetGains[count - 1]);
+        for (size_t i = count; i-- > 0;) {
+            const S target = static_cast<S>(m_targetGains[i]);
+            next = std::min(target, attack * next + (1.0 - attack) * target);
+            m_gains[i] = next;
+        }
+    }
+
+    /**
+     * @brief Pass two, forward: release the gain reduction after peaks
+     * @param count Number of samples to smooth
+     * @param gain Smoothed gain carried over from the previous chunk
+     * @return The smoothed gain at the end of the chunk
+     */
+    auto smooth_forward(const size_t count, S gain) -> S {
+        const S release = m_processor.release_coefficient();
+        for (size_t i = 0; i < count; i++) {
+            const S target = m_gains[i];
+            gain = target <= gain ? target
+                                  : release * gain + (1.0 - release) * target;
+            m_gains[i] = gain;
+        }
+        return gain;
+    }
+
+    /**
+     * @brief Apply the smoothed gain to the samples
+     * @param count Number of samples
+     */
+    auto apply_gains(const size_t count) -> void {
+        const T makeupGain = m_processor.makeup_gain();
+        for (size_t i = 0; i < count; i++) {
+            T gM = static_cast<T>(m_gains[i]) * makeupGain;
+            T gLin = std::pow(static_cast<T>(10.0), gM / static_cast<T>(20.0));
+            m_samples[i] *= gLin;
+        }
+    }
+
+    /** Processor whose configuration is rendered */
+    P m_processor;
+
+    /** Number of samples written per chunk */
+    size_t m_chunkSize = 0;
+
+    /** Number of samples the backward pass looks ahead */
+    size_t m_lookahead = 0;
+
+    /** Streaming window of input samples */
+    std::pmr::vector<T> m_samples;
+
+    /** Target gains for the window, in decibels */
+    std::pmr::vector<T> m_targetGains;
+
+    /** Smoothed gains for the window, in decibels */
+    std::pmr::vector<S> m_gains;
+};
+
+#endif // OFFLINE_RENDERER_H
@@ -0,0 +1,394 @@
+/// ParallelRenderer.h
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef PARALLEL_RENDERER_H
+#define PARALLEL_RENDERER_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <memory_resource>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "Denormal.h"
+
+/**
+ * @brief Parallel renderer class. Runs the serial envelope recursion of a
+ * processor over one long signal on several threads.
+ * @details The signal is split into one chunk per thread and processed in
+ * three phases:
+ *
+ * 1. In parallel, each chunk is analysed from a guessed start state.
+ * 2. Serially, the true start state of every chunk is stitched from the end
+ *    state of the chunk before it.
+ * 3. In parallel, gains are applied.
+ *
+ * For the NoiseGate the attack/release choice depends only on the input, so
+ * every sample is an affine map of the envelope. Phase one composes those maps
+ * per chunk and phase two is an exact prefix over them. Runs of samples below
+ * the threshold are pure geometric decay and are evaluated as a blocked scan
+ * against a table of release powers, which vectorizes.
+ *
+ * For the Limiter, Compressor and Expander the attack/release choice depends on
+ * the state itself, so the recursion is not affine. It is, however, a
+ * contraction: two trajectories over the same input can only get closer.
+ * Phase one computes target gains, then smooths each chunk from a state warmed
+ * up over the tail of the previous chunk. Phase two re-runs the start of each
+ * chunk from the true state only until it agrees with the guessed trajectory
+ * within tolerance, after which the rest of the chunk is already correct.
+ *
+ * State is carried between calls, so a long file can be rendered block by
+ * block. The result matches serial processing from a freshly reset processor
+ * within floating-point tolerance. Scratch buffers come from the supplied
+ * memory resource and grow to the largest block rendered.
+ * @tparam P Type of the processor, Limiter, Compressor, Expander or NoiseGate
+ */
+template<typename P>
+class ParallelRenderer {
+public:
+    using T = typename P::sample_type;
+    using S = typename P::state_type;
+
+    /**
+     * @brief Public constructor that verifies the arguments and creates a
+     * parallel renderer object
+     * @param processor Processor whose configuration is rendered
+     * @param threads Number of threads, 0 for the hardware concurrency
+     * @param resource Memory resource for the scratch buffers
+     * @return A ParallelRenderer object if the arguments are valid,
+     * std::nullopt otherwise
+     */
+    auto static create(const P &processor, size_t threads = 0,
+                       std::pmr::memory_resource *resource =
+                               std::pmr::get_default_resource())
+            -> std::optional<ParallelRenderer> {
+        if (resource == nullptr) {
+            return std::nullopt;
+        }
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        return ParallelRenderer(processor, threads, resource);
+    }
+
+    /**
+     * @brief Render an array of samples in-place, continuing from the state
+     * left by the previous call
+     * @param samples Pointer to the samples
+     * @param count Number of samples
+     */
+    auto render(T *samples, const size_t count) -> void {
+        if (count == 0) {
+            return;
+        }
+        DenormalGuard guard;
+        const size_t chunks = std::min(m_threads, count);
+        m_bounds.resize(chunks + 1);
+        for (size_t j = 0; j <= chunks; j++) {
+            m_bounds[j] = count * j / chunks;
+        }
+        if constexpr (noise_gate) {
+            render_envelope(samples, chunks);
+        } else {
+            render_gain(samples, count, chunks);
+        }
+    }
+
+    /**
+     * @brief Resets the carried state to that of a freshly reset processor
+     */
+    auto reset() -> void { m_state = static_cast<S>(0); }
+
+    /**
+     * @brief State carried to the next call
+     * @return The envelope for a NoiseGate, the smoothed gain in decibels
+     * otherwise
+     */
+    [[nodiscard]] auto state() const -> S { return m_state; }
+
+private:
+    /** Whether P is a NoiseGate, whose recursion is affine */
+    static constexpr bool noise_gate =
+            requires(const P &processor) { processor.threshold_level(); };
+
+    /** Length of the release power table used by the blocked scan */
+    static constexpr size_t scanBlock = 64;
+
+    /** Agreement required before the fix-up pass stops re-running a chunk */
+    static constexpr double tolerance = 1e-9;
+
+    /**
+     * @brief Affine map of the envelope, state -> scale * state + offset
+     */
+    struct Affine {
+        S scale = static_cast<S>(1);
+        S offset = static_cast<S>(0);
+    };
+
+    /**
+     * @brief Private constructor
+     * @param processor Processor whose configuration is rendered
+     * @param threads Number of threads
+     * @param resource Memory resource for the scratch buffers
+     */
+    ParallelRenderer(const P &processor, const size_t threads,
+                     std::pmr::memory_resource *resource) :
+        m_processor(processor), m_threads(threads), m_bounds(resource),
+        m_maps(resource), m_targetGains(resource), m_gains(resource) {
+        if constexpr (noise_gate) {
+            m_releasePowers[0] = static_cast<S>(1);
+            for (size_t k = 1; k <= scanBlock; k++) {
+                m_releasePowers[k] = m_releasePowers[k - 1] *
+                                     processor.release_coefficient();
+            }
+        } else {
+            /// A coefficient that rounds to 1 in S never contracts, so every
+            /// chunk then warms up over the whole block before it:
+            const S contraction = std::max(processor.attack_coefficient(),
+                                           processor.release_coefficient());
+            m_warmup = contraction < static_cast<S>(1)
+                               ? std::ceil(std::log(tolerance) /
+                                           std::log(contraction))
+                               : std::numeric_limits<double>::infinity();
+        }
+    }
+
+    /**
+     * @brief Run a function over every chunk, one thread per chunk, each under
+     * its own DenormalGuard since the floating-point mode is per thread
+     * @param chunks Number of chunks
+     * @param function Callable taking the chunk index
+     */
+    template<typename Function>
+    static auto parallel_for(const size_t chunks, Function &&function)
+            -> void {
+        std::vector<std::thread> workers;
+        workers.reserve(chunks - 1);
+        for (size_t j = 1; j < chunks; j++) {
+            workers.emplace_back([&function, j]() {
+                DenormalGuard guard;
+                function(j);
+            });
+        }
+        function(size_t{0});
+        for (std::thread &worker: workers) {
+            worker.join();
+        }
+    }
+
+    /**
+     * @brief Length of the run of samples at or below the gate threshold
+     * @param samples Pointer to the samples
+     * @param begin First sample of the run
+     * @param end One past the last sample that may be in the run
+     * @return Number of samples in the run
+     */
+    auto release_run(const T *samples, const size_t begin,
+                     const size_t end) const -> size_t {
+        const S threshold = m_processor.threshold_level();
+        size_t i = begin;
+        while (i < end &&
+               !(static_cast<S>(std::fabs(samples[i])) > threshold)) {
+            i++;
+        }
+        return i - begin;
+    }
+
+    /**
+     * @brief Release coefficient raised to the power of a run length
+     * @param length Run length
+     * @return The release power
+     */
+    auto release_power(size_t length) const -> S {
+        S power = static_cast<S>(1);
+        for (; length >= scanBlock; length -= scanBlock) {
+            power *= m_releasePowers[scanBlock];
+        }
+        return power * m_releasePowers[length];
+    }
+
+    /**
+     * @brief NoiseGate path: compose per-chunk affine maps, prefix them, then
+     * gate every chunk from its exact start envelope
+     * @param samples Pointer to the samples
+     * @param chunks Number of chunks
+     */
+    auto render_envelope(T *samples, const size_t chunks) -> void {
+        const S attack = m_processor.attack_coefficient();
+        const S threshold = m_processor.threshold_level();
+        m_maps.resize(chunks);
+
+        parallel_for(chunks, [&](const size_t j) {
+            Affine map;
+            for (size_t i = m_bounds[j]; i < m_bounds[j + 1];) {
+                const size_t run = release_run(samples, i, m_bounds[j + 1]);
+                if (run > 0) {
+                    const S power = release_power(run);
+                    map.scale *= power;
+                    map.offset *= power;
+                    i += run;
+                    continue;
+                }
+                const S level = static_cast<S>(std::fabs(samples[i]));
+                map.scale *= attack;
+                map.offset = attack * map.offset + (1.0 - attack) * level;
+                i++;
+            }
+            m_maps[j] = map;
+        });
+
+        /// Exact prefix over the chunk maps, leaving each chunk's start state
+        S envelope = m_state;
+        for (size_t j = 0; j < chunks; j++) {
+            const Affine map = m_maps[j];
+            m_maps[j].offset = envelope;
+            envelope = map.scale * envelope + map.offset;
+        }
+        m_state = envelope;
+
+        parallel_for(chunks, [&](const size_t j) {
+            S state = m_maps[j].offset;
+            for (size_t i = m_bounds[j]; i < m_bounds[j + 1];) {
+                size_t run = release_run(samples, i, m_bounds[j + 1]);
+                i += run;
+                for (T *block = samples + i - run; run > 0;) {
+                    const size_t length = std::min(run, scanBlock);
+                    for (size_t k = 0; k < length; k++) {
+                        const S decayed = state * m_releasePowers[k + 1];
+                        block[k] = decayed < threshold ? static_cast<T>(0)
+                                                       : block[k];
+                    }
+                    state *= m_releasePowers[length];
+                    block += length;
+                    run -= length;
+                }
+                if (i == m_bounds[j + 1]) {
+                    break;
+                }
+                const S level = static_cast<S>(std::fabs(samples[i]));
+                state = attack * (state - level) + level;
+                if (state < threshold) {
+                    samples[i] = static_cast<T>(0);
+                }
+                i++;
+            }
+        });
+    }
+
+    /**
+     * @brief Limiter, Compressor and Expander path: smooth every chunk from a
+     * warmed-up guess, fix up chunk starts serially, then apply gains
+     * @param samples Pointer to the samples
+     * @param count Number of samples
+     * @param chunks Number of chunks
+     */
+    auto render_gain(T *samples, const size_t count, const size_t chunks)
+            -> void {
+        m_targetGains.resize(count);
+        m_gains.resize(count);
+
+        parallel_for(chunks, [&](const size_t j) {
+            for (size_t i = m_bounds[j]; i < m_bounds[j + 1]; i++) {
+                T inputDecibels = level_decibels(samples[i]);
+                m_targetGains[i] = static_cast<S>(
+                        m_processor.target_gain(inputDecibels));
+            }
+        });
+
+        parallel_for(chunks, [&](const size_t j) {
+            const size_t begin = m_bounds[j];
+            /// Chunks whose warm-up reaches the start of the block start from
+            /// the carried state, the others from a fresh one
+            const size_t warmup = static_cast<size_t>(
+                    std::min(m_warmup, static_cast<double>(begin)));
+            S state = warmup == begin ? m_state : static_cast<S>(0);
+            if (j > 0) {
+                for (size_t i = begin - warmup; i < begin; i++) {
+                    state = m_processor.smooth_gain(state, m_targetGains[i]);
+                }
+            }
+            for (size_t i = begin; i < m_bounds[j + 1]; i++) {
+                state = m_processor.smooth_gain(state, m_targetGains[i]);
+                m_gains[i] = state;
+            }
+        });
+
+        for (size_t j = 1; j < chunks; j++) {
+            S state = m_gains[m_bounds[j] - 1];
+            for (size_t i = m_bounds[j]; i < m_bounds[j + 1]; i++) {
+                state = m_processor.smooth_gain(state, m_targetGains[i]);
+                const bool converged =
+                        std::fabs(state - m_gains[i]) <= tolerance;
+                m_gains[i] = state;
+                if (converged) {
+                    break;
+                }
+            }
+        }
+        m_state = m_gains[count - 1];
+
+        const T makeupGain = m_processor.makeup_gain();
+        parallel_for(chunks, [&](const size_t j) {
+            for (size_t i = m_bounds[j]; i < m_bounds[j + 1]; i++) {
+                T gM = static_cast<T>(m_gains[i]) * makeupGain;
+                T gLin = std::pow(10.0, gM / 20.0);
+                samples[i] *= gLin;
+            }
+        });
+    }
+
+    /** Processor whose configuration is rendered */
+    P m_processor;
+
+    /** Number of threads */
+    size_t m_threads = 1;
+
+    /** Envelope or smoothed gain carried between calls */
+    S m_state = static_cast<S>(0);
+
+    /** Samples of warm-up before each chunk's guessed start state, infinite
+     * if the smoothing does not contract */
+    double m_warmup = 0.0;
+
+    /** Release coefficient powers 0 through scanBlock */
+    std::array<S, scanBlock + 1> m_releasePowers{};
+
+    /** Chunk boundaries */
+    std::pmr::vector<size_t> m_bounds;
+
+    /** Per-chunk affine maps, then per-chunk start envelopes */
+    std::pmr::vector<Affine> m_maps;
+
+    /** Target gains in decibels */
+    std::pmr::vector<S> m_targetGains;
+
+    /** Smoothed gains in decibels */
+    std::pmr::vector<S> m_gains;
+};
+
+#endif // PARALLEL_RENDERER_H
@@ -0,0 +1,178 @@
+#ifndef PARAMETER_EVENT_H
+#define PARAMETER_EVENT_H
+
+#include <array>
+#include <cstddef>
+#include <span>
+
+/**
+ * @brief Parameters that can be automated with sample accuracy
+ */
+enum class Parameter {
+    /** Threshold in decibels */
+    Threshold,
+
+    /** Ratio */
+    Ratio,
+
+    /** Makeup gain in decibels */
+    MakeupGain,
+
+    /** Knee width in decibels */
+    KneeWidth
+};
+
+/**
+ * @brief A timestamped parameter change within a block
+ * @tparam T Type of the processor
+ */
+template<typename T = double>
+struct ParameterEvent {
+    /** Sample offset within the block at which the change starts */
+    std::size_t offset = 0;
+
+    /** Parameter to change */
+    Parameter parameter = Parameter::Threshold;
+
+    /** Target value, in the parameter's own unit */
+    T value = static_cast<T>(0);
+
+    /** Number of samples to ramp over, 0 for an immediate change */
+    std::size_t rampLength = 0;
+};
+
+/**
+ * @brief Applies timestamped parameter events to a processor while running
+ * its block kernel on the segments between them
+ * @details Immediate changes are written at their exact sample offset and the
+ * block kernel is resumed on the following segment. Ramped changes are
+ * interpolated linearly per sample, which for the decibel-valued parameters is
+ * a linear ramp in the dB domain; ramps that outlast a block carry over into
+ * the next one. Attack and release are not automatable, so no coefficients are
+ * recomputed while events are applied.
+ * @tparam T Type of the processor
+ */
+template<typename T = double>
+class ParameterAutomation {
+public:
+    /**
+     * @brief Process a block of samples in-place while applying events
+     * @tparam Resolve Callable mapping a Parameter to a T* into the processor
+     * configuration, or nullptr if the processor does not have it
+     * @tparam Kernel Callable processing (T*, size_t) in-place
+     * @param samples Pointer to the samples
+     * @param count Number of samples
+     * @param events Events sorted by offset. Events at or past `count` are
+     * ignored
+     * @param resolve Parameter resolver
+     * @param kernel Block kernel
+     */
+    template<typename Resolve, typename Kernel>
+    auto process(T *samples, const std::size_t count,
+                 std::span<const ParameterEvent<T>> events, Resolve &&resolve,
+                 Kernel &&kernel) -> void {
+        std::size_t position = 0;
+        std::size_t next = 0;
+        while (position < count) {
+            while (next < events.size() && events[next].offset <= position) {
+                start(events[next], resolve);
+                next++;
+            }
+            std::size_t end = count;
+            if (next < events.size() && events[next].offset < count) {
+                end = events[next].offset;
+            }
+            if (m_activeRamps == 0) {
+                kernel(samples + position, end - position);
+                position = end;
+                continue;
+            }
+            for (; position < end && m_activeRamps > 0; position++) {
+                step(resolve);
+                kernel(samples + position, 1);
+            }
+        }
+    }
+
+    /**
+     * @brief Cancels every ramp in progress, leaving parameters where they are
+     */
+    auto cancel() -> void {
+        for (Ramp &ramp: m_ramps) {
+            ramp.remaining = 0;
+        }
+        m_activeRamps = 0;
+    }
+
+private:
+    /**
+     * @brief A linear ramp towards a target value
+     */
+    struct Ramp {
+        /** Value reached at the end of the ramp */
+        T target = static_cast<T>(0);
+
+        /** Change per sample */
+        T increment = static_cast<T>(0);
+
+        /** Samples left in the ramp */
+        std::size_t remaining = 0;
+    };
+
+    /**
+     * @brief Starts an event, either writing it or setting up a ramp
+     * @param event Event to start
+     * @param resolve Parameter resolver
+     */
+    template<typename Resolve>
+    auto start(const ParameterEvent<T> &event, Resolve &resolve) -> void {
+        T *value = resolve(event.parameter);
+        if (value == nullptr) {
+            return;
+        }
+        Ramp &ramp = m_ramps[static_cast<std::size_t>(event.parameter)];
+        if (ramp.remaining > 0) {
+            m_activeRamps--;
+        }
+        if (event.rampLength == 0) {
+            ramp.remaining = 0;
+            *value = event.value;
+            return;
+        }
+        ramp.target = event.value;
+        ramp.increment =
+                (event.value - *value) / static_cast<T>(event.rampLength);
+        ramp.remaining = event.rampLength;
+        m_activeRamps++;
+    }
+
+    /**
+     * @brief Advances every active ramp by one sample
+     * @param resolve Parameter resolver
+     */
+    template<typename Resolve>
+    auto step(Resolve &resolve) -> void {
+        for (std::size_t i = 0; i < m_ramps.size(); i++) {
+            Ramp &ramp = m_ramps[i];
+            if (ramp.remaining == 0) {
+                continue;
+            }
+            T *value = resolve(static_cast<Parameter>(i));
+            ramp.remaining--;
+            if (ramp.remaining == 0) {
+                *value = ramp.target;
+                m_activeRamps--;
+            } else {
+                *value += ramp.increment;
+            }
+        }
+    }
+
+    /** One ramp slot per parameter */
+    std::array<Ramp, 4> m_ramps{};
+
+    /** Number of ramps in progress */
+    std::size_t m_activeRamps = 0;
+};
+
+#endif // PARAMETER_EVENT_H
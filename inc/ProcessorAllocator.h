@@ -0,0 +1,260 @@
+/// ProcessorAllocator.h
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef PROCESSOR_ALLOCATOR_H
+#define PROCESSOR_ALLOCATOR_H
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <optional>
+#include <utility>
+
+/**
+ * @brief Deleter that destroys a processor and returns its storage to the
+ * memory resource it was allocated from
+ * @tparam P Type of the processor
+ */
+template<typename P>
+class ResourceDeleter {
+public:
+    ResourceDeleter() = default;
+
+    /**
+     * @brief Constructor
+     * @param resource Memory resource that owns the storage
+     * @param alignment Alignment the storage was allocated with
+     */
+    ResourceDeleter(std::pmr::memory_resource *resource,
+                    const std::size_t alignment) :
+        m_resource(resource), m_alignment(alignment) {}
+
+    /**
+     * @brief Destroys the processor and deallocates its storage
+     * @param processor Processor to destroy
+     */
+    auto operator()(P *processor) const -> void {
+        processor->~P();
+        m_resource->deallocate(processor, sizeof(P), m_alignment);
+    }
+
+private:
+    /** Memory resource that owns the storage */
+    std::pmr::memory_resource *m_resource = nullptr;
+
+    /** Alignment the storage was allocated with */
+    std::size_t m_alignment = alignof(P);
+};
+
+/**
+ * @brief Owning pointer to a processor living in a caller-supplied memory
+ * resource
+ * @tparam P Type of the processor
+ */
+template<typename P>
+using ResourcePtr = std::unique_ptr<P, ResourceDeleter<P>>;
+
+/**
+ * @brief Rounds an alignment request up to something valid for the processor
+ * @tparam P Type of the processor
+ * @param alignment Requested alignment, must be a power of two
+ * @return The requested alignment, or alignof(P) if that is larger
+ */
+template<typename P>
+constexpr auto processor_alignment(const std::size_t alignment)
+        -> std::size_t {
+    return alignment < alignof(P) ? alignof(P) : alignment;
+}
+
+/**
+ * @brief Creates a processor inside a caller-supplied memory resource
+ * @details The configuration is validated with the processor's own `create`
+ * function, so an invalid configuration never touches the resource. This makes
+ * it possible to place processors in an arena (for example a
+ * std::pmr::monotonic_buffer_resource over memory bound to a NUMA node)
+ * instead of the global heap.
+ * @tparam P Type of the processor, e.g. Compressor<float>
+ * @tparam C Type of the processor configuration
+ * @param resource Memory resource to allocate the processor from
+ * @param configuration Processor configuration
+ * @param alignment Alignment of the processor storage, must be a power of two
+ * @return A ResourcePtr to the processor if the configuration is valid, nullptr
+ * otherwise
+ */
+template<typename P, typename C>
+auto create_in(std::pmr::memory_resource *resource, C configuration,
+               std::size_t alignment = alignof(P)) -> ResourcePtr<P> {
+    std::optional<P> processor = P::create(configuration);
+    if (!processor.has_value() || resource == nullptr) {
+        return nullptr;
+    }
+    alignment = processor_alignment<P>(alignment);
+    void *storage = resource->allocate(sizeof(P), alignment);
+    P *placed = ::new (storage) P(std::move(*processor));
+    return ResourcePtr<P>(placed, ResourceDeleter<P>(resource, alignment));
+}
+
+/**
+ * @brief A fixed-size bank of identically configured processors stored
+ * contiguously in a single allocation from a caller-supplied memory resource
+ * @details Each processor starts on its own `alignment` boundary, so with the
+ * default of 64 bytes two instances never share a cache line and banks can be
+ * split across threads without false sharing. Creating or destroying a bank is
+ * a single allocate/deallocate call on the resource.
+ * @tparam P Type of the processor
+ */
+template<typename P>
+class ProcessorBank {
+public:
+    /**
+     * @brief Public constructor that verifies the configuration and creates a
+     * bank of processors
+     * @tparam C Type of the processor configuration
+     * @param resource Memory resource to allocate the bank from
+     * @param count Number of processors in the bank
+     * @param configuration Configuration shared by every processor
+     * @param alignment Alignment of each processor, must be a power of two
+     * @return A ProcessorBank if the configuration is valid, std::nullopt
+     * otherwise
+     */
+    template<typename C>
+    auto static create(std::pmr::memory_resource *resource,
+                       const std::size_t count, C configuration,
+                       std::size_t alignment = 64)
+            -> std::optional<ProcessorBank> {
+        std::optional<P> prototype = P::create(configuration);
+        if (!prototype.has_value() || resource == nullptr || count == 0) {
+            return std::nullopt;
+        }
+        return ProcessorBank(resource, count, *prototype,
+                             processor_alignment<P>(alignment));
+    }
+
+    ProcessorBank(const ProcessorBank &) = delete;
+    auto operator=(const ProcessorBank &) -> ProcessorBank & = delete;
+
+    ProcessorBank(ProcessorBank &&other) noexcept :
+        m_resource(std::exchange(other.m_resource, nullptr)),
+        m_storage(std::exchange(other.m_storage, nullptr)),
+        m_count(std::exchange(other.m_count, 0)), m_stride(other.m_stride),
+        m_alignment(other.m_alignment) {}
+
+    auto operator=(ProcessorBank &&other) noexcept -> ProcessorBank & {
+        if (this != &other) {
+            release();
+            m_resource = std::exchange(other.m_resource, nullptr);
+            m_storage = std::exchange(other.m_storage, nullptr);
+            m_count = std::exchange(other.m_count, 0);
+            m_stride = other.m_stride;
+            m_alignment = other.m_alignment;
+        }
+        return *this;
+    }
+
+    ~ProcessorBank() { release(); }
+
+    /**
+     * @brief Access a processor in the bank
+     * @param index Index of the processor
+     * @return Reference to the processor
+     */
+    auto operator[](const std::size_t index) -> P & {
+        return *std::launder(
+                reinterpret_cast<P *>(m_storage + index * m_stride));
+    }
+
+    /**
+     * @brief Access a processor in the bank
+     * @param index Index of the processor
+     * @return Const reference to the processor
+     */
+    auto operator[](const std::size_t index) const -> const P & {
+        return *std::launder(
+                reinterpret_cast<const P *>(m_storage + index * m_stride));
+    }
+
+    /**
+     * @brief Number of processors in the bank
+     * @return The number of processors
+     */
+    [[nodiscard]] auto size() const -> std::size_t { return m_count; }
+
+    /**
+     * @brief Distance in bytes between consecutive processors
+     * @return The stride in bytes
+     */
+    [[nodiscard]] auto stride() const -> std::size_t { return m_stride; }
+
+private:
+    /**
+     * @brief Private constructor
+     * @param resource Memory resource to allocate the bank from
+     * @param count Number of processors in the bank
+     * @param prototype Validated processor every slot is copied from
+     * @param alignment Alignment of each processor
+     */
+    ProcessorBank(std::pmr::memory_resource *resource, const std::size_t count,
+                  const P &prototype, const std::size_t alignment) :
+        m_resource(resource), m_count(count),
+        m_stride((sizeof(P) + alignment - 1) / alignment * alignment),
+        m_alignment(alignment) {
+        m_storage = static_cast<std::byte *>(
+                m_resource->allocate(m_stride * m_count, m_alignment));
+        for (std::size_t i = 0; i < m_count; i++) {
+            ::new (m_storage + i * m_stride) P(prototype);
+        }
+    }
+
+    /**
+     * @brief Destroys every processor and returns the storage to the resource
+     */
+    auto release() -> void {
+        if (m_storage == nullptr) {
+            return;
+        }
+        for (std::size_t i = 0; i < m_count; i++) {
+            (*this)[i].~P();
+        }
+        m_resource->deallocate(m_storage, m_stride * m_count, m_alignment);
+        m_storage = nullptr;
+    }
+
+    /** Memory resource that owns the storage */
+    std::pmr::memory_resource *m_resource = nullptr;
+
+    /** Start of the bank storage */
+    std::byte *m_storage = nullptr;
+
+    /** Number of processors in the bank */
+    std::size_t m_count = 0;
+
+    /** Distance in bytes between consecutive processors */
+    std::size_t m_stride = 0;
+
+    /** Alignment of each processor */
+    std::size_t m_alignment = alignof(P);
+};
+
+#endif // PROCESSOR_ALLOCATOR_H
@@ -0,0 +1,624 @@
+/// QualityTier.h
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef QUALITY_TIER_H
+#define QUALITY_TIER_H
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "Denormal.h"
+
+/**
+ * @brief Processing quality, from the most accurate to the cheapest
+ */
+enum class QualityTier {
+    /** Exact per-sample level detection and gain, as the processor itself */
+    Exact,
+
+    /** Per-sample gain with fast approximations of log10 and pow */
+    Fast,
+
+    /** One gain per control interval, interpolated linearly in between */
+    ControlRate
+};
+
+/**
+ * @brief Fast approximation of level_decibels()
+ * @details Splits the magnitude into a power of two and a mantissa in
+ * [sqrt(1/2), sqrt(2)), whose logarithm is a short odd series. The magnitude
+ * is clamped exactly like level_decibels(). Within 1e-4 dB of it.
+ * @tparam T Type of the sample
+ * @param sample Sample
+ * @return The level in decibels
+ */
+template<typename T>
+auto fast_level_decibels(const T sample) -> T {
+    constexpr float floor = 1e-10f;
+    constexpr float ceiling = 1e10f;
+    float magnitude = std::fabs(static_cast<float>(sample));
+    if (!(magnitude > floor)) {
+        magnitude = floor;
+    } else if (magnitude > ceiling) {
+        magnitude = ceiling;
+    }
+    /// Exponent relative to sqrt(1/2), so the mantissa is centred on 1:
+    constexpr uint32_t centre = std::bit_cast<uint32_t>(0.70710678f);
+    const uint32_t bits = std::bit_cast<uint32_t>(magnitude);
+    const int32_t exponent = static_cast<int32_t>(bits - centre) >> 23;
+    const float mantissa = std::bit_cast<float>(
+            bits - (static_cast<uint32_t>(exponent) << 23));
+    /// ln(m) = 2 atanh(t), t = (m - 1) / (m + 1), |t| < 0.172:
+    const float t = (mantissa - 1.0f) / (mantissa + 1.0f);
+    const float t2 = t * t;
+    const float ln = 2.0f * t * (1.0f + t2 * (1.0f / 3.0f + t2 * 0.2f));
+    /// 20 log10(2) and 20 / ln(10):
+    return static_cast<T>(6.0205999f * static_cast<float>(exponent) +
+                          8.6858896f * ln);
+}
+
+/**
+ * @brief Fast approximation of `pow(10, decibels / 20)`
+ * @details Rounds the base-2 exponent to an integer, which goes straight into
+ * the exponent bits, and evaluates the remaining factor with a degree 5
+ * polynomial. Gains are clamped to the normal float range. Within 1e-5 of the
+ * exact gain, relative, limited by the float argument.
+ * @tparam T Type of the gain
+ * @param decibels Gain in decibels
+ * @return The linear gain
+ */
+template<typename T>
+auto fast_decibels_to_gain(const T decibels) -> T {
+    /// log2(10) / 20:
+    float y = static_cast<float>(decibels) * 0.16609640f;
+    y = std::clamp(y, -126.0f, 127.0f);
+    /// Round to nearest by truncating a positive value, without a libm call:
+    const float n =
+            static_cast<float>(static_cast<int32_t>(y + 127.5f) - 127);
+    /// e^z with z = (y - n) ln(2), |z| <= 0.347:
+    const float z = (y - n) * 0.69314718f;
+    const float p =
+            1.0f +
+            z * (1.0f +
+                 z * 0.5f *
+                         (1.0f +
+                          z * (1.0f / 3.0f) *
+                                  (1.0f + z * 0.25f * (1.0f + z * 0.2f))));
+    const float scale = std::bit_cast<float>(
+            static_cast<uint32_t>(static_cast<int32_t>(n) + 127) << 23);
+    return static_cast<T>(scale * p);
+}
+
+/**
+ * @brief Tiered processor class. Runs a Limiter, Compressor, Expander or
+ * NoiseGate at a quality tier that can be changed at runtime.
+ * @details The processor is only read, for its configuration and
+ * coefficients, through its public gain computer and smoothing API; the
+ * smoothing state lives here and is shared by every tier. At the Exact tier
+ * the output is bit-identical to the processor's own. The Fast tier replaces
+ * the per-sample log10 and pow with fast_level_decibels() and
+ * fast_decibels_to_gain(). The ControlRate tier detects the peak of each
+ * control interval, advances the smoothing over the whole interval in closed
+ * form and ramps the linear gain across it, so it costs one log10 and one pow
+ * per interval.
+ *
+ * set_tier() takes effect at the next block. Every tier keeps the last linear
+ * gain it applied, and the ControlRate tier ramps from it, so switching in
+ * either direction does not step the gain. The single sample overload always
+ * runs at the Exact tier.
+ * @tparam P Type of the processor
+ */
+template<typename P>
+class TieredProcessor {
+public:
+    /** Type of the input and output samples */
+    using sample_type = typename P::sample_type;
+
+    /** Type of the gain smoothing state and coefficients */
+    using state_type = typename P::state_type;
+
+    using T = sample_type;
+    using S = state_type;
+
+    /**
+     * @brief Public constructor that creates a tiered processor object
+     * @param processor Processor providing the configuration
+     * @param controlInterval Samples per gain update at the ControlRate tier
+     * @param resource Memory resource for the coefficient tables
+     * @return A TieredProcessor object if the arguments are valid,
+     * std::nullopt otherwise
+     */
+    auto static create(const P &processor, const size_t controlInterval = 16,
+                       std::pmr::memory_resource *resource =
+                               std::pmr::get_default_resource())
+            -> std::optional<TieredProcessor> {
+        if (controlInterval == 0 || resource == nullptr) {
+            return std::nullopt;
+        }
+        return TieredProcessor(processor, controlInterval, resource);
+    }
+
+    /**
+     * @brief Process a sample in-place at the Exact tier
+     * @param sample Sample to process
+     */
+    auto process(T &sample) -> void {
+        if constexpr (noise_gate) {
+            S inputLevel = static_cast<S>(std::fabs(sample));
+            if (inputLevel > m_processor.threshold_level()) {
+                m_state = m_processor.attack_coefficient() *
+                                  (m_state - inputLevel) +
+                          inputLevel;
+            } else {
+                m_state = flush_denormal(m_processor.release_coefficient() *
+                                         m_state);
+            }
+            m_gain = gate_gain();
+            if (m_state < m_processor.threshold_level()) {
+                sample = static_cast<T>(0);
+            }
+        } else {
+            T inputDecibels = level_decibels(sample);
+            S gC = static_cast<S>(m_processor.target_gain(inputDecibels));
+            m_state = m_processor.smooth_gain(m_state, gC);
+            T gM = static_cast<T>(m_state) * m_processor.makeup_gain();
+            T gLin = std::pow(10.0, gM / 20.0);
+            m_gain = gLin;
+            sample *= gLin;
+        }
+    }
+
+    /**
+     * @brief Processes an array of samples in-place at the current tier
+     * @param samples Pointer to the samples
+     * @param count Number of samples
+     */
+    auto process(T *samples, const size_t count) -> void {
+        DenormalGuard guard;
+        m_tier = m_requested;
+        switch (m_tier) {
+            case QualityTier::Exact:
+                for (size_t i = 0; i < count; i++) {
+                    process(samples[i]);
+                }
+                return;
+            case QualityTier::Fast:
+                process_fast(samples, count);
+                return;
+            case QualityTier::ControlRate:
+                for (size_t i = 0; i < count; i += m_controlInterval) {
+                    process_interval(samples + i,
+                                     std::min(m_controlInterval, count - i));
+                }
+                return;
+        }
+    }
+
+    /**
+     * @brief Processes a contiguous span of samples in-place at the current
+     * tier
+     * @param samples Span of samples
+     */
+    auto process(std::span<T> samples) -> void {
+        process(samples.data(), samples.size());
+    }
+
+    /**
+     * @brief Request a quality tier, which takes effect at the next block
+     * @param tier Quality tier
+     */
+    auto set_tier(const QualityTier tier) -> void { m_requested = tier; }
+
+    /**
+     * @brief The quality tier of the next block
+     * @return The requested tier
+     */
+    [[nodiscard]] auto tier() const -> QualityTier { return m_requested; }
+
+    /**
+     * @brief Resets the smoothing state
+     */
+    auto reset() -> void {
+        m_state = static_cast<S>(0);
+        m_gain = static_cast<T>(1);
+    }
+
+    /**
+     * @brief The processor providing the configuration
+     * @return The processor, read-only
+     */
+    [[nodiscard]] auto processor() const -> const P & { return m_processor; }
+
+private:
+    /** Whether P is a NoiseGate, whose state is an envelope */
+    static constexpr bool noise_gate =
+            requires(const P &processor) { processor.threshold_level(); };
+
+    /**
+     * @brief Private constructor
+     * @param processor Processor providing the configuration
+     * @param controlInterval Samples per gain update at the ControlRate tier
+     * @param resource Memory resource for the coefficient tables
+     */
+    TieredProcessor(const P &processor, const size_t controlInterval,
+                    std::pmr::memory_resource *resource) :
+        m_processor(processor), m_controlInterval(controlInterval),
+        m_attackPowers(controlInterval + 1, resource),
+        m_releasePowers(controlInterval + 1, resource) {
+        /// Coefficient to the power of every possible interval length:
+        m_attackPowers[0] = static_cast<S>(1);
+        m_releasePowers[0] = static_cast<S>(1);
+        for (size_t n = 1; n <= controlInterval; n++) {
+            m_attackPowers[n] =
+                    m_attackPowers[n - 1] * m_processor.attack_coefficient();
+            m_releasePowers[n] =
+                    m_releasePowers[n - 1] * m_processor.release_coefficient();
+        }
+    }
+
+    /**
+     * @brief Linear gain of the NoiseGate for the current envelope
+     * @return 0 while the gate is closed, 1 otherwise
+     */
+    [[nodiscard]] auto gate_gain() const -> T {
+        return m_state < m_processor.threshold_level() ? static_cast<T>(0)
+                                                       : static_cast<T>(1);
+    }
+
+    /**
+     * @brief Fast tier kernel
+     * @param samples Pointer to the samples
+     * @param count Number of samples
+     */
+    auto process_fast(T *samples, const size_t count) -> void {
+        if constexpr (noise_gate) {
+            /// The gate has no log10 or pow to approximate:
+            for (size_t i = 0; i < count; i++) {
+                process(samples[i]);
+            }
+        } else {
+            const T makeupGain = m_processor.makeup_gain();
+            for (size_t i = 0; i < count; i++) {
+                T inputDecibels = fast_level_decibels(samples[i]);
+                S gC = static_cast<S>(m_processor.target_gain(inputDecibels));
+                m_state = m_processor.smooth_gain(m_state, gC);
+                m_gain = fast_decibels_to_gain(static_cast<T>(m_state) *
+                                               makeupGain);
+                samples[i] *= m_gain;
+            }
+        }
+    }
+
+    /**
+     * @brief ControlRate tier kernel for one control interval
+     * @param samples Pointer to the samples of the interval
+     * @param length Number of samples, at most the control interval
+     */
+    auto process_interval(T *samples, const size_t length) -> void {
+        T peak = static_cast<T>(0);
+        for (size_t i = 0; i < length; i++) {
+            const T magnitude = std::fabs(samples[i]);
+            peak = magnitude > peak ? magnitude : peak;
+        }
+        T target;
+        if constexpr (noise_gate) {
+            /// The envelope recursion with a constant input, in closed form:
+            const S inputLevel = static_cast<S>(peak);
+            if (inputLevel > m_processor.threshold_level()) {
+                m_state = m_attackPowers[length] * (m_state - inputLevel) +
+                          inputLevel;
+            } else {
+                m_state = flush_denormal(m_releasePowers[length] * m_state);
+            }
+            target = gate_gain();
+        } else {
+            /// The smoothing recursion with a constant target, in closed form:
+            T inputDecibels = level_decibels(peak);
+            S gC = static_cast<S>(m_processor.target_gain(inputDecibels));
+            const S alpha = m_processor.smoothing_coefficient(m_state, gC) ==
+                                            m_processor.attack_coefficient()
+                                    ? m_attackPowers[length]
+                                    : m_releasePowers[length];
+            m_state = flush_denormal<S>(alpha * m_state +
+                                        (static_cast<S>(1) - alpha) * gC);
+            T gM = static_cast<T>(m_state) * m_processor.makeup_gain();
+            target = std::pow(10.0, gM / 20.0);
+        }
+        const T start = m_gain;
+        const T step = (target - start) / static_cast<T>(length);
+        for (size_t i = 0; i < length; i++) {
+            samples[i] *= start + step * static_cast<T>(i + 1);
+        }
+        m_gain = target;
+    }
+
+    /** Processor providing the configuration and coefficients */
+    P m_processor;
+
+    /** Samples per gain update at the ControlRate tier */
+    size_t m_controlInterval;
+
+    /** Attack coefficient to the power of 0 to m_controlInterval */
+    std::pmr::vector<S> m_attackPowers;
+
+    /** Release coefficient to the power of 0 to m_controlInterval */
+    std::pmr::vector<S> m_releasePowers;
+
+    /** Tier of the current block */
+    QualityTier m_tier = QualityTier::Exact;
+
+    /** Tier of the next block */
+    QualityTier m_requested = QualityTier::Exact;
+
+    /** Gain smoothing state, or envelope for the NoiseGate */
+    S m_state = static_cast<S>(0);
+
+    /** Last linear gain applied */
+    T m_gain = static_cast<T>(1);
+};
+
+/**
+ * @brief Budget controller configuration
+ */
+struct BudgetConfiguration {
+    /** Processing time allowed per block */
+    std::chrono::nanoseconds deadline = std::chrono::nanoseconds(0);
+
+    /** Fraction of the deadline above which a processor is demoted */
+    double demoteLoad = 0.9;
+
+    /** Fraction of the deadline below which a processor may be promoted */
+    double promoteLoad = 0.5;
+
+    /** Consecutive blocks below promoteLoad before each promotion */
+    size_t promoteBlocks = 16;
+};
+
+/**
+ * @brief Budget controller class. Keeps a set of tiered processors under a
+ * per-block processing deadline by trading quality for time.
+ * @details After every block the measured processing time is compared with
+ * the deadline. Above `demoteLoad` the processor with the lowest priority that
+ * can still be demoted drops one tier. After `promoteBlocks` consecutive
+ * blocks below `promoteLoad`, the processor with the highest priority that is
+ * not at the Exact tier goes up one tier, so quality comes back in the reverse
+ * order it was shed. Tier changes take effect at the next block boundary.
+ *
+ * The controller sets the tiers of the processors it manages, and does not
+ * own them; they must outlive it.
+ * @tparam T Type of the input and output samples
+ */
+template<typename T = double>
+class BudgetController {
+public:
+    /**
+     * @brief Public constructor that verifies the configuration and creates a
+     * budget controller object
+     * @param configuration Budget controller configuration
+     * @param resource Memory resource for the list of processors
+     * @return A BudgetController object
+     */
+    auto static create(BudgetConfiguration configuration,
+                       std::pmr::memory_resource *resource =
+                               std::pmr::get_default_resource())
+            -> std::optional<BudgetController> {
+        if (configuration.deadline.count() <= 0 || resource == nullptr) {
+            return std::nullopt;
+        }
+        if (configuration.promoteLoad <= 0.0 ||
+            configuration.promoteLoad >= configuration.demoteLoad ||
+            configuration.promoteBlocks == 0) {
+            return std::nullopt;
+        }
+        return BudgetController(configuration, resource);
+    }
+
+    /**
+     * @brief Add a processor. Not real-time safe
+     * @tparam P Type of the processor
+     * @param processor Tiered processor
+     * @param priority Priority, higher is demoted later and promoted earlier
+     */
+    template<typename P>
+    auto add(TieredProcessor<P> &processor, const int priority = 0) -> void {
+        m_entries.push_back(Entry{
+                .processor = std::addressof(processor),
+                .process =
+                        [](void *p, T *samples, const size_t count) {
+                            static_cast<TieredProcessor<P> *>(p)->process(
+                                    samples, count);
+                        },
+                .set_tier =
+                        [](void *p, const QualityTier tier) {
+                            static_cast<TieredProcessor<P> *>(p)->set_tier(
+                                    tier);
+                        },
+                .priority = priority,
+                .tier = processor.tier()});
+    }
+
+    /**
+     * @brief Process one block of every processor, each in-place on its own
+     * buffer, and update the tiers from the time it took
+     * @param buffers One pointer per processor, in the order they were added
+     * @param count Number of samples in each buffer
+     */
+    auto process(T *const *buffers, const size_t count) -> void {
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < m_entries.size(); i++) {
+            m_entries[i].process(m_entries[i].processor, buffers[i], count);
+        }
+        update(std::chrono::steady_clock::now() - start);
+    }
+
+    /**
+     * @brief Update the tiers from the processing time of a block, for hosts
+     * that process and measure the blocks themselves
+     * @param elapsed Processing time of the block
+     */
+    auto update(const std::chrono::nanoseconds elapsed) -> void {
+        m_load = static_cast<double>(elapsed.count()) /
+                 static_cast<double>(m_config.deadline.count());
+        if (m_load > m_config.demoteLoad) {
+            m_calmBlocks = 0;
+            demote();
+        } else if (m_load < m_config.promoteLoad) {
+            if (++m_calmBlocks >= m_config.promoteBlocks) {
+                m_calmBlocks = 0;
+                promote();
+            }
+        } else {
+            m_calmBlocks = 0;
+        }
+    }
+
+    /**
+     * @brief Quality tier of a processor
+     * @param index Processor index, in the order they were added
+     * @return The tier of its next block
+     */
+    [[nodiscard]] auto tier(const size_t index) const -> QualityTier {
+        return m_entries[index].tier;
+    }
+
+    /**
+     * @brief Number of processors
+     * @return The number of processors
+     */
+    [[nodiscard]] auto size() const -> size_t { return m_entries.size(); }
+
+    /**
+     * @brief Processing time of the last block
+     * @return The fraction of the deadline it took
+     */
+    [[nodiscard]] auto load() const -> double { return m_load; }
+
+    /**
+     * @brief Number of demotions so far
+     * @return The number of demotions
+     */
+    [[nodiscard]] auto demotions() const -> size_t { return m_demotions; }
+
+    /**
+     * @brief Number of promotions so far
+     * @return The number of promotions
+     */
+    [[nodiscard]] auto promotions() const -> size_t { return m_promotions; }
+
+private:
+    /**
+     * @brief A type-erased tiered processor
+     */
+    struct Entry {
+        void *processor;
+        void (*process)(void *, T *, size_t);
+        void (*set_tier)(void *, QualityTier);
+        int priority;
+        QualityTier tier;
+    };
+
+    /**
+     * @brief Private constructor
+     * @param configuration Budget controller configuration
+     * @param resource Memory resource for the list of processors
+     */
+    BudgetController(BudgetConfiguration configuration,
+                     std::pmr::memory_resource *resource) :
+        m_config(configuration), m_entries(resource) {}
+
+    /**
+     * @brief Drop the lowest priority processor that can go lower by one tier
+     */
+    auto demote() -> void {
+        Entry *chosen = nullptr;
+        for (Entry &entry: m_entries) {
+            if (entry.tier != QualityTier::ControlRate &&
+                (chosen == nullptr || entry.priority < chosen->priority)) {
+                chosen = &entry;
+            }
+        }
+        if (chosen != nullptr) {
+            set_tier(*chosen, static_cast<QualityTier>(
+                                      static_cast<int>(chosen->tier) + 1));
+            m_demotions++;
+        }
+    }
+
+    /**
+     * @brief Raise the highest priority processor below Exact by one tier
+     */
+    auto promote() -> void {
+        Entry *chosen = nullptr;
+        for (Entry &entry: m_entries) {
+            if (entry.tier != QualityTier::Exact &&
+                (chosen == nullptr || entry.priority > chosen->priority)) {
+                chosen = &entry;
+            }
+        }
+        if (chosen != nullptr) {
+            set_tier(*chosen, static_cast<QualityTier>(
+                                      static_cast<int>(chosen->tier) - 1));
+            m_promotions++;
+        }
+    }
+
+    /**
+     * @brief Change the tier of a processor
+     * @param entry Processor
+     * @param tier New tier
+     */
+    auto set_tier(Entry &entry, const QualityTier tier) -> void {
+        entry.tier = tier;
+        entry.set_tier(entry.processor, tier);
+    }
+
+    /** Budget controller configuration */
+    BudgetConfiguration m_config;
+
+    /** Managed processors, in the order they were added */
+    std::pmr::vector<Entry> m_entries;
+
+    /** Fraction of the deadline the last block took */
+    double m_load = 0.0;
+
+    /** Consecutive blocks below the promotion load */
+    size_t m_calmBlocks = 0;
+
+    /** Number of demotions */
+    size_t m_demotions = 0;
+
+    /** Number of promotions */
+    size_t m_promotions = 0;
+};
+
+#endif // QUALITY_TIER_H
@@ -0,0 +1,82 @@
+/// SampleView.h
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef SAMPLE_VIEW_H
+#define SAMPLE_VIEW_H
+
+#include <cstddef>
+
+/**
+ * @brief Non-owning view of samples that are a fixed distance apart in memory
+ * @details Used to process one channel of an interleaved buffer, or any other
+ * strided layout, in-place without first copying it into contiguous scratch
+ * memory. A stride of 1 describes a contiguous buffer.
+ * @tparam T Type of the samples
+ */
+template<typename T>
+struct StridedView {
+    /** Pointer to the first sample */
+    T *data = nullptr;
+
+    /** Number of samples in the view */
+    std::size_t count = 0;
+
+    /** Distance between consecutive samples, in samples */
+    std::ptrdiff_t stride = 1;
+
+    /**
+     * @brief Access a sample in the view
+     * @param index Index of the sample
+     * @return Reference to the sample
+     */
+    auto operator[](const std::size_t index) const -> T & {
+        return data[static_cast<std::ptrdiff_t>(index) * stride];
+    }
+
+    /**
+     * @brief Number of samples in the view
+     * @return The number of samples
+     */
+    [[nodiscard]] auto size() const -> std::size_t { return count; }
+};
+
+/**
+ * @brief Creates a view of a single channel of an interleaved buffer
+ * @tparam T Type of the samples
+ * @param samples Pointer to the interleaved samples
+ * @param frames Number of frames in the buffer
+ * @param channels Number of channels per frame
+ * @param channel Index of the channel to view
+ * @return A StridedView over the channel
+ */
+template<typename T>
+auto interleaved_channel(T *samples, const std::size_t frames,
+                         const std::size_t channels, const std::size_t channel)
+        -> StridedView<T> {
+    return StridedView<T>{.data = samples + channel,
+                          .count = frames,
+                          .stride = static_cast<std::ptrdiff_t>(channels)};
+}
+
+#endif // SAMPLE_VIEW_H
@@ -0,0 +1,342 @@
+/// SharedPreset.h
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef SHARED_PRESET_H
+#define SHARED_PRESET_H
+
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <memory_resource>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "Denormal.h"
+
+template<typename P>
+class SharedProcessor;
+
+/**
+ * @brief Preset channel class. Publishes immutable, reference-counted presets
+ * to any number of SharedProcessor instances.
+ * @details A preset is a fully constructed processor, configuration and
+ * precomputed coefficients included, that is never processed with and never
+ * modified once published. Every SharedProcessor following the channel points
+ * at the current preset and keeps only its own envelope state.
+ *
+ * publish() swaps the current preset with a single atomic pointer store. Each
+ * SharedProcessor notices the change at the start of its next block and moves
+ * its reference over, keeping its envelope state, so the switch is as smooth
+ * as the attack and release of the new preset allow. The audio threads only
+ * ever touch atomics: a preset that is no longer current is retired, and is
+ * freed later by collect() on the control thread once no processor refers to
+ * it.
+ *
+ * publish() and collect() must be called from one control thread.
+ * @tparam P Type of the processor, Limiter, Compressor, Expander or NoiseGate
+ */
+template<typename P>
+class PresetChannel {
+public:
+    /**
+     * @brief Public constructor that creates a preset channel object with an
+     * initial preset
+     * @param prototype Processor whose configuration is the initial preset
+     * @param resource Memory resource for the presets
+     * @return A PresetChannel object if the arguments are valid, std::nullopt
+     * otherwise
+     */
+    auto static create(const P &prototype,
+                       std::pmr::memory_resource *resource =
+                               std::pmr::get_default_resource())
+            -> std::optional<PresetChannel> {
+        if (resource == nullptr) {
+            return std::nullopt;
+        }
+        return std::optional<PresetChannel>(std::in_place, prototype,
+                                            resource);
+    }
+
+    /**
+     * @brief Constructor. Use create()
+     * @param prototype Processor whose configuration is the initial preset
+     * @param resource Memory resource for the presets
+     */
+    PresetChannel(const P &prototype, std::pmr::memory_resource *resource) :
+        m_allocator(resource), m_retired(resource) {
+        m_current.store(m_allocator.template new_object<Preset>(prototype),
+                        std::memory_order_release);
+    }
+
+    PresetChannel(const PresetChannel &) = delete;
+    auto operator=(const PresetChannel &) -> PresetChannel & = delete;
+
+    /**
+     * @brief Destructor. Every SharedProcessor following the channel must
+     * have been destroyed first
+     */
+    ~PresetChannel() {
+        for (Preset *preset: m_retired) {
+            m_allocator.delete_object(preset);
+        }
+        m_allocator.delete_object(m_current.load(std::memory_order_acquire));
+    }
+
+    /**
+     * @brief Publish a new preset. Control thread only
+     * @details Allocates the new preset, publishes it and reclaims whatever
+     * earlier presets are no longer referenced.
+     * @param prototype Processor whose configuration is the new preset
+     */
+    auto publish(const P &prototype) -> void {
+        Preset *preset = m_allocator.template new_object<Preset>(prototype);
+        Preset *previous =
+                m_current.exchange(preset, std::memory_order_seq_cst);
+        previous->references.fetch_sub(1, std::memory_order_acq_rel);
+        m_retired.push_back(previous);
+        collect();
+    }
+
+    /**
+     * @brief Free every retired preset that is no longer referenced. Control
+     * thread only
+     * @return Number of presets still waiting to be freed
+     */
+    auto collect() -> size_t {
+        /// A processor that loaded a retired preset before it was retired is
+        /// either done taking its reference or is still counted as a reader:
+        if (m_readers.load(std::memory_order_seq_cst) != 0) {
+            return m_retired.size();
+        }
+        size_t kept = 0;
+        for (Preset *preset: m_retired) {
+            if (preset->references.load(std::memory_order_seq_cst) == 0) {
+                m_allocator.delete_object(preset);
+            } else {
+                m_retired[kept++] = preset;
+            }
+        }
+        m_retired.resize(kept);
+        return kept;
+    }
+
+    /**
+     * @brief The current preset
+     * @return The processor holding the current configuration, read-only
+     */
+    [[nodiscard]] auto current() const -> const P & {
+        return m_current.load(std::memory_order_acquire)->processor;
+    }
+
+private:
+    friend class SharedProcessor<P>;
+
+    /**
+     * @brief An immutable preset and the number of processors referring to it
+     */
+    struct Preset {
+        explicit Preset(const P &prototype) : processor(prototype) {}
+
+        /** Configuration and precomputed coefficients */
+        const P processor;
+
+        /** Number of references, including the channel's while current */
+        std::atomic<size_t> references = 1;
+    };
+
+    /**
+     * @brief Take a reference to the current preset. Wait-free, safe on the
+     * audio thread
+     * @return The current preset
+     */
+    auto acquire() -> Preset * {
+        m_readers.fetch_add(1, std::memory_order_seq_cst);
+        Preset *preset = m_current.load(std::memory_order_seq_cst);
+        preset->references.fetch_add(1, std::memory_order_seq_cst);
+        m_readers.fetch_sub(1, std::memory_order_seq_cst);
+        return preset;
+    }
+
+    /**
+     * @brief Whether a preset is still the current one
+     * @param preset Preset
+     * @return True if it is current
+     */
+    [[nodiscard]] auto is_current(const Preset *preset) const -> bool {
+        return m_current.load(std::memory_order_acquire) == preset;
+    }
+
+    /** Allocator for the presets */
+    std::pmr::polymorphic_allocator<Preset> m_allocator;
+
+    /** Current preset */
+    std::atomic<Preset *> m_current = nullptr;
+
+    /** Number of processors between loading m_current and taking a reference */
+    std::atomic<size_t> m_readers = 0;
+
+    /** Presets that are no longer current, owned by the control thread */
+    std::pmr::vector<Preset *> m_retired;
+};
+
+/**
+ * @brief Shared processor class. A flyweight processor whose configuration and
+ * coefficients live in the current preset of a PresetChannel.
+ * @details Per-instance memory is the envelope state plus two pointers, instead
+ * of a full configuration and coefficient set. The preset is checked once per
+ * block, so a publish is picked up at the next block boundary; the single
+ * sample overload keeps using the preset held since the last block. Presets
+ * are immutable, so parameter automation is not available.
+ * @tparam P Type of the processor, Limiter, Compressor, Expander or NoiseGate
+ */
+template<typename P>
+class SharedProcessor {
+public:
+    using T = typename P::sample_type;
+    using S = typename P::state_type;
+
+    /**
+     * @brief Constructor
+     * @param channel Preset channel to follow, which must outlive the
+     * processor
+     */
+    explicit SharedProcessor(PresetChannel<P> &channel) :
+        m_channel(&channel), m_preset(channel.acquire()) {}
+
+    SharedProcessor(SharedProcessor &&other) noexcept :
+        m_channel(other.m_channel),
+        m_preset(std::exchange(other.m_preset, nullptr)),
+        m_state(other.m_state) {}
+
+    SharedProcessor(const SharedProcessor &) = delete;
+    auto operator=(const SharedProcessor &) -> SharedProcessor & = delete;
+    auto operator=(SharedProcessor &&) -> SharedProcessor & = delete;
+
+    ~SharedProcessor() { release(); }
+
+    /**
+     * @brief Process a sample in-place with the preset held since the last
+     * block
+     * @param sample Sample to process
+     */
+    auto process(T &sample) -> void {
+        const P &processor = m_preset->processor;
+        if constexpr (noise_gate) {
+            S inputLevel = static_cast<S>(std::fabs(sample));
+            if (inputLevel > processor.threshold_level()) {
+                m_state = processor.attack_coefficient() *
+                                  (m_state - inputLevel) +
+                          inputLevel;
+            } else {
+                m_state = flush_denormal(processor.release_coefficient() *
+                                         m_state);
+            }
+            if (m_state < processor.threshold_level()) {
+                sample = static_cast<T>(0);
+            }
+        } else {
+            T inputDecibels = level_decibels(sample);
+            S gC = static_cast<S>(processor.target_gain(inputDecibels));
+            m_state = processor.smooth_gain(m_state, gC);
+            T gM = static_cast<T>(m_state) * processor.makeup_gain();
+            T gLin = std::pow(10.0, gM / 20.0);
+            sample *= gLin;
+        }
+    }
+
+    /**
+     * @brief Processes an array of samples in-place, first picking up the
+     * current preset
+     * @param samples Pointer to the samples
+     * @param count Number of samples
+     */
+    auto process(T *samples, const size_t count) -> void {
+        DenormalGuard guard;
+        refresh();
+        for (size_t i = 0; i < count; i++) {
+            process(samples[i]);
+        }
+    }
+
+    /**
+     * @brief Resets the envelope state
+     */
+    auto reset() -> void { m_state = static_cast<S>(0); }
+
+    /**
+     * @brief Current state
+     * @return The envelope for a NoiseGate, the smoothed gain in decibels
+     * otherwise
+     */
+    [[nodiscard]] auto state() const -> S { return m_state; }
+
+    /**
+     * @brief The preset in use
+     * @return The processor holding the configuration in use, read-only
+     */
+    [[nodiscard]] auto preset() const -> const P & {
+        return m_preset->processor;
+    }
+
+private:
+    using Preset = typename PresetChannel<P>::Preset;
+
+    /** Whether P is a NoiseGate, whose state is an envelope */
+    static constexpr bool noise_gate =
+            requires(const P &processor) { processor.threshold_level(); };
+
+    /**
+     * @brief Move to the current preset if a new one has been published
+     */
+    auto refresh() -> void {
+        if (m_channel->is_current(m_preset)) {
+            return;
+        }
+        Preset *preset = m_channel->acquire();
+        release();
+        m_preset = preset;
+    }
+
+    /**
+     * @brief Drop the reference to the preset in use. Never frees it
+     */
+    auto release() -> void {
+        if (m_preset != nullptr) {
+            m_preset->references.fetch_sub(1, std::memory_order_seq_cst);
+            m_preset = nullptr;
+        }
+    }
+
+    /** Channel followed */
+    PresetChannel<P> *m_channel;
+
+    /** Preset in use */
+    Preset *m_preset;
+
+    /** Gain smoothing state, or envelope for the NoiseGate */
+    S m_state = static_cast<S>(0);
+};
+
+#endif // SHARED_PRESET_H
@@ -0,0 +1,336 @@
+/// SpectralProcessor.h
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef SPECTRAL_PROCESSOR_H
+#define SPECTRAL_PROCESSOR_H
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <memory_resource>
+#include <numbers>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "Denormal.h"
+#include "Fft.h"
+#include "QualityTier.h"
+
+/**
+ * @brief Spectral processor configuration
+ */
+struct SpectralConfiguration {
+    /** Frame size in samples, a power of two */
+    size_t fftSize = 1024;
+
+    /** Samples between frames, dividing the frame size, at most half of it */
+    size_t hopSize = 256;
+};
+
+/**
+ * @brief Spectral processor class. Applies the gain computer of a Limiter,
+ * Compressor or Expander to every frequency bin of a short-time Fourier
+ * transform.
+ * @details The input is cut into overlapping frames, windowed with a
+ * square-root Hann window, transformed, and every bin gets its own gain, after
+ * which the frames are windowed again and overlap-added. Per frame, each step
+ * runs as one loop across all bins: the bin levels in decibels, calibrated so
+ * a sine reads its time-domain peak level, the static characteristic through
+ * the prototype's batch static_characteristic(), the attack/release smoothing
+ * and the linear gains. The level and gain use fast_level_decibels() and
+ * fast_decibels_to_gain(), so none of these loops calls into libm and they
+ * vectorize.
+ *
+ * The prototype's per-sample attack and release coefficients are raised to
+ * the power of the hop size, so the bin gains follow the same time constants
+ * as the time-domain processor. With a Compressor this tames resonances, with
+ * an Expander it is a spectral noise gate.
+ *
+ * The output is delayed by latency() samples. Every buffer is allocated by
+ * create().
+ * @tparam P Type of the prototype processor
+ * @tparam F Type of the real FFT, see Fft
+ */
+template<typename P, typename F = Fft<typename P::state_type>>
+class SpectralProcessor {
+public:
+    /** Type of the input and output samples */
+    using sample_type = typename P::sample_type;
+
+    /** Type of the spectrum and gain smoothing state */
+    using state_type = typename P::state_type;
+
+    using T = sample_type;
+    using S = state_type;
+
+    /**
+     * @brief Public constructor that verifies the configuration and creates a
+     * spectral processor object
+     * @param prototype Processor providing the gain computer and time
+     * constants, only read
+     * @param configuration Spectral processor configuration
+     * @param resource Memory resource for the frames and FFT tables
+     * @return A SpectralProcessor object
+     */
+    auto static create(const P &prototype,
+                       SpectralConfiguration configuration = {},
+                       std::pmr::memory_resource *resource =
+                               std::pmr::get_default_resource())
+            -> std::optional<SpectralProcessor> {
+        const size_t size = configuration.fftSize;
+        const size_t hop = configuration.hopSize;
+        if (resource == nullptr || hop == 0 || hop > size / 2 ||
+            size % hop != 0) {
+            return std::nullopt;
+        }
+        std::optional<F> fft = F::create(size, resource);
+        if (!fft.has_value()) {
+            return std::nullopt;
+        }
+        return SpectralProcessor(prototype, configuration, std::move(*fft),
+                                 resource);
+    }
+
+    /**
+     * @brief Process a sample in-place
+     * @param sample Sample to process
+     */
+    auto process(T &sample) -> void {
+        const size_t size = m_config.fftSize;
+        const size_t hop = m_config.hopSize;
+        m_input[size - hop + m_fill] = static_cast<S>(sample);
+        if (++m_fill == hop) {
+            m_fill = 0;
+            process_frame();
+        }
+        sample = static_cast<T>(m_output[m_fill]);
+    }
+
+    /**
+     * @brief Processes an array of samples in-place
+     * @param samples Pointer to the samples
+     * @param count Number of samples
+     */
+    auto process(T *samples, const size_t count) -> void {
+        DenormalGuard guard;
+        for (size_t i = 0; i < count; i++) {
+            process(samples[i]);
+        }
+    }
+
+    /**
+     * @brief Processes a contiguous span of samples in-place
+     * @param samples Span of samples
+     */
+    auto process(std::span<T> samples) -> void {
+        process(samples.data(), samples.size());
+    }
+
+    /**
+     * @brief Resets the frames and the bin gains
+     */
+    auto reset() -> void {
+        std::fill(m_input.begin(), m_input.end(), static_cast<S>(0));
+        std::fill(m_output.begin(), m_output.end(), static_cast<S>(0));
+        std::fill(m_gainSmoothing.begin(), m_gainSmoothing.end(),
+                  static_cast<S>(0));
+        m_fill = 0;
+    }
+
+    /**
+     * @brief Delay between the input and the output
+     * @return The latency in samples
+     */
+    [[nodiscard]] auto latency() const -> size_t {
+        return m_config.fftSize - 1;
+    }
+
+    /**
+     * @brief Number of frequency bins
+     * @return fftSize / 2 + 1
+     */
+    [[nodiscard]] auto bins() const -> size_t { return m_levels.size(); }
+
+    /**
+     * @brief Current smoothed gain of a bin
+     * @param bin Bin index
+     * @return The gain in decibels, before makeup gain
+     */
+    [[nodiscard]] auto gain(const size_t bin) const -> S {
+        return m_gainSmoothing[bin];
+    }
+
+private:
+    /**
+     * @brief Private constructor
+     * @param prototype Processor providing the gain computer
+     * @param configuration Spectral processor configuration
+     * @param fft Transform of the frame size
+     * @param resource Memory resource for the frames
+     */
+    SpectralProcessor(const P &prototype, SpectralConfiguration configuration,
+                      F fft, std::pmr::memory_resource *resource) :
+        m_prototype(prototype), m_config(configuration),
+        m_fft(std::move(fft)), m_window(configuration.fftSize, resource),
+        m_input(configuration.fftSize, resource),
+        m_output(configuration.fftSize, resource),
+        m_frame(configuration.fftSize, resource),
+        m_spectrum(configuration.fftSize / 2 + 1, resource),
+        m_levels(configuration.fftSize / 2 + 1, resource),
+        m_curve(configuration.fftSize / 2 + 1, resource),
+        m_gainSmoothing(configuration.fftSize / 2 + 1, resource),
+        m_gain(configuration.fftSize / 2 + 1, resource) {
+        const size_t size = configuration.fftSize;
+        const size_t hop = configuration.hopSize;
+        /// Periodic square-root Hann, applied on analysis and synthesis:
+        double windowSum = 0.0;
+        for (size_t n = 0; n < size; n++) {
+            const double hann =
+                    0.5 - 0.5 * std::cos(2.0 * std::numbers::pi *
+                                         static_cast<double>(n) /
+                                         static_cast<double>(size));
+            m_window[n] = static_cast<S>(std::sqrt(hann));
+            windowSum += std::sqrt(hann);
+        }
+        /// Overlapping Hann windows add up to size / (2 hop):
+        m_synthesisScale = static_cast<S>(2.0 * static_cast<double>(hop) /
+                                          static_cast<double>(size));
+        /// A sine of amplitude A peaks at A * windowSum / 2 in its bin:
+        m_levelScale = static_cast<S>(2.0 / windowSum);
+        const auto attack =
+                static_cast<double>(m_prototype.attack_coefficient());
+        const auto release =
+                static_cast<double>(m_prototype.release_coefficient());
+        m_attackValue = static_cast<S>(std::pow(attack, hop));
+        m_releaseValue = static_cast<S>(std::pow(release, hop));
+        /// Whether the prototype attacks while its gain is falling, like a
+        /// compressor, or rising, like an expander:
+        m_attackFalling = m_prototype.smoothing_coefficient(
+                                  static_cast<S>(0), static_cast<S>(-1)) ==
+                          m_prototype.attack_coefficient();
+    }
+
+    /**
+     * @brief Transform, apply the bin gains to and overlap-add the frame
+     * ending with the newest sample
+     */
+    auto process_frame() -> void {
+        const size_t size = m_config.fftSize;
+        const size_t hop = m_config.hopSize;
+        const size_t bins = m_levels.size();
+        for (size_t n = 0; n < size; n++) {
+            m_frame[n] = m_input[n] * m_window[n];
+        }
+        m_fft.forward(m_frame.data(), m_spectrum.data());
+
+        for (size_t k = 0; k < bins; k++) {
+            const S re = m_spectrum[k].real();
+            const S im = m_spectrum[k].imag();
+            const S magnitude = std::sqrt(re * re + im * im) * m_levelScale;
+            m_levels[k] = fast_level_decibels(static_cast<T>(magnitude));
+        }
+        m_prototype.static_characteristic(m_levels, m_curve);
+        const S makeupGain = static_cast<S>(m_prototype.makeup_gain());
+        for (size_t k = 0; k < bins; k++) {
+            const S gC =
+                    static_cast<S>(m_curve[k]) - static_cast<S>(m_levels[k]);
+            const S gs = m_gainSmoothing[k];
+            const S alpha = (gC <= gs) == m_attackFalling ? m_attackValue
+                                                          : m_releaseValue;
+            m_gainSmoothing[k] = flush_denormal<S>(
+                    alpha * gs + (static_cast<S>(1) - alpha) * gC);
+            m_gain[k] = fast_decibels_to_gain(m_gainSmoothing[k] * makeupGain);
+        }
+        for (size_t k = 0; k < bins; k++) {
+            m_spectrum[k] *= m_gain[k];
+        }
+
+        m_fft.inverse(m_spectrum.data(), m_frame.data());
+        /// Slide the overlap-add buffer and the input by one hop:
+        std::copy(m_output.begin() + hop, m_output.end(), m_output.begin());
+        std::fill(m_output.end() - hop, m_output.end(), static_cast<S>(0));
+        for (size_t n = 0; n < size; n++) {
+            m_output[n] += m_frame[n] * m_window[n] * m_synthesisScale;
+        }
+        std::copy(m_input.begin() + hop, m_input.end(), m_input.begin());
+    }
+
+    /** Processor providing the gain computer */
+    P m_prototype;
+
+    /** Spectral processor configuration */
+    SpectralConfiguration m_config;
+
+    /** Transform of the frame size */
+    F m_fft;
+
+    /** Square-root Hann window */
+    std::pmr::vector<S> m_window;
+
+    /** Newest fftSize input samples */
+    std::pmr::vector<S> m_input;
+
+    /** Overlap-add buffer, the first hop samples complete */
+    std::pmr::vector<S> m_output;
+
+    /** Windowed frame */
+    std::pmr::vector<S> m_frame;
+
+    /** Spectrum of the frame */
+    std::pmr::vector<std::complex<S>> m_spectrum;
+
+    /** Bin levels in decibels */
+    std::pmr::vector<T> m_levels;
+
+    /** Static characteristic of every bin level */
+    std::pmr::vector<T> m_curve;
+
+    /** Gain smoothing, one per bin */
+    std::pmr::vector<S> m_gainSmoothing;
+
+    /** Linear gain, one per bin */
+    std::pmr::vector<S> m_gain;
+
+    /** Input samples since the last frame */
+    size_t m_fill = 0;
+
+    /** Synthesis window scale making the overlap-add sum to one */
+    S m_synthesisScale = static_cast<S>(1);
+
+    /** Scale from bin magnitude to sine amplitude */
+    S m_levelScale = static_cast<S>(1);
+
+    /** Attack coefficient per frame */
+    S m_attackValue = static_cast<S>(0);
+
+    /** Release coefficient per frame */
+    S m_releaseValue = static_cast<S>(0);
+
+    /** Whether the attack applies while the gain is falling */
+    bool m_attackFalling = true;
+};
+
+#endif // SPECTRAL_PROCESSOR_H
@@ -0,0 +1,151 @@
+/// SpscRing.h
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Bounded lock-free single-producer single-consumer ring buffer
+ * @details One thread pushes and one thread pops; neither ever blocks or
+ * allocates. The capacity is rounded up to a power of two so indices wrap with
+ * a mask. The producer and consumer indices live on separate cache lines, and
+ * each side keeps a cached copy of the other side's index so that the shared
+ * line is only read when the ring looks full or empty.
+ * @tparam V Type of the values, moved in and out
+ */
+template<typename V>
+class SpscRing {
+public:
+    /**
+     * @brief Constructor
+     * @param capacity Minimum number of values the ring can hold
+     * @param resource Memory resource for the slots
+     */
+    explicit SpscRing(const size_t capacity,
+                      std::pmr::memory_resource *resource =
+                              std::pmr::get_default_resource()) :
+        m_slots(std::bit_ceil(std::max<size_t>(capacity, 1)), resource),
+        m_mask(m_slots.size() - 1) {}
+
+    SpscRing(const SpscRing &) = delete;
+    auto operator=(const SpscRing &) -> SpscRing & = delete;
+
+    /**
+     * @brief Push a value. Producer only
+     * @param value Value to push, moved from on success
+     * @return True if the value was pushed, false if the ring is full
+     */
+    auto try_push(V &value) -> bool {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead > m_mask) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead > m_mask) {
+                return false;
+            }
+        }
+        m_slots[tail & m_mask] = std::move(value);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Pop a value. Consumer only
+     * @param value Destination of the popped value
+     * @return True if a value was popped, false if the ring is empty
+     */
+    auto try_pop(V &value) -> bool {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cachedTail) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail) {
+                return false;
+            }
+        }
+        value = std::move(m_slots[head & m_mask]);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Whether the ring is full. Exact from the producer, approximate
+     * from any other thread
+     * @return True if a push would fail
+     */
+    [[nodiscard]] auto full() const -> bool { return size() > m_mask; }
+
+    /**
+     * @brief Whether the ring is empty. Exact from the consumer, approximate
+     * from any other thread
+     * @return True if a pop would fail
+     */
+    [[nodiscard]] auto empty() const -> bool { return size() == 0; }
+
+    /**
+     * @brief Number of values in the ring
+     * @return The number of values
+     */
+    [[nodiscard]] auto size() const -> size_t {
+        const size_t head = m_head.load(std::memory_order_acquire);
+        return m_tail.load(std::memory_order_acquire) - head;
+    }
+
+    /**
+     * @brief Number of values the ring can hold
+     * @return The capacity
+     */
+    [[nodiscard]] auto capacity() const -> size_t { return m_mask + 1; }
+
+private:
+    /** Destructive interference size, spelled out so it does not vary with
+     * compiler flags */
+    static constexpr size_t cacheLine = 64;
+
+    /** Slots, a power of two of them */
+    std::pmr::vector<V> m_slots;
+
+    /** Slot count minus one */
+    size_t m_mask = 0;
+
+    /** Next slot to pop, written by the consumer */
+    alignas(cacheLine) std::atomic<size_t> m_head = 0;
+
+    /** Consumer's copy of m_tail */
+    size_t m_cachedTail = 0;
+
+    /** Next slot to push, written by the producer */
+    alignas(cacheLine) std::atomic<size_t> m_tail = 0;
+
+    /** Producer's copy of m_head */
+    size_t m_cachedHead = 0;
+};
+
+#endif // SPSC_RING_H
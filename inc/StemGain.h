@@ -0,0 +1,76 @@
+/// StemGain.h
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef STEM_GAIN_H
+#define STEM_GAIN_H
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+
+/** Samples per tile of apply_gain(), 4 KiB of float gains */
+constexpr size_t gainTileSize = 1024;
+
+/**
+ * @brief Multiply one gain curve into many stems in-place
+ * @details Drives any number of stems from one analysis, e.g. the gains a
+ * processor's compute_gain() wrote for the mix bus or a sidechain, so every
+ * stem gets exactly the same gain. The buffers are walked in tiles of
+ * gainTileSize samples: each tile of gains is read from memory once and stays
+ * in L1 while it is multiplied into every stem, and each stem loop is a plain
+ * element-wise product that vectorizes.
+ * @tparam T Type of the samples
+ * @param gains Pointer to `count` linear gains
+ * @param stems One pointer per stem, each to `count` samples
+ * @param stemCount Number of stems
+ * @param count Number of samples per stem
+ */
+template<typename T>
+auto apply_gain(const T *gains, T *const *stems, const size_t stemCount,
+                const size_t count) -> void {
+    for (size_t start = 0; start < count; start += gainTileSize) {
+        const size_t length = std::min(gainTileSize, count - start);
+        const T *tile = gains + start;
+        for (size_t k = 0; k < stemCount; k++) {
+            T *stem = stems[k] + start;
+            for (size_t i = 0; i < length; i++) {
+                stem[i] *= tile[i];
+            }
+        }
+    }
+}
+
+/**
+ * @brief Multiply one gain curve into many stems in-place
+ * @tparam T Type of the samples
+ * @param gains Linear gains, one per sample
+ * @param stems One pointer per stem, each to `gains.size()` samples
+ */
+template<typename T>
+auto apply_gain(std::span<const T> gains, std::span<T *const> stems)
+        -> void {
+    apply_gain(gains.data(), stems.data(), stems.size(), gains.size());
+}
+
+#endif // STEM_GAIN_H
@@ -0,0 +1,298 @@
+/// StereoProcessor.h
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef STEREO_PROCESSOR_H
+#define STEREO_PROCESSOR_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <optional>
+#include <span>
+
+#include "Denormal.h"
+
+/**
+ * @brief How a stereo processor encodes and detects its two channels
+ */
+enum class StereoMode {
+    /** Left and right detected together, one gain applied to both */
+    Linked,
+
+    /** Mid and side, each with its own gain */
+    MidSide,
+
+    /** A general 2x2 encoding matrix, each encoded channel with its own
+     * gain */
+    Matrix
+};
+
+/**
+ * @brief Stereo processor configuration
+ * @tparam T Type of the stereo processor
+ */
+template<typename T = double>
+struct StereoConfiguration {
+    /** How the channels are encoded and detected */
+    StereoMode mode = StereoMode::Linked;
+
+    /** Encoding matrix of the Matrix mode, row-major: the first encoded
+     * channel is `matrix[0] * left + matrix[1] * right`, the second
+     * `matrix[2] * left + matrix[3] * right`. Must be invertible */
+    std::array<T, 4> matrix = {static_cast<T>(1), static_cast<T>(0),
+                               static_cast<T>(0), static_cast<T>(1)};
+};
+
+/**
+ * @brief Stereo processor class. Runs two processors on a matrix-encoded
+ * stereo signal.
+ * @details Every frame is encoded, detected, gained and decoded in a single
+ * pass over the buffer, interleaved or planar, without a scratch copy of the
+ * encoded channels: the encoded pair lives in registers between the matrix and
+ * the gain. In Linked mode the channels are not encoded; the louder of the two
+ * drives the first processor and its gain is applied to both, which keeps the
+ * stereo image. In MidSide mode the encoding is `M = (L + R) / 2`,
+ * `S = (L - R) / 2` and the decoding `L = M + S`, `R = M - S`, so unity gains
+ * give back the input. The Matrix mode decodes with the inverse of its
+ * encoding matrix.
+ *
+ * The processors provide the configuration, static characteristic and
+ * smoothing coefficients only; the gain smoothing state lives in the stereo
+ * processor.
+ * @tparam P Type of the processors, Limiter, Compressor or Expander
+ */
+template<typename P>
+class StereoProcessor {
+public:
+    using T = typename P::sample_type;
+    using S = typename P::state_type;
+
+    /**
+     * @brief Public constructor that verifies the configuration and creates a
+     * stereo processor object
+     * @param first Processor of the left, mid or first encoded channel, and of
+     * both channels in Linked mode
+     * @param second Processor of the right, side or second encoded channel.
+     * Unused in Linked mode
+     * @param configuration Stereo processor configuration
+     * @return A StereoProcessor object if the configuration is valid,
+     * std::nullopt otherwise
+     */
+    auto static create(const P &first, const P &second,
+                       StereoConfiguration<T> configuration = {})
+            -> std::optional<StereoProcessor> {
+        std::array<T, 4> encode = {static_cast<T>(1), static_cast<T>(0),
+                                   static_cast<T>(0), static_cast<T>(1)};
+        if (configuration.mode == StereoMode::MidSide) {
+            encode = {static_cast<T>(0.5), static_cast<T>(0.5),
+                      static_cast<T>(0.5), static_cast<T>(-0.5)};
+        } else if (configuration.mode == StereoMode::Matrix) {
+            encode = configuration.matrix;
+        }
+        const T determinant = encode[0] * encode[3] - encode[1] * encode[2];
+        if (!std::isfinite(determinant) || determinant == static_cast<T>(0)) {
+            return std::nullopt;
+        }
+        const std::array<T, 4> decode = {
+                encode[3] / determinant, -encode[1] / determinant,
+                -encode[2] / determinant, encode[0] / determinant};
+        if (!std::all_of(decode.begin(), decode.end(),
+                         [](const T value) { return std::isfinite(value); })) {
+            return std::nullopt;
+        }
+        return StereoProcessor(first, second, configuration.mode, encode,
+                               decode);
+    }
+
+    /**
+     * @brief Public constructor that creates a stereo processor object with
+     * the same processor on both encoded channels
+     * @param processor Processor of both channels
+     * @param configuration Stereo processor configuration
+     * @return A StereoProcessor object if the configuration is valid,
+     * std::nullopt otherwise
+     */
+    auto static create(const P &processor,
+                       StereoConfiguration<T> configuration = {})
+            -> std::optional<StereoProcessor> {
+        return create(processor, processor, configuration);
+    }
+
+    /**
+     * @brief Process one frame in-place
+     * @param left Left sample
+     * @param right Right sample
+     */
+    auto process(T &left, T &right) -> void {
+        if (m_mode == StereoMode::Linked) {
+            process_frame<true>(left, right);
+        } else {
+            process_frame<false>(left, right);
+        }
+    }
+
+    /**
+     * @brief Processes an array of interleaved stereo samples in-place
+     * @param samples Pointer to the samples, left first
+     * @param count Number of samples, twice the number of frames
+     */
+    auto process(T *samples, const size_t count) -> void {
+        DenormalGuard guard;
+        if (m_mode == StereoMode::Linked) {
+            for (size_t i = 0; i + 2 <= count; i += 2) {
+                process_frame<true>(samples[i], samples[i + 1]);
+            }
+        } else {
+            for (size_t i = 0; i + 2 <= count; i += 2) {
+                process_frame<false>(samples[i], samples[i + 1]);
+            }
+        }
+    }
+
+    /**
+     * @brief Processes a contiguous span of interleaved stereo samples
+     * in-place
+     * @param samples Span of samples, left first
+     */
+    auto process(std::span<T> samples) -> void {
+        process(samples.data(), samples.size());
+    }
+
+    /**
+     * @brief Processes planar stereo channels in-place
+     * @param channels Pointers to the left and right channels
+     * @param frames Number of samples in each channel
+     */
+    auto process(T *const *channels, const size_t frames) -> void {
+        DenormalGuard guard;
+        T *left = channels[0];
+        T *right = channels[1];
+        if (m_mode == StereoMode::Linked) {
+            for (size_t i = 0; i < frames; i++) {
+                process_frame<true>(left[i], right[i]);
+            }
+        } else {
+            for (size_t i = 0; i < frames; i++) {
+                process_frame<false>(left[i], right[i]);
+            }
+        }
+    }
+
+    /**
+     * @brief Resets the gain smoothing of both channels
+     */
+    auto reset() -> void { m_gainSmoothing = {}; }
+
+    /**
+     * @brief Current smoothed gain of an encoded channel
+     * @param channel 0 for the first encoded channel, 1 for the second. Only
+     * channel 0 is used in Linked mode
+     * @return The gain in decibels, before makeup gain
+     */
+    [[nodiscard]] auto gain(const size_t channel = 0) const -> S {
+        return m_gainSmoothing[channel];
+    }
+
+    /**
+     * @brief Mode of the stereo processor
+     * @return The mode
+     */
+    [[nodiscard]] auto mode() const -> StereoMode { return m_mode; }
+
+private:
+    /**
+     * @brief Private constructor
+     * @param first Processor of the first encoded channel
+     * @param second Processor of the second encoded channel
+     * @param mode Stereo mode
+     * @param encode Encoding matrix, row-major
+     * @param decode Decoding matrix, row-major
+     */
+    StereoProcessor(const P &first, const P &second, const StereoMode mode,
+                    const std::array<T, 4> &encode,
+                    const std::array<T, 4> &decode) :
+        m_first(first), m_second(second), m_mode(mode), m_encode(encode),
+        m_decode(decode) {}
+
+    /**
+     * @brief Detect a level, smooth the gain and compute the linear gain of
+     * one encoded channel
+     * @param processor Processor of the channel
+     * @param gainSmoothing Gain smoothing state of the channel
+     * @param level Detected sample
+     * @return The linear gain, makeup gain included
+     */
+    static auto linear_gain(const P &processor, S &gainSmoothing,
+                            const T level) -> T {
+        const T inputDecibels = level_decibels(level);
+        const S gC = static_cast<S>(processor.target_gain(inputDecibels));
+        gainSmoothing = processor.smooth_gain(gainSmoothing, gC);
+        const T gM = static_cast<T>(gainSmoothing) * processor.makeup_gain();
+        return static_cast<T>(std::pow(10.0, gM / 20.0));
+    }
+
+    /**
+     * @brief Encode, detect, gain and decode one frame
+     * @tparam Linked Whether the channels share one detector and gain
+     * @param left Left sample
+     * @param right Right sample
+     */
+    template<bool Linked>
+    auto process_frame(T &left, T &right) -> void {
+        if constexpr (Linked) {
+            const T level = std::max(std::fabs(left), std::fabs(right));
+            const T gLin = linear_gain(m_first, m_gainSmoothing[0], level);
+            left *= gLin;
+            right *= gLin;
+        } else {
+            const T a = m_encode[0] * left + m_encode[1] * right;
+            const T b = m_encode[2] * left + m_encode[3] * right;
+            const T gA = a * linear_gain(m_first, m_gainSmoothing[0], a);
+            const T gB = b * linear_gain(m_second, m_gainSmoothing[1], b);
+            left = m_decode[0] * gA + m_decode[1] * gB;
+            right = m_decode[2] * gA + m_decode[3] * gB;
+        }
+    }
+
+    /** Processor of the first encoded channel */
+    P m_first;
+
+    /** Processor of the second encoded channel */
+    P m_second;
+
+    /** Stereo mode */
+    StereoMode m_mode;
+
+    /** Encoding matrix, row-major */
+    std::array<T, 4> m_encode;
+
+    /** Decoding matrix, row-major */
+    std::array<T, 4> m_decode;
+
+    /** Gain smoothing, one per encoded channel */
+    std::array<S, 2> m_gainSmoothing = {};
+};
+
+#endif // STEREO_PROCESSOR_H
@@ -0,0 +1,737 @@
+/// StreamingPipeline.h
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef STREAMING_PIPELINE_H
+#define STREAMING_PIPELINE_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdio>
+#include <exception>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "SpscRing.h"
+
+/**
+ * @brief Streaming pipeline configuration
+ */
+struct StreamingPipelineConfiguration {
+    /** Maximum number of samples in a block */
+    size_t blockSize = 512;
+
+    /** Number of blocks in flight, shared by every queue */
+    size_t blockCount = 32;
+
+    /** Number of blocks each queue between two stages can hold */
+    size_t queueCapacity = 8;
+
+    /** Number of worker threads running the stages, 0 for one per stage */
+    size_t threads = 0;
+
+    /** Whether to pin worker thread i to core i + 1 (Linux only) */
+    bool pinThreads = false;
+};
+
+/**
+ * @brief Statistics of one stage of a streaming pipeline
+ */
+struct StageStatistics {
+    /** Number of blocks processed */
+    size_t blocks = 0;
+
+    /** Time spent inside the processor */
+    std::chrono::nanoseconds busy = std::chrono::nanoseconds(0);
+
+    /** Largest number of blocks seen waiting in the stage's input queue */
+    size_t maxQueueDepth = 0;
+
+    /** Mean number of blocks waiting in the stage's input queue */
+    double meanQueueDepth = 0.0;
+
+    /** Number of times the stage was held back by a full output queue */
+    size_t stalls = 0;
+};
+
+/**
+ * @brief Statistics of a streaming pipeline run
+ */
+struct PipelineStatistics {
+    /** Number of samples that reached the sink */
+    size_t samples = 0;
+
+    /** Number of blocks that reached the sink */
+    size_t blocks = 0;
+
+    /** Wall-clock time of the run */
+    std::chrono::nanoseconds elapsed = std::chrono::nanoseconds(0);
+
+    /** Per-stage statistics, in pipeline order */
+    std::vector<StageStatistics> stages;
+
+    /**
+     * @brief End-to-end throughput
+     * @return Samples per second
+     */
+    [[nodiscard]] auto samples_per_second() const -> double {
+        if (elapsed.count() == 0) {
+            return 0.0;
+        }
+        return static_cast<double>(samples) * 1e9 /
+               static_cast<double>(elapsed.count());
+    }
+};
+
+/**
+ * @brief Streaming pipeline class. Runs a chain of processors as a pipeline
+ * across cores, e.g. a NoiseGate on one core feeding a Compressor on the next,
+ * feeding a Limiter on a third.
+ * @details Every stage is a C++20 coroutine. Stages are connected by bounded
+ * lock-free SpscRing queues of pointers to audio blocks from a fixed pool, so a
+ * block changes owner without its samples being copied. A stage that finds its
+ * input queue empty or its output queue full suspends at that point, which is
+ * how backpressure propagates upstream: the source stops reading once every
+ * block of the pool is in flight.
+ *
+ * Each worker thread runs a small scheduler that resumes whichever of its
+ * stages can make progress, so the number of threads is independent of the
+ * number of stages. The source and sink run on the thread calling run(). Once
+ * the pipeline is running, nothing allocates: block storage, queues and
+ * coroutine frames are all created beforehand.
+ * @tparam T Type of the samples
+ */
+template<typename T = double>
+class StreamingPipeline {
+public:
+    /**
+     * @brief A block of samples. Only the current owner may touch it
+     */
+    struct AudioBlock {
+        /** Storage for the samples, blockSize of them */
+        T *samples = nullptr;
+
+        /** Number of valid samples, 0 marks the end of the stream */
+        size_t count = 0;
+    };
+
+    /**
+     * @brief Public constructor that verifies the configuration and creates a
+     * streaming pipeline object
+     * @param configuration Streaming pipeline configuration
+     * @param resource Memory resource for the block pool and the queues
+     * @return A StreamingPipeline object if the configuration is valid,
+     * std::nullopt otherwise
+     */
+    auto static create(StreamingPipelineConfiguration configuration,
+                       std::pmr::memory_resource *resource =
+                               std::pmr::get_default_resource())
+            -> std::optional<StreamingPipeline> {
+        if (configuration.blockSize == 0 || configuration.blockCount == 0 ||
+            configuration.queueCapacity == 0 || resource == nullptr) {
+            return std::nullopt;
+        }
+        return StreamingPipeline(configuration, resource);
+    }
+
+    /**
+     * @brief Append a processor stage. The processor is referenced, not
+     * copied, and must outlive every call to run()
+     * @tparam P Type of the processor, with a `process(T *, size_t)` member
+     * @param processor Processor
+     */
+    template<typename P>
+    auto add_stage(P &processor) -> void {
+        m_stages.push_back(Stage{
+                .processor = std::addressof(processor),
+                .process = [](void *p, T *samples, const size_t count) {
+                    static_cast<P *>(p)->process(samples, count);
+                }});
+    }
+
+    /**
+     * @brief Number of processor stages
+     * @return The number of stages
+     */
+    [[nodiscard]] auto stage_count() const -> size_t { return m_stages.size(); }
+
+    /**
+     * @brief Number of blocks waiting in the input queue of a stage. Safe to
+     * call from any thread while the pipeline is running
+     * @param stage Stage index, or stage_count() for the sink
+     * @return The queue depth
+     */
+    [[nodiscard]] auto queue_depth(const size_t stage) const -> size_t {
+        if (stage >= m_queues.size()) {
+            return 0;
+        }
+        return m_queues[stage]->ring.size();
+    }
+
+    /**
+     * @brief Stream every sample of a source through the stages into a sink
+     * @tparam Source Callable `size_t(T *destination, size_t maximum)` that
+     * reads up to `maximum` samples and returns how many were read, 0 at the
+     * end of the stream
+     * @tparam Sink Callable `void(const T *source, size_t count)` that
+     * receives processed samples in order
+     * @param source Source
+     * @param sink Sink
+     * @return Throughput and per-stage statistics of the run
+     */
+    template<typename Source, typename Sink>
+    auto run(Source &&source, Sink &&sink) -> PipelineStatistics {
+        prepare();
+        const size_t workerCount =
+                m_config.threads == 0
+                        ? m_stages.size()
+                        : std::min(m_config.threads, m_stages.size());
+        std::vector<Scheduler> schedulers(workerCount);
+        std::vector<Task> tasks;
+        tasks.reserve(m_stages.size() + 2);
+        for (size_t i = 0; i < m_stages.size(); i++) {
+            tasks.push_back(run_stage(m_stages[i], *m_queues[i],
+                                      *m_queues[i + 1], m_statistics[i]));
+            schedulers[i % workerCount].tasks.push_back(&tasks.back());
+        }
+        Scheduler local;
+        tasks.push_back(run_source(source));
+        local.tasks.push_back(&tasks.back());
+        tasks.push_back(run_sink(sink));
+        local.tasks.push_back(&tasks.back());
+
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> workers;
+        workers.reserve(workerCount);
+        for (size_t w = 0; w < workerCount; w++) {
+            workers.emplace_back([&schedulers, w]() { schedulers[w].run(); });
+            if (m_config.pinThreads) {
+                pin(workers.back(), w + 1);
+            }
+        }
+        local.run();
+        for (std::thread &worker: workers) {
+            worker.join();
+        }
+        PipelineStatistics statistics;
+        statistics.elapsed = std::chrono::steady_clock::now() - start;
+        statistics.samples = m_sinkSamples;
+        statistics.blocks = m_sinkBlocks;
+        for (size_t i = 0; i < m_stages.size(); i++) {
+            StageStatistics stage = m_statistics[i];
+            const Queue &input = *m_queues[i];
+            stage.maxQueueDepth = input.maxDepth;
+            stage.meanQueueDepth =
+                    input.pushes == 0
+                            ? 0.0
+                            : static_cast<double>(input.depthSum) /
+                                      static_cast<double>(input.pushes);
+            stage.stalls = m_queues[i + 1]->stalls;
+            statistics.stages.push_back(stage);
+        }
+        return statistics;
+    }
+
+private:
+    /**
+     * @brief A type-erased processor stage
+     */
+    struct Stage {
+        /** Processor */
+        void *processor = nullptr;
+
+        /** Calls `process(samples, count)` on the processor */
+        void (*process)(void *, T *, size_t) = nullptr;
+    };
+
+    /**
+     * @brief A queue between two stages. The statistics are written by the
+     * producing stage only
+     */
+    struct Queue {
+        /**
+         * @brief Constructor
+         * @param capacity Number of blocks the queue can hold
+         * @param resource Memory resource for the ring
+         */
+        Queue(const size_t capacity, std::pmr::memory_resource *resource) :
+            ring(capacity, resource) {}
+
+        /** Blocks in flight */
+        SpscRing<AudioBlock *> ring;
+
+        /** Largest depth seen by a push */
+        size_t maxDepth = 0;
+
+        /** Sum of the depths seen by every push */
+        size_t depthSum = 0;
+
+        /** Number of pushes */
+        size_t pushes = 0;
+
+        /** Number of pushes that found the queue full */
+        size_t stalls = 0;
+    };
+
+    /**
+     * @brief What a suspended coroutine is waiting for
+     */
+    class Waiter {
+    public:
+        virtual ~Waiter() = default;
+
+        /**
+         * @brief Whether the coroutine can be resumed
+         * @return True if the awaited queue is ready
+         */
+        [[nodiscard]] virtual auto ready() const -> bool = 0;
+    };
+
+    /**
+     * @brief Coroutine type of every stage, started and resumed by a Scheduler
+     */
+    class Task {
+    public:
+        struct promise_type {
+            /** What the coroutine is suspended on, nullptr if runnable */
+            const Waiter *waiter = nullptr;
+
+            auto get_return_object() -> Task {
+                return Task(std::coroutine_handle<promise_type>::from_promise(
+                        *this));
+            }
+            auto initial_suspend() noexcept -> std::suspend_always {
+                return {};
+            }
+            auto final_suspend() noexcept -> std::suspend_always { return {}; }
+            auto return_void() -> void {}
+            auto unhandled_exception() -> void { std::terminate(); }
+        };
+
+        /**
+         * @brief Constructor
+         * @param handle Coroutine handle, owned by the task
+         */
+        explicit Task(std::coroutine_handle<promise_type> handle) :
+            m_handle(handle) {}
+
+        Task(Task &&other) noexcept :
+            m_handle(std::exchange(other.m_handle, nullptr)) {}
+        Task(const Task &) = delete;
+        auto operator=(const Task &) -> Task & = delete;
+        auto operator=(Task &&) -> Task & = delete;
+
+        ~Task() {
+            if (m_handle) {
+                m_handle.destroy();
+            }
+        }
+
+        /**
+         * @brief Resume the coroutine if it can make progress
+         * @return True if the coroutine was resumed
+         */
+        auto step() -> bool {
+            const Waiter *waiter = m_handle.promise().waiter;
+            if (waiter != nullptr && !waiter->ready()) {
+                return false;
+            }
+            m_handle.promise().waiter = nullptr;
+            m_handle.resume();
+            return true;
+        }
+
+        /**
+         * @brief Whether the coroutine has finished
+         * @return True if the coroutine has finished
+         */
+        [[nodiscard]] auto done() const -> bool { return m_handle.done(); }
+
+    private:
+        /** Coroutine handle */
+        std::coroutine_handle<promise_type> m_handle;
+    };
+
+    using Handle = std::coroutine_handle<typename Task::promise_type>;
+
+    /**
+     * @brief Awaitable that takes the next block from a queue, suspending
+     * while it is empty
+     */
+    class Pop final : public Waiter {
+    public:
+        explicit Pop(Queue &queue) : m_queue(queue) {}
+
+        [[nodiscard]] auto ready() const -> bool override {
+            return !m_queue.ring.empty();
+        }
+        [[nodiscard]] auto await_ready() const -> bool { return ready(); }
+        auto await_suspend(Handle handle) -> void {
+            handle.promise().waiter = this;
+        }
+        auto await_resume() -> AudioBlock * {
+            AudioBlock *block = nullptr;
+            m_queue.ring.try_pop(block);
+            return block;
+        }
+
+    private:
+        /** Queue popped from, consumed by this coroutine only */
+        Queue &m_queue;
+    };
+
+    /**
+     * @brief Awaitable that hands a block to a queue, suspending while it is
+     * full
+     */
+    class Push final : public Waiter {
+    public:
+        Push(Queue &queue, AudioBlock *block) :
+            m_queue(queue), m_block(block) {}
+
+        [[nodiscard]] auto ready() const -> bool override {
+            return !m_queue.ring.full();
+        }
+        [[nodiscard]] auto await_ready() const -> bool { return ready(); }
+        auto await_suspend(Handle handle) -> void {
+            m_queue.stalls++;
+            handle.promise().waiter = this;
+        }
+        auto await_resume() -> void {
+            const size_t depth = m_queue.ring.size();
+            m_queue.maxDepth = std::max(m_queue.maxDepth, depth + 1);
+            m_queue.depthSum += depth + 1;
+            m_queue.pushes++;
+            m_queue.ring.try_push(m_block);
+        }
+
+    private:
+        /** Queue pushed to, produced by this coroutine only */
+        Queue &m_queue;
+
+        /** Block handed over */
+        AudioBlock *m_block;
+    };
+
+    /**
+     * @brief Runs a set of tasks on one thread until all of them have finished
+     */
+    struct Scheduler {
+        /** Tasks, not owned */
+        std::vector<Task *> tasks;
+
+        auto run() -> void {
+            size_t remaining = tasks.size();
+            while (remaining > 0) {
+                bool progress = false;
+                remaining = 0;
+                for (Task *task: tasks) {
+                    if (task->done()) {
+                        continue;
+                    }
+                    progress |= task->step();
+                    remaining += task->done() ? 0 : 1;
+                }
+                if (!progress) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+    };
+
+    /**
+     * @brief Private constructor
+     * @param configuration Streaming pipeline configuration
+     * @param resource Memory resource for the block pool and the queues
+     */
+    StreamingPipeline(StreamingPipelineConfiguration configuration,
+                      std::pmr::memory_resource *resource) :
+        m_config(configuration), m_resource(resource),
+        m_storage(configuration.blockSize * configuration.blockCount, resource),
+        m_blocks(configuration.blockCount, resource) {
+        for (size_t i = 0; i < m_blocks.size(); i++) {
+            m_blocks[i].samples = m_storage.data() + i * m_config.blockSize;
+        }
+    }
+
+    /**
+     * @brief Create the queues and put every block back in the free queue
+     */
+    auto prepare() -> void {
+        m_queues.clear();
+        for (size_t i = 0; i <= m_stages.size(); i++) {
+            m_queues.push_back(std::make_unique<Queue>(m_config.queueCapacity,
+                                                       m_resource));
+        }
+        m_free = std::make_unique<Queue>(m_blocks.size(), m_resource);
+        for (AudioBlock &block: m_blocks) {
+            AudioBlock *pointer = &block;
+            m_free->ring.try_push(pointer);
+        }
+        m_statistics.assign(m_stages.size(), StageStatistics{});
+        m_sinkSamples = 0;
+        m_sinkBlocks = 0;
+    }
+
+    /**
+     * @brief Source coroutine: fill free blocks and feed the first queue
+     * @param source Source
+     */
+    template<typename Source>
+    auto run_source(Source &source) -> Task {
+        while (true) {
+            AudioBlock *block = co_await Pop(*m_free);
+            block->count = source(block->samples, m_config.blockSize);
+            co_await Push(*m_queues.front(), block);
+            if (block->count == 0) {
+                co_return;
+            }
+        }
+    }
+
+    /**
+     * @brief Stage coroutine: process blocks from one queue into the next
+     * @param stage Stage
+     * @param input Input queue
+     * @param output Output queue
+     * @param statistics Statistics of the stage
+     */
+    auto run_stage(const Stage stage, Queue &input, Queue &output,
+                   StageStatistics &statistics) -> Task {
+        while (true) {
+            AudioBlock *block = co_await Pop(input);
+            const bool last = block->count == 0;
+            if (!last) {
+                const auto start = std::chrono::steady_clock::now();
+                stage.process(stage.processor, block->samples, block->count);
+                statistics.busy += std::chrono::steady_clock::now() - start;
+                statistics.blocks++;
+            }
+            co_await Push(output, block);
+            if (last) {
+                co_return;
+            }
+        }
+    }
+
+    /**
+     * @brief Sink coroutine: drain the last queue and recycle the blocks
+     * @param sink Sink
+     */
+    template<typename Sink>
+    auto run_sink(Sink &sink) -> Task {
+        while (true) {
+            AudioBlock *block = co_await Pop(*m_queues.back());
+            const bool last = block->count == 0;
+            if (!last) {
+                sink(static_cast<const T *>(block->samples), block->count);
+                m_sinkSamples += block->count;
+                m_sinkBlocks++;
+            }
+            co_await Push(*m_free, block);
+            if (last) {
+                co_return;
+            }
+        }
+    }
+
+    /**
+     * @brief Pin a thread to a core, where supported
+     * @param thread Thread
+     * @param core Core index, wrapped to the number of cores
+     */
+    static auto pin([[maybe_unused]] std::thread &thread,
+                    [[maybe_unused]] const size_t core) -> void {
+#if defined(__linux__)
+        const size_t cores = std::max(1u, std::thread::hardware_concurrency());
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(core % cores, &set);
+        pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+#endif
+    }
+
+    /** Streaming pipeline configuration */
+    StreamingPipelineConfiguration m_config;
+
+    /** Memory resource for the block pool and the queues */
+    std::pmr::memory_resource *m_resource = nullptr;
+
+    /** Sample storage of every block */
+    std::pmr::vector<T> m_storage;
+
+    /** Block pool */
+    std::pmr::vector<AudioBlock> m_blocks;
+
+    /** Processor stages */
+    std::vector<Stage> m_stages;
+
+    /** Queues in front of every stage and of the sink */
+    std::vector<std::unique_ptr<Queue>> m_queues;
+
+    /** Queue of free blocks, from the sink back to the source */
+    std::unique_ptr<Queue> m_free;
+
+    /** Statistics of every stage */
+    std::vector<StageStatistics> m_statistics;
+
+    /** Samples and blocks that reached the sink */
+    size_t m_sinkSamples = 0;
+    size_t m_sinkBlocks = 0;
+};
+
+/**
+ * @brief Source reading raw native-endian samples from a file
+ * @tparam T Type of the samples
+ */
+template<typename T = double>
+class FileSource {
+public:
+    /**
+     * @brief Public constructor that opens the file and creates a file source
+     * object
+     * @param path Path of the file
+     * @return A FileSource object if the file could be opened, std::nullopt
+     * otherwise
+     */
+    auto static create(const char *path) -> std::optional<FileSource> {
+        std::FILE *file = std::fopen(path, "rb");
+        if (file == nullptr) {
+            return std::nullopt;
+        }
+        return FileSource(file);
+    }
+
+    /**
+     * @brief Read samples
+     * @param destination Destination of the samples
+     * @param maximum Maximum number of samples to read
+     * @return Number of samples read, 0 at the end of the file
+     */
+    auto operator()(T *destination, const size_t maximum) -> size_t {
+        return std::fread(destination, sizeof(T), maximum, m_file.get());
+    }
+
+private:
+    /**
+     * @brief Closes the file
+     */
+    struct Closer {
+        auto operator()(std::FILE *file) const -> void { std::fclose(file); }
+    };
+
+    /**
+     * @brief Private constructor
+     * @param file Open file, owned by the source
+     */
+    explicit FileSource(std::FILE *file) : m_file(file) {}
+
+    /** File */
+    std::unique_ptr<std::FILE, Closer> m_file;
+};
+
+/**
+ * @brief In-process stand-in for a network source
+ * @details A producer thread sends packets of samples with send() and ends the
+ * stream with close(); the pipeline reads them as a source. Samples travel
+ * through an SpscRing, so neither side locks, and the producer is held back by
+ * backpressure once the ring is full, like a receive window.
+ * @tparam T Type of the samples
+ */
+template<typename T = double>
+class LoopbackSource {
+public:
+    /**
+     * @brief Constructor
+     * @param capacity Number of samples buffered between the two sides
+     * @param resource Memory resource for the buffer
+     */
+    explicit LoopbackSource(const size_t capacity,
+                            std::pmr::memory_resource *resource =
+                                    std::pmr::get_default_resource()) :
+        m_ring(capacity, resource) {}
+
+    /**
+     * @brief Send a packet, waiting while the buffer is full. Producer only
+     * @param samples Pointer to the samples
+     * @param count Number of samples
+     */
+    auto send(const T *samples, const size_t count) -> void {
+        for (size_t i = 0; i < count; i++) {
+            T sample = samples[i];
+            while (!m_ring.try_push(sample)) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    /**
+     * @brief End the stream. Producer only
+     */
+    auto close() -> void { m_closed.store(true, std::memory_order_release); }
+
+    /**
+     * @brief Receive samples, waiting until at least one has arrived or the
+     * stream is closed. Consumer only
+     * @param destination Destination of the samples
+     * @param maximum Maximum number of samples to receive
+     * @return Number of samples received, 0 at the end of the stream
+     */
+    auto operator()(T *destination, const size_t maximum) -> size_t {
+        size_t count = 0;
+        while (count == 0) {
+            const bool closed = m_closed.load(std::memory_order_acquire);
+            while (count < maximum && m_ring.try_pop(destination[count])) {
+                count++;
+            }
+            if (count == 0 && closed) {
+                return 0;
+            }
+            if (count == 0) {
+                std::this_thread::yield();
+            }
+        }
+        return count;
+    }
+
+private:
+    /** Samples in flight */
+    SpscRing<T> m_ring;
+
+    /** Whether the producer has ended the stream */
+    std::atomic<bool> m_closed = false;
+};
+
+#endif // STREAMING_PIPELINE_H
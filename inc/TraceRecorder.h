@@ -0,0 +1,831 @@
+/// TraceRecorder.h
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef TRACE_RECORDER_H
+#define TRACE_RECORDER_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <type_traits>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Kind of a trace record
+ */
+enum class TraceEvent : uint32_t {
+    /** A TraceProcessorTag followed by a processor configuration, the first
+     * record of every trace */
+    Configuration = 1,
+
+    /** An input block, recorded before it was processed, and the time
+     * processing it took */
+    Block = 2,
+
+    /** A reset of the processor */
+    Reset = 3
+};
+
+/**
+ * @brief Header of a trace record, followed by its payload
+ */
+struct TraceHeader {
+    /** Kind of the record, with traceGapFlag set if records were dropped
+     * right before it */
+    uint32_t event = 0;
+
+    /** Payload size in bytes */
+    uint32_t bytes = 0;
+
+    /** Time the audio thread spent processing a block, in nanoseconds */
+    uint64_t nanoseconds = 0;
+};
+
+/** Set in TraceHeader::event when records were dropped before the record */
+constexpr uint32_t traceGapFlag = 0x80000000;
+
+/** First bytes of a trace file */
+constexpr std::array<char, 8> traceMagic = {'D', 'R', 'T', 'R',
+                                            'A', 'C', 'E', '1'};
+
+template<typename T, typename S>
+class Limiter;
+
+template<typename T, typename S>
+class Compressor;
+
+template<typename T, typename S>
+class Expander;
+
+template<typename T, typename S>
+class NoiseGate;
+
+/**
+ * @brief Processor template a trace can be recorded with, 0 if it cannot
+ */
+template<typename P>
+constexpr uint32_t trace_processor_id = 0;
+
+template<typename T, typename S>
+constexpr uint32_t trace_processor_id<Limiter<T, S>> = 1;
+
+template<typename T, typename S>
+constexpr uint32_t trace_processor_id<Compressor<T, S>> = 2;
+
+template<typename T, typename S>
+constexpr uint32_t trace_processor_id<Expander<T, S>> = 3;
+
+template<typename T, typename S>
+constexpr uint32_t trace_processor_id<NoiseGate<T, S>> = 4;
+
+/**
+ * @brief Processor type of a trace, written ahead of the configuration in
+ * every configuration record, since configurations of different processors
+ * can have the same size
+ */
+struct TraceProcessorTag {
+    /** Processor template, see trace_processor_id */
+    uint32_t processor = 0;
+
+    /** Size of a sample in bytes */
+    uint32_t sampleBytes = 0;
+
+    /** Size of a state value in bytes */
+    uint32_t stateBytes = 0;
+
+    /** Size of the configuration in bytes */
+    uint32_t configurationBytes = 0;
+
+    auto operator==(const TraceProcessorTag &) const -> bool = default;
+};
+
+/**
+ * @brief Configuration type of a processor, the argument of its create()
+ */
+template<typename P, typename C>
+auto configuration_argument(std::optional<P> (*)(C)) -> C;
+
+template<typename P>
+using processor_configuration_t =
+        decltype(configuration_argument<P>(&P::create));
+
+/**
+ * @brief Processor type tag of a processor
+ * @tparam P Type of the processor
+ * @return The tag recorded with its configurations
+ */
+template<typename P>
+constexpr auto trace_processor_tag() -> TraceProcessorTag {
+    return {.processor = trace_processor_id<P>,
+            .sampleBytes = sizeof(typename P::sample_type),
+            .stateBytes = sizeof(typename P::state_type),
+            .configurationBytes = sizeof(processor_configuration_t<P>)};
+}
+
+/**
+ * @brief Trace file class. A memory-mapped file of fixed capacity that trace
+ * records are appended to.
+ * @details The file is created at its full capacity and mapped once, so
+ * appending is a copy into the mapping; the kernel writes the pages back in
+ * the background. The file is truncated to the bytes actually written when it
+ * is closed.
+ */
+class TraceFile {
+public:
+    /**
+     * @brief Public constructor that creates and maps a trace file
+     * @param path Path of the file, replaced if it exists
+     * @param capacity Maximum number of bytes of records
+     * @return A TraceFile object, or std::nullopt if the file could not be
+     * created or mapped
+     */
+    auto static create(const char *path, const size_t capacity)
+            -> std::optional<TraceFile> {
+        const int descriptor = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (descriptor < 0) {
+            return std::nullopt;
+        }
+        const size_t length = traceMagic.size() + capacity;
+        if (::ftruncate(descriptor, static_cast<off_t>(length)) != 0) {
+            ::close(descriptor);
+            return std::nullopt;
+        }
+        void *mapping = ::mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                               MAP_SHARED, descriptor, 0);
+        if (mapping == MAP_FAILED) {
+            ::close(descriptor);
+            return std::nullopt;
+        }
+        std::memcpy(mapping, traceMagic.data(), traceMagic.size());
+        return TraceFile(descriptor, static_cast<std::byte *>(mapping),
+                         length);
+    }
+
+    TraceFile(TraceFile &&other) noexcept :
+        m_descriptor(std::exchange(other.m_descriptor, -1)),
+        m_mapping(std::exchange(other.m_mapping, nullptr)),
+        m_length(other.m_length), m_size(other.m_size) {}
+
+    TraceFile(const TraceFile &) = delete;
+    auto operator=(const TraceFile &) -> TraceFile & = delete;
+    auto operator=(TraceFile &&) -> TraceFile & = delete;
+
+    ~TraceFile() { close(); }
+
+    /**
+     * @brief Reserve space for the next bytes of the file
+     * @param bytes Number of bytes
+     * @return Where to write them, or nullptr if the file is full
+     */
+    auto reserve(const size_t bytes) -> std::byte * {
+        if (m_mapping == nullptr || m_length - m_size < bytes) {
+            return nullptr;
+        }
+        std::byte *destination = m_mapping + m_size;
+        m_size += bytes;
+        return destination;
+    }
+
+    /**
+     * @brief Unmap the file and truncate it to the bytes written
+     */
+    auto close() -> void {
+        if (m_mapping != nullptr) {
+            ::munmap(m_mapping, m_length);
+            m_mapping = nullptr;
+        }
+        if (m_descriptor >= 0) {
+            const int result =
+                    ::ftruncate(m_descriptor, static_cast<off_t>(m_size));
+            static_cast<void>(result);
+            ::close(m_descriptor);
+            m_descriptor = -1;
+        }
+    }
+
+    /**
+     * @brief Size of the file
+     * @return The number of bytes written, header included
+     */
+    [[nodiscard]] auto size() const -> size_t { return m_size; }
+
+private:
+    /**
+     * @brief Private constructor
+     * @param descriptor File descriptor
+     * @param mapping Mapping of the whole file
+     * @param length Length of the mapping
+     */
+    TraceFile(const int descriptor, std::byte *mapping, const size_t length) :
+        m_descriptor(descriptor), m_mapping(mapping), m_length(length),
+        m_size(traceMagic.size()) {}
+
+    /** File descriptor */
+    int m_descriptor;
+
+    /** Mapping of the whole file */
+    std::byte *m_mapping;
+
+    /** Length of the mapping */
+    size_t m_length;
+
+    /** Bytes written, header included */
+    size_t m_size;
+};
+
+/**
+ * @brief Trace reader class. Maps a trace file read-only for replay.
+ */
+class TraceReader {
+public:
+    /**
+     * @brief Public constructor that opens and maps a trace file
+     * @param path Path of the file
+     * @return A TraceReader object, or std::nullopt if the file could not be
+     * mapped or is not a trace
+     */
+    auto static open(const char *path) -> std::optional<TraceReader> {
+        const int descriptor = ::open(path, O_RDONLY);
+        if (descriptor < 0) {
+            return std::nullopt;
+        }
+        struct stat status = {};
+        if (::fstat(descriptor, &status) != 0 ||
+            static_cast<size_t>(status.st_size) < traceMagic.size()) {
+            ::close(descriptor);
+            return std::nullopt;
+        }
+        const auto length = static_cast<size_t>(status.st_size);
+        void *mapping =
+                ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        ::close(descriptor);
+        if (mapping == MAP_FAILED) {
+            return std::nullopt;
+        }
+        if (std::memcmp(mapping, traceMagic.data(), traceMagic.size()) != 0) {
+            ::munmap(mapping, length);
+            return std::nullopt;
+        }
+        return TraceReader(static_cast<const std::byte *>(mapping), length);
+    }
+
+    TraceReader(TraceReader &&other) noexcept :
+        m_mapping(std::exchange(other.m_mapping, nullptr)),
+        m_length(other.m_length) {}
+
+    TraceReader(const TraceReader &) = delete;
+    auto operator=(const TraceReader &) -> TraceReader & = delete;
+    auto operator=(TraceReader &&) -> TraceReader & = delete;
+
+    ~TraceReader() {
+        if (m_mapping != nullptr) {
+            ::munmap(const_cast<std::byte *>(m_mapping), m_length);
+        }
+    }
+
+    /**
+     * @brief The trace records
+     * @return The bytes of the file after its header
+     */
+    [[nodiscard]] auto records() const -> std::span<const std::byte> {
+        return {m_mapping + traceMagic.size(), m_length - traceMagic.size()};
+    }
+
+private:
+    /**
+     * @brief Private constructor
+     * @param mapping Mapping of the whole file
+     * @param length Length of the mapping
+     */
+    TraceReader(const std::byte *mapping, const size_t length) :
+        m_mapping(mapping), m_length(length) {}
+
+    /** Mapping of the whole file */
+    const std::byte *m_mapping;
+
+    /** Length of the mapping */
+    size_t m_length;
+};
+
+/**
+ * @brief Trace recorder class. A preallocated lock-free ring of trace records,
+ * written by the audio thread and flushed to a TraceFile by another thread.
+ * @details The audio thread never blocks, allocates or makes a system call:
+ * a record is copied into the ring, or dropped if the ring is full, and the
+ * next record that fits is flagged with traceGapFlag. flush() runs on any one
+ * other thread, as often as the ring needs to keep up, and copies whole
+ * records into the file, flagging the next record after one that no longer
+ * fit in the same way.
+ */
+class TraceRecorder {
+public:
+    /**
+     * @brief Public constructor that creates a trace recorder object
+     * @param capacity Minimum size of the ring in bytes, rounded up to a power
+     * of two
+     * @param resource Memory resource for the ring
+     * @return A TraceRecorder object if the arguments are valid, std::nullopt
+     * otherwise
+     */
+    auto static create(const size_t capacity,
+                       std::pmr::memory_resource *resource =
+                               std::pmr::get_default_resource())
+            -> std::optional<TraceRecorder> {
+        if (capacity < sizeof(TraceHeader) || resource == nullptr) {
+            return std::nullopt;
+        }
+        return std::optional<TraceRecorder>(std::in_place, capacity,
+                                            resource);
+    }
+
+    /**
+     * @brief Constructor. Use create()
+     * @param capacity Minimum size of the ring in bytes
+     * @param resource Memory resource for the ring
+     */
+    TraceRecorder(const size_t capacity, std::pmr::memory_resource *resource) :
+        m_ring(std::bit_ceil(capacity), resource), m_mask(m_ring.size() - 1) {}
+
+    TraceRecorder(const TraceRecorder &) = delete;
+    auto operator=(const TraceRecorder &) -> TraceRecorder & = delete;
+
+    /**
+     * @brief Start a record. Audio thread only
+     * @param event Kind of the record
+     * @param bytes Payload size, to be written with append()
+     * @return True if the record fits and must be finished with end(), false
+     * if it was dropped
+     */
+    auto begin(const TraceEvent event, const size_t bytes) -> bool {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        const size_t total = sizeof(TraceHeader) + bytes;
+        if (total > m_ring.size() - (tail - m_cachedHead)) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (total > m_ring.size() - (tail - m_cachedHead)) {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                m_gap = true;
+                return false;
+            }
+        }
+        m_header = {.event = static_cast<uint32_t>(event) |
+                             (m_gap ? traceGapFlag : 0),
+                    .bytes = static_cast<uint32_t>(bytes)};
+        m_gap = false;
+        m_write = tail + sizeof(TraceHeader);
+        return true;
+    }
+
+    /**
+     * @brief Append to the payload of the started record. Audio thread only
+     * @param data Pointer to the bytes
+     * @param bytes Number of bytes
+     */
+    auto append(const void *data, const size_t bytes) -> void {
+        copy_in(m_write, static_cast<const std::byte *>(data), bytes);
+        m_write += bytes;
+    }
+
+    /**
+     * @brief Finish and publish the started record. Audio thread only
+     * @param nanoseconds Processing time of a block, 0 otherwise
+     */
+    auto end(const uint64_t nanoseconds = 0) -> void {
+        m_header.nanoseconds = nanoseconds;
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        copy_in(tail, reinterpret_cast<const std::byte *>(&m_header),
+                sizeof(TraceHeader));
+        m_tail.store(m_write, std::memory_order_release);
+    }
+
+    /**
+     * @brief Write a whole record. Audio thread only
+     * @param event Kind of the record
+     * @param data Pointer to the payload
+     * @param bytes Payload size
+     * @return True if the record was written, false if it was dropped
+     */
+    auto record(const TraceEvent event, const void *data, const size_t bytes)
+            -> bool {
+        if (!begin(event, bytes)) {
+            return false;
+        }
+        if (bytes != 0) {
+            append(data, bytes);
+        }
+        end();
+        return true;
+    }
+
+    /**
+     * @brief Move every published record to a trace file. One flushing thread
+     * only
+     * @param file Trace file. Records that do not fit any more are discarded
+     * and counted as lost, and the next record that fits is flagged with
+     * traceGapFlag
+     * @return Number of bytes written to the file
+     */
+    auto flush(TraceFile &file) -> size_t {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        const size_t tail = m_tail.load(std::memory_order_acquire);
+        size_t written = 0;
+        while (head != tail) {
+            TraceHeader header;
+            copy_out(head, reinterpret_cast<std::byte *>(&header),
+                     sizeof(TraceHeader));
+            const size_t total = sizeof(TraceHeader) + header.bytes;
+            if (std::byte *destination = file.reserve(total)) {
+                copy_out(head, destination, total);
+                if (m_fileGap) {
+                    header.event |= traceGapFlag;
+                    std::memcpy(destination, &header, sizeof(TraceHeader));
+                    m_fileGap = false;
+                }
+                written += total;
+            } else {
+                m_lost.fetch_add(1, std::memory_order_relaxed);
+                m_fileGap = true;
+            }
+            head += total;
+        }
+        m_head.store(head, std::memory_order_release);
+        return written;
+    }
+
+    /**
+     * @brief Number of records dropped because the ring was full
+     * @return The number of records
+     */
+    [[nodiscard]] auto dropped() const -> size_t {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Number of records discarded because the file was full
+     * @return The number of records
+     */
+    [[nodiscard]] auto lost() const -> size_t {
+        return m_lost.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Size of the ring
+     * @return The capacity in bytes
+     */
+    [[nodiscard]] auto capacity() const -> size_t { return m_ring.size(); }
+
+private:
+    /** Destructive interference size, spelled out so it does not vary with
+     * compiler flags */
+    static constexpr size_t cacheLine = 64;
+
+    /**
+     * @brief Copy bytes into the ring, wrapping around its end
+     * @param position Unmasked ring position
+     * @param data Pointer to the bytes
+     * @param bytes Number of bytes
+     */
+    auto copy_in(const size_t position, const std::byte *data,
+                 const size_t bytes) -> void {
+        const size_t offset = position & m_mask;
+        const size_t first = std::min(bytes, m_ring.size() - offset);
+        std::memcpy(m_ring.data() + offset, data, first);
+        std::memcpy(m_ring.data(), data + first, bytes - first);
+    }
+
+    /**
+     * @brief Copy bytes out of the ring, wrapping around its end
+     * @param position Unmasked ring position
+     * @param data Destination of the bytes
+     * @param bytes Number of bytes
+     */
+    auto copy_out(const size_t position, std::byte *data,
+                  const size_t bytes) const -> void {
+        const size_t offset = position & m_mask;
+        const size_t first = std::min(bytes, m_ring.size() - offset);
+        std::memcpy(data, m_ring.data() + offset, first);
+        std::memcpy(data + first, m_ring.data(), bytes - first);
+    }
+
+    /** Ring of records, a power of two of bytes */
+    std::pmr::vector<std::byte> m_ring;
+
+    /** Ring size minus one */
+    size_t m_mask;
+
+    /** Number of records dropped because the ring was full */
+    std::atomic<size_t> m_dropped = 0;
+
+    /** Number of records discarded because the file was full */
+    std::atomic<size_t> m_lost = 0;
+
+    /** Next byte to flush, written by the flushing thread */
+    alignas(cacheLine) std::atomic<size_t> m_head = 0;
+
+    /** End of the published records, written by the audio thread */
+    alignas(cacheLine) std::atomic<size_t> m_tail = 0;
+
+    /** Audio thread's copy of m_head */
+    size_t m_cachedHead = 0;
+
+    /** Write position inside the started record */
+    size_t m_write = 0;
+
+    /** Header of the started record */
+    TraceHeader m_header;
+
+    /** Whether a record was dropped since the last one written */
+    bool m_gap = false;
+
+    /** Whether a record was lost since the last one flushed to a file,
+     * flushing thread only */
+    bool m_fileGap = false;
+};
+
+/**
+ * @brief Traced processor class. Wraps a processor and records its
+ * configurations, input blocks, resets and per-block processing time.
+ * @details The input of a block is copied into the recorder before it is
+ * processed in place, so a replay sees exactly what the processor saw. Blocks
+ * are timed with the steady clock around the processor's own process().
+ * @tparam P Type of the processor, Limiter, Compressor, Expander or NoiseGate
+ */
+template<typename P>
+class TracedProcessor {
+public:
+    using T = typename P::sample_type;
+    using Configuration = processor_configuration_t<P>;
+
+    static_assert(std::is_trivially_copyable_v<Configuration>);
+    static_assert(trace_processor_id<P> != 0);
+
+    /**
+     * @brief Public constructor that creates the processor and records its
+     * configuration
+     * @param configuration Processor configuration
+     * @param recorder Trace recorder, which must outlive the processor
+     * @return A TracedProcessor object if the processor could be created and
+     * its configuration recorded, std::nullopt otherwise
+     */
+    auto static create(Configuration configuration, TraceRecorder &recorder)
+            -> std::optional<TracedProcessor> {
+        std::optional<P> processor = P::create(configuration);
+        if (!processor.has_value() ||
+            !record_configuration(recorder, configuration)) {
+            return std::nullopt;
+        }
+        return TracedProcessor(std::move(*processor), recorder);
+    }
+
+    /**
+     * @brief Processes an array of samples in-place, recording the input and
+     * the processing time
+     * @param samples Pointer to the samples
+     * @param count Number of samples
+     */
+    auto process(T *samples, const size_t count) -> void {
+        const bool traced =
+                m_recorder->begin(TraceEvent::Block, count * sizeof(T));
+        if (traced) {
+            m_recorder->append(samples, count * sizeof(T));
+        }
+        const auto start = std::chrono::steady_clock::now();
+        m_processor.process(samples, count);
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        if (traced) {
+            m_recorder->end(static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            elapsed)
+                            .count()));
+        }
+    }
+
+    /**
+     * @brief Processes a contiguous span of samples in-place
+     * @param samples Span of samples
+     */
+    auto process(std::span<T> samples) -> void {
+        process(samples.data(), samples.size());
+    }
+
+    /**
+     * @brief Set the processor configuration and record it
+     * @param configuration Processor configuration
+     */
+    auto set_configuration(Configuration configuration) -> void
+        requires requires(P &processor, Configuration next) {
+            processor.set_configuration(next);
+        }
+    {
+        m_processor.set_configuration(configuration);
+        record_configuration(*m_recorder, configuration);
+    }
+
+    /**
+     * @brief Reset the processor and record it
+     */
+    auto reset() -> void {
+        m_processor.reset();
+        m_recorder->record(TraceEvent::Reset, nullptr, 0);
+    }
+
+    /**
+     * @brief The wrapped processor
+     * @return The processor, read-only
+     */
+    [[nodiscard]] auto processor() const -> const P & { return m_processor; }
+
+private:
+    /**
+     * @brief Private constructor
+     * @param processor Processor
+     * @param recorder Trace recorder
+     */
+    TracedProcessor(P processor, TraceRecorder &recorder) :
+        m_processor(std::move(processor)), m_recorder(&recorder) {}
+
+    /**
+     * @brief Record a configuration behind the processor type tag
+     * @param recorder Trace recorder
+     * @param configuration Processor configuration
+     * @return True if the record was written, false if it was dropped
+     */
+    static auto record_configuration(TraceRecorder &recorder,
+                                     const Configuration &configuration)
+            -> bool {
+        constexpr TraceProcessorTag tag = trace_processor_tag<P>();
+        if (!recorder.begin(TraceEvent::Configuration,
+                            sizeof(tag) + sizeof(Configuration))) {
+            return false;
+        }
+        recorder.append(&tag, sizeof(tag));
+        recorder.append(&configuration, sizeof(Configuration));
+        recorder.end();
+        return true;
+    }
+
+    /** Wrapped processor */
+    P m_processor;
+
+    /** Trace recorder */
+    TraceRecorder *m_recorder;
+};
+
+/**
+ * @brief One replayed block
+ * @tparam T Type of the samples
+ */
+template<typename T>
+struct TraceBlock {
+    /** Index of the block in the trace */
+    size_t index = 0;
+
+    /** Output of the replay, the recorded input processed in place */
+    std::span<const T> samples;
+
+    /** Processing time recorded on the audio thread, in nanoseconds */
+    uint64_t recordedNanoseconds = 0;
+
+    /** Processing time of the replay, in nanoseconds */
+    uint64_t replayedNanoseconds = 0;
+
+    /** Whether records were dropped since the previous block, after which
+     * the replayed state may differ from the recorded one */
+    bool gap = false;
+};
+
+/**
+ * @brief Re-run a trace through a fresh processor, deterministically, and
+ * time every block
+ * @details Configurations, resets and blocks are applied in recorded order
+ * and with the recorded block sizes, so unless the trace has gaps the replay
+ * output is bit-identical to what the processor produced when it was traced,
+ * on the same build. The processor is created from the first configuration
+ * record.
+ * @tparam P Type of the processor the trace was recorded with
+ * @tparam V Type of the visitor
+ * @param records Trace records, e.g. TraceReader::records()
+ * @param visitor Called with a TraceBlock<P::sample_type> after every block
+ * @param resource Memory resource for the block buffer
+ * @return Number of blocks replayed, or std::nullopt if the trace is
+ * malformed or its processor type tag does not match P
+ */
+template<typename P, typename V>
+auto replay_trace(std::span<const std::byte> records, V &&visitor,
+                  std::pmr::memory_resource *resource =
+                          std::pmr::get_default_resource())
+        -> std::optional<size_t> {
+    using T = typename P::sample_type;
+    using Configuration = processor_configuration_t<P>;
+    static_assert(trace_processor_id<P> != 0);
+    constexpr TraceProcessorTag expected = trace_processor_tag<P>();
+    std::optional<P> processor;
+    std::pmr::vector<T> buffer(resource);
+    size_t blocks = 0;
+    size_t position = 0;
+    bool gap = false;
+    while (records.size() - position >= sizeof(TraceHeader)) {
+        TraceHeader header;
+        std::memcpy(&header, records.data() + position, sizeof(TraceHeader));
+        position += sizeof(TraceHeader);
+        if (records.size() - position < header.bytes) {
+            return std::nullopt;
+        }
+        const std::byte *payload = records.data() + position;
+        position += header.bytes;
+        gap = gap || (header.event & traceGapFlag) != 0;
+        switch (static_cast<TraceEvent>(header.event & ~traceGapFlag)) {
+            case TraceEvent::Configuration: {
+                TraceProcessorTag tag;
+                if (header.bytes != sizeof(tag) + sizeof(Configuration)) {
+                    return std::nullopt;
+                }
+                std::memcpy(&tag, payload, sizeof(tag));
+                if (tag != expected) {
+                    return std::nullopt;
+                }
+                Configuration configuration;
+                std::memcpy(&configuration, payload + sizeof(tag),
+                            sizeof(Configuration));
+                if (!processor.has_value()) {
+                    processor = P::create(configuration);
+                    if (!processor.has_value()) {
+                        return std::nullopt;
+                    }
+                } else if constexpr (requires(P &p, Configuration next) {
+                                         p.set_configuration(next);
+                                     }) {
+                    processor->set_configuration(configuration);
+                } else {
+                    return std::nullopt;
+                }
+                break;
+            }
+            case TraceEvent::Block: {
+                if (!processor.has_value() || header.bytes % sizeof(T) != 0) {
+                    return std::nullopt;
+                }
+                buffer.resize(header.bytes / sizeof(T));
+                std::memcpy(buffer.data(), payload, header.bytes);
+                const auto start = std::chrono::steady_clock::now();
+                processor->process(buffer.data(), buffer.size());
+                const auto elapsed = std::chrono::steady_clock::now() - start;
+                visitor(TraceBlock<T>{
+                        .index = blocks++,
+                        .samples = buffer,
+                        .recordedNanoseconds = header.nanoseconds,
+                        .replayedNanoseconds = static_cast<uint64_t>(
+                                std::chrono::duration_cast<
+                                        std::chrono::nanoseconds>(elapsed)
+                                        .count()),
+                        .gap = gap});
+                gap = false;
+                break;
+            }
+            case TraceEvent::Reset:
+                if (!processor.has_value()) {
+                    return std::nullopt;
+                }
+                processor->reset();
+                break;
+            default:
+                return std::nullopt;
+        }
+    }
+    return blocks;
+}
+
+#endif // TRACE_RECORDER_H
@@ -0,0 +1,346 @@
+/// TransientShaper.h
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef TRANSIENT_SHAPER_H
+#define TRANSIENT_SHAPER_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "Compressor.h"
+#include "Denormal.h"
+
+/**
+ * @brief Transient shaper configuration
+ * @tparam T Type of the transient shaper
+ */
+template<typename T = double>
+struct TransientShaperConfiguration {
+    /** Sample rate */
+    int sampleRate = 0;
+
+    /** Attack time of the fast envelope in milliseconds */
+    std::chrono::milliseconds fastAttack = std::chrono::milliseconds(1);
+
+    /** Release time of the fast envelope in milliseconds */
+    std::chrono::milliseconds fastRelease = std::chrono::milliseconds(20);
+
+    /** Attack time of the slow envelope in milliseconds */
+    std::chrono::milliseconds slowAttack = std::chrono::milliseconds(20);
+
+    /** Release time of the slow envelope in milliseconds */
+    std::chrono::milliseconds slowRelease = std::chrono::milliseconds(200);
+
+    /** Gain in decibels at the peak of a transient, positive to emphasize
+     * attacks, negative to soften them */
+    T attackGain = static_cast<T>(0);
+
+    /** Gain in decibels at the bottom of a decay, positive to bring up the
+     * sustain, negative to tighten it */
+    T sustainGain = static_cast<T>(0);
+
+    /** Number of interleaved or planar channels */
+    size_t channels = 1;
+
+    /** Whether all channels share one detector and one gain */
+    bool linked = false;
+};
+
+/**
+ * @brief Transient shaper class. Emphasizes or softens attacks and sustain
+ * from the difference between a fast and a slow envelope.
+ * @details Both envelopes are peak followers with the same smoothing
+ * coefficients as the Compressor, and are updated in the same loop. While the
+ * fast envelope leads the slow one the signal is in an attack, and while it
+ * trails, in a decay. The gain is interpolated in the linear domain from
+ * those normalized differences,
+ * `1 + (attack - 1) * max(f - s, 0) / f + (sustain - 1) * max(s - f, 0) / s`,
+ * so there is no logarithm or power per sample and steady signals pass at
+ * unity.
+ *
+ * Unlinked channels have their own envelopes; with interleaved input the
+ * per-frame loop over channels is element-wise and vectorizes, and planar
+ * channels are processed one after the other. Linked channels are detected
+ * on the largest magnitude of each frame and share one gain.
+ * @tparam T Type of the transient shaper input and output samples
+ * @tparam S Type of the envelope state and coefficients
+ */
+template<typename T = double, typename S = T>
+class TransientShaper {
+public:
+    /** Type of the input and output samples */
+    using sample_type = T;
+
+    /** Type of the envelope state and coefficients */
+    using state_type = S;
+
+    /**
+     * @brief Public constructor that verifies the configuration and creates a
+     * transient shaper object
+     * @param configuration Transient shaper configuration
+     * @param resource Memory resource for the per-channel state
+     * @return A TransientShaper object if the configuration is valid,
+     * std::nullopt otherwise
+     */
+    auto static create(TransientShaperConfiguration<T> configuration,
+                       std::pmr::memory_resource *resource =
+                               std::pmr::get_default_resource())
+            -> std::optional<TransientShaper> {
+        if (configuration.sampleRate <= 0) {
+            return std::nullopt;
+        }
+        if (configuration.fastAttack.count() <= 0 ||
+            configuration.fastRelease.count() <= 0 ||
+            configuration.slowAttack.count() <= 0 ||
+            configuration.slowRelease.count() <= 0) {
+            return std::nullopt;
+        }
+        if (configuration.channels == 0 || resource == nullptr) {
+            return std::nullopt;
+        }
+        return TransientShaper(configuration, resource);
+    }
+
+    /**
+     * @brief Processes interleaved frames in-place
+     * @param samples Pointer to the samples
+     * @param count Number of samples, a multiple of the channel count
+     */
+    auto process(T *samples, const size_t count) -> void {
+        DenormalGuard guard;
+        const size_t channels = m_config.channels;
+        const size_t frames = count / channels;
+        if (m_config.linked) {
+            for (size_t i = 0; i < frames; i++) {
+                T *frame = samples + i * channels;
+                S level = static_cast<S>(0);
+                for (size_t c = 0; c < channels; c++) {
+                    level = std::max(level,
+                                     static_cast<S>(std::fabs(frame[c])));
+                }
+                const T gain = static_cast<T>(next_gain(level, 0));
+                for (size_t c = 0; c < channels; c++) {
+                    frame[c] *= gain;
+                }
+            }
+            return;
+        }
+        for (size_t i = 0; i < frames; i++) {
+            T *frame = samples + i * channels;
+            for (size_t c = 0; c < channels; c++) {
+                const S level = static_cast<S>(std::fabs(frame[c]));
+                frame[c] *= static_cast<T>(next_gain(level, c));
+            }
+        }
+    }
+
+    /**
+     * @brief Processes a contiguous span of interleaved frames in-place
+     * @param samples Span of samples
+     */
+    auto process(std::span<T> samples) -> void {
+        process(samples.data(), samples.size());
+    }
+
+    /**
+     * @brief Processes planar channels in-place
+     * @param channels One pointer per channel
+     * @param frames Number of samples in each channel
+     */
+    auto process(T *const *channels, const size_t frames) -> void {
+        DenormalGuard guard;
+        const size_t count = m_config.channels;
+        if (!m_config.linked) {
+            for (size_t c = 0; c < count; c++) {
+                T *channel = channels[c];
+                for (size_t i = 0; i < frames; i++) {
+                    const S level = static_cast<S>(std::fabs(channel[i]));
+                    channel[i] *= static_cast<T>(next_gain(level, c));
+                }
+            }
+            return;
+        }
+        /// Linked: one tile of shared gains, then one multiply per channel:
+        T *gains = m_gains.data();
+        for (size_t i = 0; i < frames; i += shaperTileSize) {
+            const size_t length = std::min(shaperTileSize, frames - i);
+            for (size_t n = 0; n < length; n++) {
+                S level = static_cast<S>(0);
+                for (size_t c = 0; c < count; c++) {
+                    const T sample = channels[c][i + n];
+                    level = std::max(level, static_cast<S>(std::fabs(sample)));
+                }
+                gains[n] = static_cast<T>(next_gain(level, 0));
+            }
+            for (size_t c = 0; c < count; c++) {
+                T *channel = channels[c] + i;
+                for (size_t n = 0; n < length; n++) {
+                    channel[n] *= gains[n];
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Resets both envelopes of every channel to silence
+     */
+    auto reset() -> void {
+        std::fill(m_fast.begin(), m_fast.end(), static_cast<S>(0));
+        std::fill(m_slow.begin(), m_slow.end(), static_cast<S>(0));
+    }
+
+    /**
+     * @brief Fast envelope of a channel
+     * @param channel Channel index, 0 when linked
+     * @return The linear level
+     */
+    [[nodiscard]] auto fast_envelope(const size_t channel) const -> S {
+        return m_fast[channel];
+    }
+
+    /**
+     * @brief Slow envelope of a channel
+     * @param channel Channel index, 0 when linked
+     * @return The linear level
+     */
+    [[nodiscard]] auto slow_envelope(const size_t channel) const -> S {
+        return m_slow[channel];
+    }
+
+    /**
+     * @brief Number of channels
+     * @return The number of channels
+     */
+    [[nodiscard]] auto channels() const -> size_t { return m_config.channels; }
+
+private:
+    /** Frames of shared gains computed at a time for linked planar input */
+    static constexpr size_t shaperTileSize = 256;
+
+    /**
+     * @brief Private constructor
+     * @param configuration Transient shaper configuration
+     * @param resource Memory resource for the per-channel state
+     */
+    TransientShaper(TransientShaperConfiguration<T> configuration,
+                    std::pmr::memory_resource *resource) :
+        m_config(configuration),
+        m_fast(configuration.linked ? 1 : configuration.channels, resource),
+        m_slow(configuration.linked ? 1 : configuration.channels, resource),
+        m_gains(configuration.linked ? shaperTileSize : 0, resource) {
+        calculate_intermediate_values();
+        reset();
+    }
+
+    /**
+     * @brief Advances both envelopes of a detector by one sample
+     * @param level Magnitude of the sample. A NaN reads as silence and
+     * infinities are clamped, so the envelopes stay finite
+     * @param channel Detector index
+     * @return The linear gain of the sample
+     */
+    auto next_gain(S level, const size_t channel) -> S {
+        constexpr S ceiling = static_cast<S>(1e10);
+        level = level >= static_cast<S>(0) ? std::min(level, ceiling)
+                                           : static_cast<S>(0);
+        S &fast = m_fast[channel];
+        S &slow = m_slow[channel];
+        const S fastCoefficient =
+                level > fast ? m_fastAttackValue : m_fastReleaseValue;
+        const S slowCoefficient =
+                level > slow ? m_slowAttackValue : m_slowReleaseValue;
+        fast = flush_denormal(fastCoefficient * (fast - level) + level);
+        slow = flush_denormal(slowCoefficient * (slow - level) + level);
+        constexpr S tiny = std::numeric_limits<S>::min();
+        const S difference = fast - slow;
+        const S attack = std::max(difference, static_cast<S>(0)) /
+                         std::max(fast, tiny);
+        const S sustain = std::max(-difference, static_cast<S>(0)) /
+                          std::max(slow, tiny);
+        return static_cast<S>(1) + m_attackDepth * attack +
+               m_sustainDepth * sustain;
+    }
+
+    /**
+     * @brief Calculate intermediate values
+     */
+    auto calculate_intermediate_values() -> void {
+        const int sampleRate = m_config.sampleRate;
+        m_fastAttackValue =
+                Compressor<T, S>::time_coefficient(m_config.fastAttack,
+                                                   sampleRate);
+        m_fastReleaseValue =
+                Compressor<T, S>::time_coefficient(m_config.fastRelease,
+                                                   sampleRate);
+        m_slowAttackValue =
+                Compressor<T, S>::time_coefficient(m_config.slowAttack,
+                                                   sampleRate);
+        m_slowReleaseValue =
+                Compressor<T, S>::time_coefficient(m_config.slowRelease,
+                                                   sampleRate);
+        m_attackDepth = static_cast<S>(
+                std::pow(10.0, m_config.attackGain / 20.0) - 1.0);
+        m_sustainDepth = static_cast<S>(
+                std::pow(10.0, m_config.sustainGain / 20.0) - 1.0);
+    }
+
+    /** Transient shaper configuration */
+    TransientShaperConfiguration<T> m_config;
+
+    /** Fast envelope attack coefficient */
+    S m_fastAttackValue = 0.0;
+
+    /** Fast envelope release coefficient */
+    S m_fastReleaseValue = 0.0;
+
+    /** Slow envelope attack coefficient */
+    S m_slowAttackValue = 0.0;
+
+    /** Slow envelope release coefficient */
+    S m_slowReleaseValue = 0.0;
+
+    /** Linear attack gain minus one */
+    S m_attackDepth = 0.0;
+
+    /** Linear sustain gain minus one */
+    S m_sustainDepth = 0.0;
+
+    /** Fast envelope, one per detector */
+    std::pmr::vector<S> m_fast;
+
+    /** Slow envelope, one per detector */
+    std::pmr::vector<S> m_slow;
+
+    /** Shared gains of one tile of linked planar input */
+    std::pmr::vector<T> m_gains;
+};
+
+#endif // TRANSIENT_SHAPER_H
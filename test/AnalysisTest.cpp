@@ -0,0 +1,135 @@
+/// AnalysisTest.cpp
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include "Analysis.h"
+#include "Compressor.h"
+#include "Expander.h"
+#include "Limiter.h"
+#include "SampleView.h"
+
+namespace {
+auto sweep() -> std::vector<double> {
+    std::vector<double> levels;
+    for (double level = -100.0; level <= 6.0; level += 0.25) {
+        levels.push_back(level);
+    }
+    return levels;
+}
+
+auto compressors() -> std::vector<Compressor<double>> {
+    std::vector<Compressor<double>> processors;
+    for (int i = 0; i < 8; i++) {
+        auto config = CompressorConfiguration<double>{
+                .sampleRate = 48000,
+                .threshold = -40.0 + 4.0 * i,
+                .attack = std::chrono::milliseconds(1 + 3 * i),
+                .release = std::chrono::milliseconds(20 + 30 * i),
+                .ratio = 1.5 + i,
+                .makeupGain = 1.0};
+        if (i % 2 == 0) {
+            config.kneeWidth = 2.0 + i;
+        }
+        processors.push_back(*Compressor<double>::create(config));
+    }
+    return processors;
+}
+} // namespace
+
+TEST(AnalysisTest, StaticCharacteristicMatchesTargetGain) {
+    const std::vector<double> levels = sweep();
+    std::vector<double> output(levels.size());
+    for (const Compressor<double> &compressor: compressors()) {
+        compressor.static_characteristic(levels, output);
+        for (size_t i = 0; i < levels.size(); i++) {
+            ASSERT_EQ(output[i] - levels[i], compressor.target_gain(levels[i]));
+        }
+    }
+    const std::optional<Limiter<float>> limiter =
+            Limiter<float>::create({.sampleRate = 48000,
+                                    .threshold = -6.0f,
+                                    .attack = std::chrono::milliseconds(1),
+                                    .release = std::chrono::milliseconds(50),
+                                    .kneeWidth = 4.0f});
+    const std::optional<Expander<float>> expander =
+            Expander<float>::create({.sampleRate = 48000,
+                                     .threshold = -40.0f,
+                                     .attack = std::chrono::milliseconds(1),
+                                     .release = std::chrono::milliseconds(50),
+                                     .ratio = 3.0f,
+                                     .kneeWidth = 6.0f});
+    std::vector<float> levelsFloat(levels.begin(), levels.end());
+    std::vector<float> outputFloat(levels.size());
+    limiter->static_characteristic(levelsFloat, outputFloat);
+    for (size_t i = 0; i < levels.size(); i++) {
+        ASSERT_EQ(outputFloat[i] - levelsFloat[i],
+                  limiter->target_gain(levelsFloat[i]));
+    }
+    expander->static_characteristic(levelsFloat, outputFloat);
+    for (size_t i = 0; i < levels.size(); i++) {
+        ASSERT_EQ(outputFloat[i] - levelsFloat[i],
+                  expander->target_gain(levelsFloat[i]));
+    }
+}
+
+TEST(AnalysisTest, TransferCurveMatchesSteadyState) {
+    const std::vector<Compressor<double>> processors = compressors();
+    const std::vector<double> levels = {-60.0, -30.0, -12.0, -3.0};
+    std::vector<double> curves(processors.size() * levels.size());
+    transfer_curves<Compressor<double>>(processors, levels, curves);
+    for (size_t k = 0; k < processors.size(); k++) {
+        for (size_t i = 0; i < levels.size(); i++) {
+            Compressor<double> compressor = processors[k];
+            const double input = std::pow(10.0, levels[i] / 20.0);
+            std::vector<double> samples(96000, input);
+            compressor.process(samples.data(), samples.size());
+            ASSERT_NEAR(20.0 * std::log10(samples.back()),
+                        curves[k * levels.size() + i], 1e-6);
+        }
+    }
+}
+
+TEST(AnalysisTest, StepResponseMatchesProcess) {
+    const std::vector<Compressor<double>> processors = compressors();
+    constexpr size_t length = 4800;
+    std::vector<double> responses(processors.size() * length);
+    step_responses<Compressor<double>>(processors, -80.0, -6.0, length,
+                                       responses);
+    for (size_t k = 0; k < processors.size(); k++) {
+        /// A fresh processor is settled at -80 dB, which is below every
+        /// threshold:
+        Compressor<double> compressor = processors[k];
+        const double input = std::pow(10.0, -6.0 / 20.0);
+        std::vector<double> samples(length, input);
+        compressor.process(samples.data(), samples.size());
+        const StridedView<double> response{
+                responses.data() + k, length,
+                static_cast<std::ptrdiff_t>(processors.size())};
+        for (size_t n = 0; n < length; n++) {
+            ASSERT_NEAR(20.0 * std::log10(samples[n] / input), response[n],
+                        1e-9);
+        }
+    }
+}
+
+TEST(AnalysisTest, ProcessorsAreNotTouched) {
+    const std::vector<Compressor<double>> processors = compressors();
+    std::vector<double> responses(processors.size() * 100);
+    step_responses<Compressor<double>>(processors, -80.0, 0.0, 100,
+                                       responses);
+    Compressor<double> analysed = processors[3];
+    std::optional<Compressor<double>> fresh = Compressor<double>::create(
+            {.sampleRate = 48000,
+             .threshold = -28.0,
+             .attack = std::chrono::milliseconds(10),
+             .release = std::chrono::milliseconds(110),
+             .ratio = 4.5,
+             .makeupGain = 1.0});
+    std::vector<double> a(1000, 0.5);
+    std::vector<double> b(1000, 0.5);
+    analysed.process(a.data(), a.size());
+    fresh->process(b.data(), b.size());
+    EXPECT_EQ(a, b);
+}
@@ -0,0 +1,177 @@
+/// AutomixerTest.cpp
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "Automixer.h"
+
+namespace {
+constexpr auto baseConfig = AutomixerConfiguration<float>{
+        .sampleRate = 48000,
+        .channels = 4,
+        .attack = std::chrono::milliseconds(1),
+        .release = std::chrono::milliseconds(50)};
+
+/// Interleaved frames with a tone of the given amplitude on each channel
+auto signal(const std::vector<float> &amplitudes, const size_t frames)
+        -> std::vector<float> {
+    const size_t channels = amplitudes.size();
+    std::vector<float> samples(channels * frames);
+    for (size_t i = 0; i < frames; i++) {
+        for (size_t c = 0; c < channels; c++) {
+            samples[i * channels + c] =
+                    amplitudes[c] *
+                    std::sin(0.05f * static_cast<float>(i) +
+                             static_cast<float>(c));
+        }
+    }
+    return samples;
+}
+
+auto gain_sum(const Automixer<float> &automixer) -> float {
+    float sum = 0.0f;
+    for (size_t c = 0; c < automixer.channels(); c++) {
+        sum += automixer.gain(c);
+    }
+    return sum;
+}
+} // namespace
+
+TEST(AutomixerTest, CreateAutomixerSuccess) {
+    const std::optional<Automixer<float>> automixer =
+            Automixer<float>::create(baseConfig);
+    ASSERT_TRUE(automixer.has_value());
+}
+
+TEST(AutomixerTest, CreateAutomixerFailureInvalidSampleRate) {
+    AutomixerConfiguration<float> config = baseConfig;
+    config.sampleRate = 0;
+    const std::optional<Automixer<float>> automixer =
+            Automixer<float>::create(config);
+    ASSERT_FALSE(automixer.has_value());
+}
+
+TEST(AutomixerTest, CreateAutomixerFailureInvalidAttack) {
+    AutomixerConfiguration<float> config = baseConfig;
+    config.attack = std::chrono::milliseconds(0);
+    const std::optional<Automixer<float>> automixer =
+            Automixer<float>::create(config);
+    ASSERT_FALSE(automixer.has_value());
+}
+
+TEST(AutomixerTest, CreateAutomixerFailureZeroChannels) {
+    AutomixerConfiguration<float> config = baseConfig;
+    config.channels = 0;
+    const std::optional<Automixer<float>> automixer =
+            Automixer<float>::create(config);
+    ASSERT_FALSE(automixer.has_value());
+}
+
+TEST(AutomixerTest, CreateAutomixerFailureZeroControlInterval) {
+    AutomixerConfiguration<float> config = baseConfig;
+    config.controlInterval = 0;
+    const std::optional<Automixer<float>> automixer =
+            Automixer<float>::create(config);
+    ASSERT_FALSE(automixer.has_value());
+}
+
+TEST(AutomixerTest, SingleTalkerOpensOnlyTheirMicrophone) {
+    auto automixer = Automixer<float>::create(baseConfig);
+    ASSERT_TRUE(automixer.has_value());
+    std::vector<float> samples = signal({0.0f, 0.5f, 0.001f, 0.001f}, 9600);
+    automixer->process(samples.data(), samples.size());
+    EXPECT_GT(automixer->gain(1), 0.99f);
+    EXPECT_LT(automixer->gain(0), 0.001f);
+    EXPECT_LT(automixer->gain(2), 0.01f);
+    EXPECT_LT(automixer->gain(3), 0.01f);
+    EXPECT_NEAR(gain_sum(*automixer), 1.0f, 1e-5f);
+}
+
+TEST(AutomixerTest, EqualTalkersShareTheGain) {
+    auto automixer = Automixer<float>::create(baseConfig);
+    ASSERT_TRUE(automixer.has_value());
+    std::vector<float> samples = signal({0.3f, 0.3f, 0.0f, 0.0f}, 9600);
+    automixer->process(samples.data(), samples.size());
+    EXPECT_NEAR(automixer->gain(0), 0.5f, 0.05f);
+    EXPECT_NEAR(automixer->gain(1), 0.5f, 0.05f);
+    EXPECT_NEAR(gain_sum(*automixer), 1.0f, 1e-5f);
+}
+
+TEST(AutomixerTest, LastMicHoldKeepsTheTalkerOpen) {
+    AutomixerConfiguration<float> config = baseConfig;
+    auto holding = Automixer<float>::create(config);
+    config.lastMicHold = false;
+    auto sharing = Automixer<float>::create(config);
+    ASSERT_TRUE(holding.has_value());
+    ASSERT_TRUE(sharing.has_value());
+    std::vector<float> talk = signal({0.0f, 0.0f, 0.5f, 0.0f}, 4800);
+    std::vector<float> copy = talk;
+    holding->process(talk.data(), talk.size());
+    sharing->process(copy.data(), copy.size());
+    std::vector<float> silence(4 * 48000, 0.0f);
+    holding->process(silence.data(), silence.size());
+    sharing->process(silence.data(), silence.size());
+    EXPECT_GT(holding->gain(2), 0.99f);
+    for (size_t c = 0; c < 4; c++) {
+        EXPECT_FLOAT_EQ(sharing->gain(c), 0.25f);
+    }
+}
+
+TEST(AutomixerTest, PlanarMatchesInterleaved) {
+    AutomixerConfiguration<float> config = baseConfig;
+    config.controlInterval = 16;
+    auto interleaved = Automixer<float>::create(config);
+    auto planar = Automixer<float>::create(config);
+    ASSERT_TRUE(interleaved.has_value());
+    ASSERT_TRUE(planar.has_value());
+    constexpr size_t frames = 1000;
+    std::vector<float> samples = signal({0.2f, 0.05f, 0.6f, 0.01f}, frames);
+    std::vector<std::vector<float>> channels(4, std::vector<float>(frames));
+    for (size_t i = 0; i < frames; i++) {
+        for (size_t c = 0; c < 4; c++) {
+            channels[c][i] = samples[i * 4 + c];
+        }
+    }
+    float *pointers[] = {channels[0].data(), channels[1].data(),
+                         channels[2].data(), channels[3].data()};
+    interleaved->process(samples.data(), samples.size());
+    planar->process(pointers, frames);
+    for (size_t i = 0; i < frames; i++) {
+        for (size_t c = 0; c < 4; c++) {
+            EXPECT_EQ(channels[c][i], samples[i * 4 + c]);
+        }
+    }
+}
+
+TEST(AutomixerTest, RecoversFromNaN) {
+    auto automixer = Automixer<float>::create(baseConfig);
+    ASSERT_TRUE(automixer.has_value());
+    std::vector<float> samples = signal({0.0f, 0.5f, 0.0f, 0.0f}, 9600);
+    samples[4 * 100] = std::numeric_limits<float>::quiet_NaN();
+    automixer->process(samples.data(), samples.size());
+    EXPECT_TRUE(std::isfinite(automixer->envelope(0)));
+    EXPECT_GT(automixer->gain(1), 0.99f);
+    EXPECT_NEAR(gain_sum(*automixer), 1.0f, 1e-5f);
+    for (size_t i = 4 * 4800; i < samples.size(); i++) {
+        ASSERT_TRUE(std::isfinite(samples[i])) << i;
+    }
+    /// An infinity is clamped, so the gains stay finite and keep summing
+    /// to one:
+    samples[4 * 100 + 2] = std::numeric_limits<float>::infinity();
+    automixer->process(samples.data(), samples.size());
+    EXPECT_TRUE(std::isfinite(automixer->envelope(2)));
+    EXPECT_NEAR(gain_sum(*automixer), 1.0f, 1e-5f);
+}
+
+TEST(AutomixerTest, ResetRestoresEqualGains) {
+    auto automixer = Automixer<float>::create(baseConfig);
+    ASSERT_TRUE(automixer.has_value());
+    std::vector<float> samples = signal({0.5f, 0.0f, 0.0f, 0.0f}, 4800);
+    automixer->process(samples.data(), samples.size());
+    automixer->reset();
+    for (size_t c = 0; c < 4; c++) {
+        EXPECT_FLOAT_EQ(automixer->gain(c), 0.25f);
+        EXPECT_EQ(automixer->envelope(c), 0.0f);
+    }
+}
@@ -0,0 +1,153 @@
+/// BlockAdapterTest.cpp
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "BlockAdapter.h"
+#include "Compressor.h"
+#include "QualityTier.h"
+
+namespace {
+/// Records the blocks it is given and adds their index to every sample
+struct BlockRecorder {
+    using sample_type = float;
+
+    auto process(float *samples, const size_t count) -> void {
+        sizes.push_back(count);
+        aligned = aligned && reinterpret_cast<uintptr_t>(samples) % 64 == 0;
+        for (size_t i = 0; i < count; i++) {
+            samples[i] += static_cast<float>(sizes.size());
+        }
+    }
+
+    auto reset() -> void { sizes.clear(); }
+
+    std::vector<size_t> sizes;
+    bool aligned = true;
+};
+
+auto make_compressor() -> Compressor<float> {
+    return *Compressor<float>::create(
+            {.sampleRate = 48000,
+             .threshold = -20.0f,
+             .attack = std::chrono::milliseconds(2),
+             .release = std::chrono::milliseconds(30),
+             .ratio = 4.0f,
+             .makeupGain = 1.0f});
+}
+
+auto signal(const size_t count) -> std::vector<float> {
+    std::vector<float> samples(count);
+    for (size_t i = 0; i < count; i++) {
+        samples[i] = 0.9f * std::sin(0.02f * static_cast<float>(i)) *
+                     std::sin(0.0007f * static_cast<float>(i));
+    }
+    return samples;
+}
+
+/// Feeds a signal through in calls of awkward, varying sizes
+template<typename A>
+auto feed(A &adapter, std::vector<float> &samples) -> void {
+    const size_t sizes[] = {1, 37, 441, 3, 64, 200};
+    size_t offset = 0;
+    for (size_t call = 0; offset < samples.size(); call++) {
+        const size_t count = std::min(sizes[call % 6], samples.size() - offset);
+        adapter.process(samples.data() + offset, count);
+        offset += count;
+    }
+}
+} // namespace
+
+TEST(BlockAdapterTest, CreateBlockAdapterSuccess) {
+    const std::optional<BlockAdapter<BlockRecorder>> adapter =
+            BlockAdapter<BlockRecorder>::create({}, {.blockSize = 1});
+    ASSERT_TRUE(adapter.has_value());
+}
+
+TEST(BlockAdapterTest, CreateBlockAdapterFailureZeroBlockSize) {
+    const std::optional<BlockAdapter<BlockRecorder>> adapter =
+            BlockAdapter<BlockRecorder>::create({}, {.blockSize = 0});
+    ASSERT_FALSE(adapter.has_value());
+}
+
+TEST(BlockAdapterTest, CreateBlockAdapterFailureBlockSizeNotPowerOfTwo) {
+    const std::optional<BlockAdapter<BlockRecorder>> adapter =
+            BlockAdapter<BlockRecorder>::create({}, {.blockSize = 48});
+    ASSERT_FALSE(adapter.has_value());
+}
+
+TEST(BlockAdapterTest, ProcessorSeesOnlyFullAlignedBlocks) {
+    auto adapter = BlockAdapter<BlockRecorder>::create({}, {.blockSize = 32});
+    ASSERT_TRUE(adapter.has_value());
+    std::vector<float> samples(1000, 0.0f);
+    feed(*adapter, samples);
+    EXPECT_EQ(adapter->processor().sizes, std::vector<size_t>(31, 32));
+    EXPECT_TRUE(adapter->processor().aligned);
+    EXPECT_EQ(adapter->latency(), 32);
+    /// Nothing comes out before the first block, then block k carries k:
+    for (size_t i = 0; i < samples.size(); i++) {
+        EXPECT_EQ(samples[i], static_cast<float>(i / 32)) << i;
+    }
+}
+
+TEST(BlockAdapterTest, DelayedOutputMatchesTheProcessor) {
+    Compressor<float> compressor = make_compressor();
+    auto adapter =
+            BlockAdapter<Compressor<float>>::create(compressor,
+                                                    {.blockSize = 64});
+    ASSERT_TRUE(adapter.has_value());
+    std::vector<float> samples = signal(5000);
+    std::vector<float> expected = samples;
+    feed(*adapter, samples);
+    compressor.process(expected.data(), expected.size());
+    for (size_t i = 0; i < 64; i++) {
+        EXPECT_EQ(samples[i], 0.0f);
+    }
+    for (size_t i = 64; i < samples.size(); i++) {
+        EXPECT_EQ(samples[i], expected[i - 64]);
+    }
+}
+
+TEST(BlockAdapterTest, ZeroLatencyKeepsTheBlockGrid) {
+    auto recorder = BlockAdapter<BlockRecorder>::create(
+            {}, {.blockSize = 16, .zeroLatency = true});
+    ASSERT_TRUE(recorder.has_value());
+    std::vector<float> samples(100, 0.0f);
+    recorder->process(samples.data(), 37);
+    recorder->process(samples.data() + 37, 63);
+    EXPECT_EQ(recorder->processor().sizes,
+              (std::vector<size_t>{16, 16, 5, 11, 16, 16, 16, 4}));
+    EXPECT_EQ(recorder->latency(), 0);
+}
+
+TEST(BlockAdapterTest, ControlRateMatchesFixedBlocks) {
+    auto tiered =
+            TieredProcessor<Compressor<float>>::create(make_compressor(), 16);
+    ASSERT_TRUE(tiered.has_value());
+    tiered->set_tier(QualityTier::ControlRate);
+    auto adapter = BlockAdapter<TieredProcessor<Compressor<float>>>::create(
+            *tiered, {.blockSize = 64});
+    ASSERT_TRUE(adapter.has_value());
+    std::vector<float> samples = signal(4096);
+    std::vector<float> expected = samples;
+    feed(*adapter, samples);
+    for (size_t i = 0; i < expected.size(); i += 64) {
+        tiered->process(expected.data() + i, 64);
+    }
+    for (size_t i = 64; i < samples.size(); i++) {
+        EXPECT_EQ(samples[i], expected[i - 64]);
+    }
+}
+
+TEST(BlockAdapterTest, ResetEmptiesTheBlocks) {
+    auto adapter = BlockAdapter<BlockRecorder>::create({}, {.blockSize = 8});
+    ASSERT_TRUE(adapter.has_value());
+    std::vector<float> samples(12, 0.0f);
+    adapter->process(samples.data(), samples.size());
+    adapter->reset();
+    std::vector<float> after(8, 0.0f);
+    adapter->process(after.data(), after.size());
+    EXPECT_EQ(after, std::vector<float>(8, 0.0f));
+    EXPECT_EQ(adapter->processor().sizes, std::vector<size_t>{8});
+}
@@ -110,3 +110,127 @@ TEST(CompressorTest, ResetCompressor) {
     limiter->process(sample);
     ASSERT_LT(sample, 1.0f);
 }
+
+TEST(CompressorTest, ProcessStridedViewMatchesContiguous) {
+    constexpr auto config = CompressorConfiguration<float>{
+            .sampleRate = 48000,
+            .threshold = -10.0f,
+            .attack = std::chrono::milliseconds(10),
+            .release = std::chrono::milliseconds(100),
+            .ratio = 5.0f,
+            .makeupGain = 5.0f,
+            .kneeWidth = 5.0f};
+    std::optional<Compressor<float>> contiguous =
+            Compressor<float>::create(config);
+    std::optional<Compressor<float>> strided =
+            Compressor<float>::create(config);
+    ASSERT_TRUE(contiguous.has_value());
+    ASSERT_TRUE(strided.has_value());
+    std::vector<float> mono = {1.0f, 0.5f, 0.25f, 0.9f, 0.05f, 0.7f};
+    std::vector<float> stereo(mono.size() * 2);
+    for (size_t i = 0; i < mono.size(); i++) {
+        stereo[2 * i] = 0.3f;
+        stereo[2 * i + 1] = mono[i];
+    }
+    contiguous->process(mono);
+    strided->process(interleaved_channel(stereo.data(), mono.size(), 2, 1));
+    for (size_t i = 0; i < mono.size(); i++) {
+        ASSERT_FLOAT_EQ(stereo[2 * i], 0.3f);
+        ASSERT_FLOAT_EQ(stereo[2 * i + 1], mono[i]);
+    }
+}
+
+TEST(CompressorTest, ProcessSegmentsMatchesContiguous) {
+    constexpr auto config = CompressorConfiguration<float>{
+            .sampleRate = 48000,
+            .threshold = -10.0f,
+            .attack = std::chrono::milliseconds(10),
+            .release = std::chrono::milliseconds(100),
+            .ratio = 5.0f,
+            .makeupGain = 5.0f,
+            .kneeWidth = 5.0f};
+    std::optional<Compressor<float>> contiguous =
+            Compressor<float>::create(config);
+    std::optional<Compressor<float>> segmented =
+            Compressor<float>::create(config);
+    ASSERT_TRUE(contiguous.has_value());
+    ASSERT_TRUE(segmented.has_value());
+    std::vector<float> samples = {1.0f, 0.5f, 0.25f, 0.9f, 0.05f, 0.7f};
+    std::vector<float> first(samples.begin(), samples.begin() + 2);
+    std::vector<float> second(samples.begin() + 2, samples.end());
+    const std::array<std::span<float>, 2> segments = {first, second};
+    contiguous->process(samples);
+    segmented->process(segments);
+    for (size_t i = 0; i < first.size(); i++) {
+        ASSERT_FLOAT_EQ(first[i], samples[i]);
+    }
+    for (size_t i = 0; i < second.size(); i++) {
+        ASSERT_FLOAT_EQ(second[i], samples[first.size() + i]);
+    }
+}
+
+TEST(CompressorTest, MixedPrecisionMatchesDoublePath) {
+    constexpr auto floatConfig = CompressorConfiguration<float>{
+            .sampleRate = 48000,
+            .threshold = -10.0f,
+            .attack = std::chrono::milliseconds(10),
+            .release = std::chrono::milliseconds(100),
+            .ratio = 5.0f,
+            .makeupGain = 1.0f,
+            .kneeWidth = 5.0f};
+    constexpr auto doubleConfig = CompressorConfiguration<double>{
+            .sampleRate = 48000,
+            .threshold = -10.0,
+            .attack = std::chrono::milliseconds(10),
+            .release = std::chrono::milliseconds(100),
+            .ratio = 5.0,
+            .makeupGain = 1.0,
+            .kneeWidth = 5.0};
+    std::optional<Compressor<float, double>> mixed =
+            Compressor<float, double>::create(floatConfig);
+    std::optional<Compressor<double>> reference =
+            Compressor<double>::create(doubleConfig);
+    ASSERT_TRUE(mixed.has_value());
+    ASSERT_TRUE(reference.has_value());
+    for (size_t i = 0; i < 48000; i++) {
+        const double input = 0.05 + 0.9 * static_cast<double>((i * 37) % 101) /
+                                             101.0;
+        float mixedSample = static_cast<float>(input);
+        double referenceSample = static_cast<float>(input);
+        mixed->process(mixedSample);
+        reference->process(referenceSample);
+        /// Only the float I/O and curve evaluation are quantized, so the
+        /// result stays within a few float ulps of the all-double path:
+        ASSERT_NEAR(mixedSample, referenceSample,
+                    8 * std::numeric_limits<float>::epsilon() *
+                            std::fabs(referenceSample));
+    }
+}
+
+TEST(CompressorTest, ComputeGainMatchesProcess) {
+    constexpr auto config = CompressorConfiguration<float>{
+            .sampleRate = 48000,
+            .threshold = -10.0f,
+            .attack = std::chrono::milliseconds(10),
+            .release = std::chrono::milliseconds(100),
+            .ratio = 5.0f,
+            .makeupGain = 1.0f,
+            .kneeWidth = 5.0f};
+    std::optional<Compressor<float>> processed =
+            Compressor<float>::create(config);
+    std::optional<Compressor<float>> detector =
+            Compressor<float>::create(config);
+    ASSERT_TRUE(processed.has_value());
+    ASSERT_TRUE(detector.has_value());
+    std::vector<float> samples(4800);
+    for (size_t i = 0; i < samples.size(); i++) {
+        samples[i] = 0.05f + 0.9f * static_cast<float>((i * 37) % 101) / 101.0f;
+    }
+    std::vector<float> gains(samples.size());
+    detector->compute_gain(samples.data(), gains.data(), samples.size());
+    const std::vector<float> input = samples;
+    processed->process(samples.data(), samples.size());
+    for (size_t i = 0; i < samples.size(); i++) {
+        ASSERT_EQ(input[i] * gains[i], samples[i]);
+    }
+}
@@ -0,0 +1,191 @@
+/// DeEsserTest.cpp
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <type_traits>
+#include <vector>
+#include "DeEsser.h"
+
+namespace {
+constexpr auto baseConfig = DeEsserConfiguration<double>{
+        .sampleRate = 48000,
+        .frequency = 7000.0,
+        .q = 1.5,
+        .threshold = -30.0,
+        .attack = std::chrono::milliseconds(1),
+        .release = std::chrono::milliseconds(50),
+        .ratio = 6.0};
+
+auto tone(const double frequency, const size_t count, const double amplitude)
+        -> std::vector<double> {
+    std::vector<double> samples(count);
+    for (size_t i = 0; i < count; i++) {
+        samples[i] = amplitude * std::sin(2.0 * std::numbers::pi * frequency *
+                                          static_cast<double>(i) / 48000.0);
+    }
+    return samples;
+}
+
+auto rms(const std::vector<double> &samples, const size_t begin) -> double {
+    double sum = 0.0;
+    for (size_t i = begin; i < samples.size(); i++) {
+        sum += samples[i] * samples[i];
+    }
+    return std::sqrt(sum / static_cast<double>(samples.size() - begin));
+}
+} // namespace
+
+TEST(DeEsserTest, CreateDeEsserSuccess) {
+    const std::optional<DeEsser<float>> deEsser =
+            DeEsser<float>::create({.sampleRate = 48000,
+                                    .threshold = -30.0f,
+                                    .attack = std::chrono::milliseconds(1),
+                                    .release = std::chrono::milliseconds(50),
+                                    .ratio = 4.0f});
+    ASSERT_TRUE(deEsser.has_value());
+}
+
+TEST(DeEsserTest, CreateDeEsserFailureInvalidFrequency) {
+    auto config = baseConfig;
+    config.frequency = 30000.0;
+    ASSERT_FALSE(DeEsser<double>::create(config).has_value());
+    config.frequency = 7000.0;
+    config.channels = 0;
+    ASSERT_FALSE(DeEsser<double>::create(config).has_value());
+}
+
+TEST(DeEsserTest, SplitBandAttenuatesSibilanceOnly) {
+    std::optional<DeEsser<double>> deEsser =
+            DeEsser<double>::create(baseConfig);
+    ASSERT_TRUE(deEsser.has_value());
+    std::vector<double> sibilance = tone(7000.0, 24000, 0.5);
+    const double before = rms(sibilance, 12000);
+    deEsser->process(sibilance.data(), sibilance.size());
+    EXPECT_LT(rms(sibilance, 12000), 0.5 * before);
+
+    deEsser->reset();
+    const std::vector<double> voice = tone(200.0, 24000, 0.5);
+    std::vector<double> samples = voice;
+    deEsser->process(samples.data(), samples.size());
+    for (size_t i = 0; i < samples.size(); i++) {
+        ASSERT_NEAR(samples[i], voice[i], 1e-3);
+    }
+}
+
+TEST(DeEsserTest, SplitBandIsTransparentBelowThreshold) {
+    std::optional<DeEsser<double>> deEsser =
+            DeEsser<double>::create(baseConfig);
+    ASSERT_TRUE(deEsser.has_value());
+    const std::vector<double> input = tone(7000.0, 4800, 0.001);
+    std::vector<double> samples = input;
+    deEsser->process(samples.data(), samples.size());
+    for (size_t i = 0; i < samples.size(); i++) {
+        ASSERT_EQ(samples[i], input[i]);
+    }
+}
+
+TEST(DeEsserTest, WidebandAttenuatesWholeSignal) {
+    auto config = baseConfig;
+    config.mode = DeEsserMode::Wideband;
+    std::optional<DeEsser<double>> deEsser = DeEsser<double>::create(config);
+    ASSERT_TRUE(deEsser.has_value());
+    const std::vector<double> voice = tone(200.0, 24000, 0.3);
+    const std::vector<double> sibilance = tone(7000.0, 24000, 0.5);
+    std::vector<double> samples(24000);
+    for (size_t i = 0; i < samples.size(); i++) {
+        samples[i] = voice[i] + sibilance[i];
+    }
+    deEsser->process(samples.data(), samples.size());
+    EXPECT_LT(deEsser->gain(), -6.0);
+}
+
+TEST(DeEsserTest, HighShelfDetector) {
+    auto config = baseConfig;
+    config.frequency = 3500.0;
+    config.q = 0.7071;
+    config.detector = DeEsserDetector::HighShelf;
+    config.threshold = -3.0;
+    std::optional<DeEsser<double>> deEsser = DeEsser<double>::create(config);
+    ASSERT_TRUE(deEsser.has_value());
+    std::vector<double> sibilance = tone(8000.0, 24000, 0.5);
+    const double before = rms(sibilance, 12000);
+    deEsser->process(sibilance.data(), sibilance.size());
+    EXPECT_LT(rms(sibilance, 12000), 0.8 * before);
+}
+
+TEST(DeEsserTest, MultichannelMatchesMono) {
+    auto config = baseConfig;
+    config.channels = 3;
+    std::optional<DeEsser<double>> multichannel =
+            DeEsser<double>::create(config);
+    ASSERT_TRUE(multichannel.has_value());
+    std::vector<std::vector<double>> channels = {tone(7000.0, 4800, 0.5),
+                                                 tone(300.0, 4800, 0.8),
+                                                 tone(5000.0, 4800, 0.1)};
+    std::vector<double> interleaved(3 * 4800);
+    for (size_t i = 0; i < 4800; i++) {
+        for (size_t c = 0; c < 3; c++) {
+            interleaved[3 * i + c] = channels[c][i];
+        }
+    }
+    std::vector<std::vector<double>> planar = channels;
+    multichannel->process(interleaved.data(), interleaved.size());
+
+    std::optional<DeEsser<double>> planarDeEsser =
+            DeEsser<double>::create(config);
+    ASSERT_TRUE(planarDeEsser.has_value());
+    double *pointers[] = {planar[0].data(), planar[1].data(),
+                          planar[2].data()};
+    planarDeEsser->process(pointers, 4800);
+
+    for (size_t c = 0; c < 3; c++) {
+        std::optional<DeEsser<double>> mono =
+                DeEsser<double>::create(baseConfig);
+        mono->process(channels[c].data(), channels[c].size());
+        for (size_t i = 0; i < 4800; i++) {
+            ASSERT_DOUBLE_EQ(interleaved[3 * i + c], channels[c][i]);
+            ASSERT_DOUBLE_EQ(planar[c][i], channels[c][i]);
+        }
+    }
+}
+
+TEST(DeEsserTest, RecoversFromNaN) {
+    for (const DeEsserMode mode: {DeEsserMode::SplitBand,
+                                  DeEsserMode::Wideband}) {
+        auto config = baseConfig;
+        config.mode = mode;
+        std::optional<DeEsser<double>> deEsser =
+                DeEsser<double>::create(config);
+        std::optional<DeEsser<double>> reference =
+                DeEsser<double>::create(config);
+        ASSERT_TRUE(deEsser.has_value());
+        ASSERT_TRUE(reference.has_value());
+        std::vector<double> samples = tone(7000.0, 4800, 0.5);
+        std::vector<double> expected = samples;
+        /// The detector reads a NaN or an infinity as silence:
+        samples[100] = std::numeric_limits<double>::quiet_NaN();
+        samples[200] = std::numeric_limits<double>::infinity();
+        expected[100] = 0.0;
+        expected[200] = 0.0;
+        deEsser->process(samples.data(), samples.size());
+        reference->process(expected.data(), expected.size());
+        EXPECT_EQ(deEsser->gain(), reference->gain());
+        for (size_t i = 201; i < samples.size(); i++) {
+            ASSERT_EQ(samples[i], expected[i]) << i;
+        }
+    }
+}
+
+TEST(DeEsserTest, SingleSampleNeedsMono) {
+    static_assert(!std::is_copy_constructible_v<DeEsser<double>>);
+    auto config = baseConfig;
+    config.channels = 2;
+    std::optional<DeEsser<double>> deEsser = DeEsser<double>::create(config);
+    ASSERT_TRUE(deEsser.has_value());
+    double sample = 0.5;
+    deEsser->process(sample);
+    EXPECT_EQ(sample, 0.5);
+    EXPECT_EQ(deEsser->gain(0), 0.0);
+}
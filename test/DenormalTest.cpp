@@ -0,0 +1,123 @@
+/// DenormalTest.cpp
+
+#include <gtest/gtest.h>
+#include <limits>
+#include <vector>
+#include "Compressor.h"
+#include "Denormal.h"
+#include "LoudnessNormalizer.h"
+#include "NoiseGate.h"
+
+TEST(DenormalTest, GuardFlushesSubnormals) {
+    if (!DenormalGuard::supported) {
+        GTEST_SKIP() << "No flush-to-zero mode on this platform";
+    }
+    volatile float tiny = std::numeric_limits<float>::min();
+    volatile float half = 0.5f;
+    {
+        DenormalGuard guard;
+        const float flushed = tiny * half;
+        EXPECT_EQ(flushed, 0.0f);
+        {
+            DenormalGuard nested;
+        }
+        const float stillFlushed = tiny * half;
+        EXPECT_EQ(stillFlushed, 0.0f);
+    }
+    const float subnormal = tiny * half;
+    EXPECT_GT(subnormal, 0.0f);
+}
+
+TEST(DenormalTest, FlushDenormal) {
+    constexpr double smallest = std::numeric_limits<double>::min();
+    EXPECT_EQ(flush_denormal(smallest / 2.0), 0.0);
+    EXPECT_EQ(flush_denormal(-smallest / 2.0), 0.0);
+    EXPECT_EQ(flush_denormal(smallest), smallest);
+    EXPECT_EQ(flush_denormal(-0.25), -0.25);
+}
+
+TEST(DenormalTest, LevelDecibelsIsFinite) {
+    EXPECT_DOUBLE_EQ(level_decibels(0.0), -200.0);
+    EXPECT_DOUBLE_EQ(level_decibels(-0.5), level_decibels(0.5));
+    EXPECT_DOUBLE_EQ(level_decibels(std::numeric_limits<double>::quiet_NaN()),
+                     -200.0);
+    EXPECT_DOUBLE_EQ(level_decibels(std::numeric_limits<double>::infinity()),
+                     200.0);
+    EXPECT_FLOAT_EQ(level_decibels(0.0f), -200.0f);
+}
+
+TEST(DenormalTest, CompressorStaysFiniteThroughSilence) {
+    constexpr auto config = CompressorConfiguration<float>{
+            .sampleRate = 48000,
+            .threshold = -10.0f,
+            .attack = std::chrono::milliseconds(10),
+            .release = std::chrono::milliseconds(100),
+            .ratio = 4.0f,
+            .makeupGain = 1.0f};
+    std::optional<Compressor<float>> compressor =
+            Compressor<float>::create(config);
+    ASSERT_TRUE(compressor.has_value());
+    std::vector<float> samples(48000);
+    for (size_t i = 0; i < samples.size(); i++) {
+        /// Loud bipolar signal, then silence, then the signal again:
+        const float sign = (i % 2) == 0 ? 1.0f : -1.0f;
+        samples[i] = (i / 16000) == 1 ? 0.0f : sign * 0.9f;
+    }
+    compressor->process(samples.data(), samples.size());
+    for (size_t i = 0; i < samples.size(); i++) {
+        ASSERT_TRUE(std::isfinite(samples[i])) << "at sample " << i;
+    }
+    /// Negative samples are compressed like positive ones:
+    EXPECT_FLOAT_EQ(samples[47998], -samples[47999]);
+    EXPECT_LT(samples[47999], 0.9f);
+}
+
+TEST(DenormalTest, SmoothGainFlushesSubnormals) {
+    constexpr auto config = CompressorConfiguration<double>{
+            .sampleRate = 48000,
+            .threshold = -10.0,
+            .attack = std::chrono::milliseconds(10),
+            .release = std::chrono::milliseconds(100),
+            .ratio = 4.0,
+            .makeupGain = 1.0};
+    const std::optional<Compressor<double>> compressor =
+            Compressor<double>::create(config);
+    ASSERT_TRUE(compressor.has_value());
+    /// One release step from the smallest normal value goes subnormal:
+    const double smallest = std::numeric_limits<double>::min();
+    EXPECT_EQ(compressor->smooth_gain(-smallest, 0.0), 0.0);
+}
+
+TEST(DenormalTest, NoiseGatePassesNegativeSamples) {
+    constexpr auto config = NoiseGateConfiguration<double>{
+            .sampleRate = 48000,
+            .threshold = -10.0,
+            .attack = std::chrono::milliseconds(10),
+            .release = std::chrono::milliseconds(100)};
+    std::optional<NoiseGate<double>> noiseGate =
+            NoiseGate<double>::create(config);
+    ASSERT_TRUE(noiseGate.has_value());
+    std::vector<double> samples(96000, 0.0);
+    samples.back() = -0.5;
+    noiseGate->process(samples.data(), samples.size());
+    EXPECT_DOUBLE_EQ(samples.back(), -0.5);
+}
+
+TEST(DenormalTest, LoudnessNormalizerStaysFiniteThroughSilence) {
+    constexpr auto config = LoudnessNormalizerConfiguration<float>{
+            .sampleRate = 48000,
+            .attack = std::chrono::milliseconds(100),
+            .release = std::chrono::milliseconds(1000)};
+    std::optional<LoudnessNormalizer<float>> normalizer =
+            LoudnessNormalizer<float>::create(config);
+    ASSERT_TRUE(normalizer.has_value());
+    std::vector<float> samples(96000, 0.0f);
+    for (size_t i = 0; i < 24000; i++) {
+        samples[i] = (i % 2) == 0 ? 0.3f : -0.3f;
+    }
+    normalizer->process(samples.data(), samples.size());
+    EXPECT_TRUE(std::isfinite(normalizer->gain()));
+    for (const float sample: samples) {
+        ASSERT_TRUE(std::isfinite(sample));
+    }
+}
@@ -0,0 +1,67 @@
+/// FftTest.cpp
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <complex>
+#include <numbers>
+#include <random>
+#include <vector>
+#include "Fft.h"
+
+TEST(FftTest, CreateFftSuccess) {
+    const std::optional<Fft<double>> fft = Fft<double>::create(4);
+    ASSERT_TRUE(fft.has_value());
+}
+
+TEST(FftTest, CreateFftFailureTooSmall) {
+    ASSERT_FALSE(Fft<double>::create(0).has_value());
+    ASSERT_FALSE(Fft<double>::create(2).has_value());
+}
+
+TEST(FftTest, CreateFftFailureNotPowerOfTwo) {
+    const std::optional<Fft<double>> fft = Fft<double>::create(1000);
+    ASSERT_FALSE(fft.has_value());
+}
+
+TEST(FftTest, ForwardMatchesDft) {
+    for (const size_t size: {4u, 8u, 64u, 512u}) {
+        std::optional<Fft<double>> fft = Fft<double>::create(size);
+        ASSERT_TRUE(fft.has_value());
+        std::mt19937 engine(static_cast<unsigned>(size));
+        std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+        std::vector<double> input(size);
+        for (double &sample: input) {
+            sample = uniform(engine);
+        }
+        std::vector<std::complex<double>> spectrum(size / 2 + 1);
+        fft->forward(input.data(), spectrum.data());
+        for (size_t k = 0; k <= size / 2; k++) {
+            std::complex<double> expected = 0.0;
+            for (size_t n = 0; n < size; n++) {
+                expected += input[n] *
+                            std::polar(1.0, -2.0 * std::numbers::pi *
+                                                    static_cast<double>(k * n) /
+                                                    static_cast<double>(size));
+            }
+            EXPECT_NEAR(spectrum[k].real(), expected.real(), 1e-11) << k;
+            EXPECT_NEAR(spectrum[k].imag(), expected.imag(), 1e-11) << k;
+        }
+    }
+}
+
+TEST(FftTest, InverseUndoesForward) {
+    std::optional<Fft<float>> fft = Fft<float>::create(1024);
+    ASSERT_TRUE(fft.has_value());
+    std::vector<float> input(1024);
+    for (size_t n = 0; n < input.size(); n++) {
+        input[n] = std::sin(0.1f * static_cast<float>(n)) +
+                   0.25f * std::cos(1.7f * static_cast<float>(n));
+    }
+    std::vector<std::complex<float>> spectrum(513);
+    std::vector<float> output(1024);
+    fft->forward(input.data(), spectrum.data());
+    fft->inverse(spectrum.data(), output.data());
+    for (size_t n = 0; n < input.size(); n++) {
+        EXPECT_NEAR(output[n], input[n], 1e-5f) << n;
+    }
+}
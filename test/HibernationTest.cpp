@@ -0,0 +1,186 @@
+/// HibernationTest.cpp
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "Compressor.h"
+#include "Expander.h"
+#include "Hibernation.h"
+#include "Limiter.h"
+#include "NoiseGate.h"
+
+namespace {
+constexpr size_t blockSize = 512;
+
+constexpr auto compressorConfig = CompressorConfiguration<float>{
+        .sampleRate = 48000,
+        .threshold = -20.0f,
+        .attack = std::chrono::milliseconds(5),
+        .release = std::chrono::milliseconds(50),
+        .ratio = 4.0f};
+
+/// Loud blocks, a long silence, then loud again from the middle of a block
+template<typename T>
+auto make_signal(const size_t silentBlocks) -> std::vector<T> {
+    std::vector<T> samples((silentBlocks + 40) * blockSize, static_cast<T>(0));
+    for (size_t i = 0; i < samples.size(); i++) {
+        const size_t block = i / blockSize;
+        const size_t wake = 20 + silentBlocks;
+        const bool loud = block < 20 || block > wake ||
+                          (block == wake && i % blockSize > 100);
+        if (loud) {
+            samples[i] = static_cast<T>(0.8 * std::sin(0.05 * i));
+        }
+    }
+    return samples;
+}
+
+/// Process the signal block by block with and without hibernation
+template<typename P, typename Configuration>
+auto expect_bit_identical(const Configuration configuration,
+                          const size_t silentBlocks) -> HibernationStatistics {
+    using T = typename P::sample_type;
+    std::optional<P> awake = P::create(configuration);
+    if (!awake.has_value()) {
+        ADD_FAILURE() << "create() failed";
+        return {};
+    }
+    std::optional<Hibernating<P>> sleepy = Hibernating<P>::create(*awake, 4);
+    if (!sleepy.has_value()) {
+        ADD_FAILURE() << "create() failed";
+        return {};
+    }
+    std::vector<T> a = make_signal<T>(silentBlocks);
+    std::vector<T> b = a;
+    for (size_t i = 0; i < a.size(); i += blockSize) {
+        awake->process(a.data() + i, blockSize);
+        sleepy->process(b.data() + i, blockSize);
+    }
+    for (size_t i = 0; i < a.size(); i++) {
+        EXPECT_EQ(std::signbit(a[i]), std::signbit(b[i])) << i;
+        EXPECT_EQ(a[i], b[i]) << i;
+    }
+    EXPECT_FALSE(sleepy->hibernating());
+    return sleepy->hibernation();
+}
+} // namespace
+
+TEST(HibernationTest, AllBelow) {
+    const std::vector<float> samples = {0.0f, -0.0f, 0.25f, -0.5f, NAN};
+    EXPECT_TRUE(all_below(samples.data(), 2, 0.0f));
+    EXPECT_FALSE(all_below(samples.data(), 3, 0.0f));
+    EXPECT_TRUE(all_below(samples.data(), samples.size(), 0.5f));
+    EXPECT_FALSE(all_below(samples.data(), samples.size(), 0.25));
+    EXPECT_TRUE(all_below(samples.data() + 4, 1, 0.0f));
+}
+
+TEST(HibernationTest, HibernatesAfterIdleBlocks) {
+    Hibernation hibernation;
+    EXPECT_FALSE(hibernation.block(true, 2));
+    EXPECT_FALSE(hibernation.block(true, 2));
+    EXPECT_TRUE(hibernation.block(true, 2));
+    EXPECT_TRUE(hibernation.hibernating());
+    EXPECT_TRUE(hibernation.block(true, 2));
+    EXPECT_FALSE(hibernation.block(false, 2));
+    EXPECT_FALSE(hibernation.hibernating());
+    EXPECT_FALSE(hibernation.block(true, 0));
+    EXPECT_EQ(hibernation.statistics().hibernations, 1u);
+    EXPECT_EQ(hibernation.statistics().hibernatedBlocks, 2u);
+    EXPECT_EQ(hibernation.statistics().wakes, 1u);
+}
+
+TEST(HibernationTest, CompressorWakesBitIdentical) {
+    const HibernationStatistics statistics =
+            expect_bit_identical<Compressor<float>>(
+                    CompressorConfiguration<float>{
+                            .sampleRate = 48000,
+                            .threshold = -20.0f,
+                            .attack = std::chrono::milliseconds(5),
+                            .release = std::chrono::milliseconds(50),
+                            .ratio = 4.0f,
+                            .kneeWidth = 6.0f},
+                    600);
+    EXPECT_EQ(statistics.hibernations, 1u);
+    EXPECT_EQ(statistics.wakes, 1u);
+    EXPECT_GT(statistics.hibernatedBlocks, 100u);
+}
+
+TEST(HibernationTest, LimiterWakesBitIdentical) {
+    const HibernationStatistics statistics =
+            expect_bit_identical<Limiter<float, double>>(
+                    LimiterConfiguration<float>{
+                            .sampleRate = 48000,
+                            .threshold = -10.0f,
+                            .attack = std::chrono::milliseconds(1),
+                            .release = std::chrono::milliseconds(5)},
+                    600);
+    EXPECT_EQ(statistics.hibernations, 1u);
+    EXPECT_EQ(statistics.wakes, 1u);
+}
+
+TEST(HibernationTest, ExpanderWakesBitIdentical) {
+    const HibernationStatistics statistics =
+            expect_bit_identical<Expander<double>>(
+                    ExpanderConfiguration<double>{
+                            .sampleRate = 48000,
+                            .threshold = -40.0,
+                            .attack = std::chrono::milliseconds(5),
+                            .release = std::chrono::milliseconds(50),
+                            .ratio = 2.0},
+                    100);
+    EXPECT_EQ(statistics.hibernations, 1u);
+    EXPECT_EQ(statistics.wakes, 1u);
+    EXPECT_GT(statistics.hibernatedBlocks, 50u);
+}
+
+TEST(HibernationTest, NoiseGateWakesBitIdentical) {
+    const HibernationStatistics statistics =
+            expect_bit_identical<NoiseGate<float>>(
+                    NoiseGateConfiguration<float>{
+                            .sampleRate = 48000,
+                            .threshold = -30.0f,
+                            .attack = std::chrono::milliseconds(1),
+                            .release = std::chrono::milliseconds(5)},
+                    600);
+    EXPECT_EQ(statistics.hibernations, 1u);
+    EXPECT_EQ(statistics.wakes, 1u);
+}
+
+TEST(HibernationTest, NeverHibernatesWhileNotSettled) {
+    const std::optional<Compressor<float>> inner = Compressor<float>::create(
+            {.sampleRate = 48000,
+             .threshold = -20.0f,
+             .attack = std::chrono::milliseconds(5),
+             .release = std::chrono::milliseconds(1000),
+             .ratio = 4.0f});
+    ASSERT_TRUE(inner.has_value());
+    auto compressor = Hibernating<Compressor<float>>::create(*inner, 1);
+    ASSERT_TRUE(compressor.has_value());
+    std::vector<float> samples(blockSize, 0.9f);
+    compressor->process(samples.data(), samples.size());
+    /// A few blocks of silence, while the gain is still releasing:
+    for (int i = 0; i < 10; i++) {
+        std::fill(samples.begin(), samples.end(), 0.0f);
+        compressor->process(samples.data(), samples.size());
+    }
+    EXPECT_FALSE(compressor->hibernating());
+    EXPECT_EQ(compressor->hibernation().hibernations, 0u);
+}
+
+TEST(HibernationTest, CreateHibernatingSuccess) {
+    const std::optional<Compressor<float>> compressor =
+            Compressor<float>::create(compressorConfig);
+    ASSERT_TRUE(compressor.has_value());
+    const std::optional<Hibernating<Compressor<float>>> hibernating =
+            Hibernating<Compressor<float>>::create(*compressor);
+    ASSERT_TRUE(hibernating.has_value());
+}
+
+TEST(HibernationTest, CreateHibernatingFailureZeroBlocks) {
+    const std::optional<Compressor<float>> compressor =
+            Compressor<float>::create(compressorConfig);
+    ASSERT_TRUE(compressor.has_value());
+    const std::optional<Hibernating<Compressor<float>>> hibernating =
+            Hibernating<Compressor<float>>::create(*compressor, 0);
+    ASSERT_FALSE(hibernating.has_value());
+}
@@ -100,3 +100,80 @@ TEST(LimiterTest, ResetLimiter) {
     limiter->process(sample);
     ASSERT_LT(sample, 1.0f);
 }
+
+TEST(LimiterTest, ProcessStridedViewMatchesContiguous) {
+    constexpr auto config = LimiterConfiguration<float>{
+            .sampleRate = 48000,
+            .threshold = -10.0f,
+            .attack = std::chrono::milliseconds(10),
+            .release = std::chrono::milliseconds(100),
+            .makeupGain = 5.0f,
+            .kneeWidth = 5.0f};
+    std::optional<Limiter<float>> contiguous = Limiter<float>::create(config);
+    std::optional<Limiter<float>> strided = Limiter<float>::create(config);
+    ASSERT_TRUE(contiguous.has_value());
+    ASSERT_TRUE(strided.has_value());
+    std::vector<float> mono = {1.0f, 0.5f, 0.25f, 0.9f, 0.05f, 0.7f};
+    std::vector<float> stereo(mono.size() * 2);
+    for (size_t i = 0; i < mono.size(); i++) {
+        stereo[2 * i] = 0.3f;
+        stereo[2 * i + 1] = mono[i];
+    }
+    contiguous->process(mono);
+    strided->process(interleaved_channel(stereo.data(), mono.size(), 2, 1));
+    for (size_t i = 0; i < mono.size(); i++) {
+        ASSERT_FLOAT_EQ(stereo[2 * i], 0.3f);
+        ASSERT_FLOAT_EQ(stereo[2 * i + 1], mono[i]);
+    }
+}
+
+TEST(LimiterTest, ProcessSegmentsMatchesContiguous) {
+    constexpr auto config = LimiterConfiguration<float>{
+            .sampleRate = 48000,
+            .threshold = -10.0f,
+            .attack = std::chrono::milliseconds(10),
+            .release = std::chrono::milliseconds(100),
+            .makeupGain = 5.0f,
+            .kneeWidth = 5.0f};
+    std::optional<Limiter<float>> contiguous = Limiter<float>::create(config);
+    std::optional<Limiter<float>> segmented = Limiter<float>::create(config);
+    ASSERT_TRUE(contiguous.has_value());
+    ASSERT_TRUE(segmented.has_value());
+    std::vector<float> samples = {1.0f, 0.5f, 0.25f, 0.9f, 0.05f, 0.7f};
+    std::vector<float> first(samples.begin(), samples.begin() + 2);
+    std::vector<float> second(samples.begin() + 2, samples.end());
+    const std::array<std::span<float>, 2> segments = {first, second};
+    contiguous->process(samples);
+    segmented->process(segments);
+    for (size_t i = 0; i < first.size(); i++) {
+        ASSERT_FLOAT_EQ(first[i], samples[i]);
+    }
+    for (size_t i = 0; i < second.size(); i++) {
+        ASSERT_FLOAT_EQ(second[i], samples[first.size() + i]);
+    }
+}
+
+TEST(LimiterTest, ComputeGainMatchesProcess) {
+    constexpr auto config = LimiterConfiguration<float>{
+            .sampleRate = 48000,
+            .threshold = -10.0f,
+            .attack = std::chrono::milliseconds(10),
+            .release = std::chrono::milliseconds(100),
+            .makeupGain = 5.0f,
+            .kneeWidth = 5.0f};
+    std::optional<Limiter<float>> processed = Limiter<float>::create(config);
+    std::optional<Limiter<float>> detector = Limiter<float>::create(config);
+    ASSERT_TRUE(processed.has_value());
+    ASSERT_TRUE(detector.has_value());
+    std::vector<float> samples(4800);
+    for (size_t i = 0; i < samples.size(); i++) {
+        samples[i] = 0.05f + 0.9f * static_cast<float>((i * 37) % 101) / 101.0f;
+    }
+    std::vector<float> gains(samples.size());
+    detector->compute_gain(samples.data(), gains.data(), samples.size());
+    const std::vector<float> input = samples;
+    processed->process(samples.data(), samples.size());
+    for (size_t i = 0; i < samples.size(); i++) {
+        ASSERT_EQ(input[i] * gains[i], samples[i]);
+    }
+}
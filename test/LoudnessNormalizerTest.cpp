@@ -0,0 +1,178 @@
+/// LoudnessNormalizerTest.cpp
+
+#include <gtest/gtest.h>
+#include <numbers>
+#include <vector>
+#include "LoudnessNormalizer.h"
+
+namespace {
+auto make_sine(const int sampleRate, const double amplitude,
+               const double seconds) -> std::vector<double> {
+    std::vector<double> samples(static_cast<size_t>(sampleRate * seconds));
+    for (size_t i = 0; i < samples.size(); i++) {
+        samples[i] = amplitude * std::sin(2.0 * std::numbers::pi * 997.0 *
+                                          static_cast<double>(i) / sampleRate);
+    }
+    return samples;
+}
+} // namespace
+
+TEST(LoudnessNormalizerTest, CreateLoudnessNormalizerSuccess) {
+    constexpr auto config = LoudnessNormalizerConfiguration<float>{
+            .sampleRate = 48000,
+            .targetLoudness = -23.0f,
+            .attack = std::chrono::milliseconds(100),
+            .release = std::chrono::milliseconds(1000),
+            .maxGain = 12.0f};
+    const std::optional<LoudnessNormalizer<float>> normalizer =
+            LoudnessNormalizer<float>::create(config);
+    ASSERT_TRUE(normalizer.has_value());
+}
+
+TEST(LoudnessNormalizerTest, CreateLoudnessNormalizerFailureInvalidSampleRate) {
+    constexpr auto config = LoudnessNormalizerConfiguration<float>{
+            .sampleRate = 0,
+            .targetLoudness = -23.0f,
+            .attack = std::chrono::milliseconds(100),
+            .release = std::chrono::milliseconds(1000)};
+    const std::optional<LoudnessNormalizer<float>> normalizer =
+            LoudnessNormalizer<float>::create(config);
+    ASSERT_FALSE(normalizer.has_value());
+}
+
+TEST(LoudnessNormalizerTest, CreateLoudnessNormalizerFailureInvalidAttack) {
+    constexpr auto config = LoudnessNormalizerConfiguration<float>{
+            .sampleRate = 48000,
+            .targetLoudness = -23.0f,
+            .attack = std::chrono::milliseconds(0),
+            .release = std::chrono::milliseconds(1000)};
+    const std::optional<LoudnessNormalizer<float>> normalizer =
+            LoudnessNormalizer<float>::create(config);
+    ASSERT_FALSE(normalizer.has_value());
+}
+
+TEST(LoudnessNormalizerTest, MeasureReferenceSine) {
+    /// A 997 Hz sine at -20 dBFS peak reads -23.01 LUFS per ITU-R BS.1770:
+    constexpr auto config = LoudnessNormalizerConfiguration<double>{
+            .sampleRate = 48000,
+            .targetLoudness = -23.0,
+            .attack = std::chrono::milliseconds(100),
+            .release = std::chrono::milliseconds(1000)};
+    std::optional<LoudnessNormalizer<double>> normalizer =
+            LoudnessNormalizer<double>::create(config);
+    ASSERT_TRUE(normalizer.has_value());
+    std::vector<double> samples = make_sine(48000, 0.1, 5.0);
+    normalizer->process(samples);
+    ASSERT_NEAR(normalizer->momentary_loudness(), -23.01, 0.05);
+    ASSERT_NEAR(normalizer->short_term_loudness(), -23.01, 0.05);
+    ASSERT_NEAR(normalizer->integrated_loudness(), -23.01, 0.1);
+}
+
+TEST(LoudnessNormalizerTest, IntegratedLoudnessGatesSilence) {
+    constexpr auto config = LoudnessNormalizerConfiguration<double>{
+            .sampleRate = 48000,
+            .targetLoudness = -23.0,
+            .window = LoudnessWindow::Integrated,
+            .attack = std::chrono::milliseconds(100),
+            .release = std::chrono::milliseconds(1000)};
+    std::optional<LoudnessNormalizer<double>> normalizer =
+            LoudnessNormalizer<double>::create(config);
+    ASSERT_TRUE(normalizer.has_value());
+    std::vector<double> tone = make_sine(48000, 0.1, 5.0);
+    std::vector<double> silence(48000 * 5, 0.0);
+    normalizer->process(tone);
+    normalizer->process(silence);
+    /// Silent blocks are gated out; the few blocks straddling the end of the
+    /// tone still pass the relative gate and pull the result down slightly:
+    ASSERT_NEAR(normalizer->integrated_loudness(), -23.01, 0.2);
+}
+
+TEST(LoudnessNormalizerTest, ProcessConvergesToTarget) {
+    constexpr auto config = LoudnessNormalizerConfiguration<double>{
+            .sampleRate = 48000,
+            .targetLoudness = -16.0,
+            .attack = std::chrono::milliseconds(100),
+            .release = std::chrono::milliseconds(500),
+            .maxGain = 20.0};
+    std::optional<LoudnessNormalizer<double>> normalizer =
+            LoudnessNormalizer<double>::create(config);
+    ASSERT_TRUE(normalizer.has_value());
+    /// -29 LUFS input needs +13 dB:
+    std::vector<double> samples = make_sine(48000, 0.05, 20.0);
+    normalizer->process(samples);
+    ASSERT_NEAR(normalizer->gain(), 13.0, 0.1);
+    double peak = 0.0;
+    for (size_t i = samples.size() - 4800; i < samples.size(); i++) {
+        peak = std::max(peak, std::fabs(samples[i]));
+    }
+    ASSERT_NEAR(20.0 * std::log10(peak), -26.0 + 13.0, 0.1);
+}
+
+TEST(LoudnessNormalizerTest, ProcessRespectsMaxGain) {
+    constexpr auto config = LoudnessNormalizerConfiguration<double>{
+            .sampleRate = 48000,
+            .targetLoudness = -16.0,
+            .attack = std::chrono::milliseconds(100),
+            .release = std::chrono::milliseconds(500),
+            .maxGain = 6.0};
+    std::optional<LoudnessNormalizer<double>> normalizer =
+            LoudnessNormalizer<double>::create(config);
+    ASSERT_TRUE(normalizer.has_value());
+    std::vector<double> samples = make_sine(48000, 0.05, 20.0);
+    normalizer->process(samples);
+    ASSERT_NEAR(normalizer->gain(), 6.0, 0.01);
+}
+
+TEST(LoudnessNormalizerTest, RecoversFromNaN) {
+    constexpr auto config = LoudnessNormalizerConfiguration<float>{
+            .sampleRate = 48000,
+            .targetLoudness = -16.0f,
+            .window = LoudnessWindow::Integrated,
+            .attack = std::chrono::milliseconds(100),
+            .release = std::chrono::milliseconds(500),
+            .maxGain = 20.0f};
+    std::optional<LoudnessNormalizer<float>> normalizer =
+            LoudnessNormalizer<float>::create(config);
+    std::optional<LoudnessNormalizer<float>> reference =
+            LoudnessNormalizer<float>::create(config);
+    ASSERT_TRUE(normalizer.has_value());
+    ASSERT_TRUE(reference.has_value());
+    const std::vector<double> sine = make_sine(48000, 0.05, 5.0);
+    std::vector<float> samples(sine.begin(), sine.end());
+    std::vector<float> expected = samples;
+    /// The filters read a NaN or an infinity as silence, so the result only
+    /// differs from the clean signal by one sample's worth of energy:
+    samples[1000] = std::numeric_limits<float>::quiet_NaN();
+    samples[2000] = std::numeric_limits<float>::infinity();
+    expected[1000] = 0.0f;
+    expected[2000] = 0.0f;
+    normalizer->process(samples.data(), samples.size());
+    reference->process(expected.data(), expected.size());
+    ASSERT_TRUE(std::isfinite(normalizer->gain()));
+    ASSERT_TRUE(std::isfinite(normalizer->integrated_loudness()));
+    EXPECT_NEAR(normalizer->gain(), reference->gain(), 1e-4f);
+    EXPECT_NEAR(normalizer->integrated_loudness(),
+                reference->integrated_loudness(), 1e-4f);
+    for (size_t i = 2001; i < samples.size(); i++) {
+        ASSERT_TRUE(std::isfinite(samples[i])) << i;
+    }
+}
+
+TEST(LoudnessNormalizerTest, ResetLoudnessNormalizer) {
+    constexpr auto config = LoudnessNormalizerConfiguration<double>{
+            .sampleRate = 48000,
+            .targetLoudness = -23.0,
+            .attack = std::chrono::milliseconds(100),
+            .release = std::chrono::milliseconds(1000)};
+    std::optional<LoudnessNormalizer<double>> normalizer =
+            LoudnessNormalizer<double>::create(config);
+    ASSERT_TRUE(normalizer.has_value());
+    std::vector<double> samples = make_sine(48000, 0.1, 1.0);
+    normalizer->process(samples);
+    normalizer->reset();
+    ASSERT_EQ(normalizer->gain(), 0.0);
+    ASSERT_TRUE(std::isinf(normalizer->integrated_loudness()));
+    double sample = 0.5;
+    normalizer->process(sample);
+    ASSERT_DOUBLE_EQ(sample, 0.5);
+}
@@ -103,3 +103,127 @@ TEST(NoiseGateTest, ResetNoiseGate) {
     noiseGate->process(sample);
     ASSERT_EQ(sample, 1.0f);
 }
+
+TEST(NoiseGateTest, ProcessStridedViewMatchesContiguous) {
+    constexpr auto config = NoiseGateConfiguration<float>{
+            .sampleRate = 48000,
+            .threshold = -10.0f,
+            .attack = std::chrono::milliseconds(10),
+            .release = std::chrono::milliseconds(100),
+            .makeupGain = 5.0f,
+            .kneeWidth = 5.0f};
+    std::optional<NoiseGate<float>> contiguous =
+            NoiseGate<float>::create(config);
+    std::optional<NoiseGate<float>> strided = NoiseGate<float>::create(config);
+    ASSERT_TRUE(contiguous.has_value());
+    ASSERT_TRUE(strided.has_value());
+    std::vector<float> mono = {1.0f, 0.5f, 0.25f, 0.9f, 0.05f, 0.7f};
+    std::vector<float> stereo(mono.size() * 2);
+    for (size_t i = 0; i < mono.size(); i++) {
+        stereo[2 * i] = 0.3f;
+        stereo[2 * i + 1] = mono[i];
+    }
+    contiguous->process(mono);
+    strided->process(interleaved_channel(stereo.data(), mono.size(), 2, 1));
+    for (size_t i = 0; i < mono.size(); i++) {
+        ASSERT_FLOAT_EQ(stereo[2 * i], 0.3f);
+        ASSERT_FLOAT_EQ(stereo[2 * i + 1], mono[i]);
+    }
+}
+
+TEST(NoiseGateTest, ProcessSegmentsMatchesContiguous) {
+    constexpr auto config = NoiseGateConfiguration<float>{
+            .sampleRate = 48000,
+            .threshold = -10.0f,
+            .attack = std::chrono::milliseconds(10),
+            .release = std::chrono::milliseconds(100),
+            .makeupGain = 5.0f,
+            .kneeWidth = 5.0f};
+    std::optional<NoiseGate<float>> contiguous =
+            NoiseGate<float>::create(config);
+    std::optional<NoiseGate<float>> segmented =
+            NoiseGate<float>::create(config);
+    ASSERT_TRUE(contiguous.has_value());
+    ASSERT_TRUE(segmented.has_value());
+    std::vector<float> samples = {1.0f, 0.5f, 0.25f, 0.9f, 0.05f, 0.7f};
+    std::vector<float> first(samples.begin(), samples.begin() + 2);
+    std::vector<float> second(samples.begin() + 2, samples.end());
+    const std::array<std::span<float>, 2> segments = {first, second};
+    contiguous->process(samples);
+    segmented->process(segments);
+    for (size_t i = 0; i < first.size(); i++) {
+        ASSERT_FLOAT_EQ(first[i], samples[i]);
+    }
+    for (size_t i = 0; i < second.size(); i++) {
+        ASSERT_FLOAT_EQ(second[i], samples[first.size() + i]);
+    }
+}
+
+TEST(NoiseGateTest, MixedPrecisionMatchesDoublePath) {
+    constexpr auto floatConfig = NoiseGateConfiguration<float>{
+            .sampleRate = 48000,
+            .threshold = -10.0f,
+            .attack = std::chrono::milliseconds(10),
+            .release = std::chrono::milliseconds(100)};
+    constexpr auto doubleConfig = NoiseGateConfiguration<double>{
+            .sampleRate = 48000,
+            .threshold = -10.0,
+            .attack = std::chrono::milliseconds(10),
+            .release = std::chrono::milliseconds(100)};
+    std::optional<NoiseGate<float, double>> mixed =
+            NoiseGate<float, double>::create(floatConfig);
+    std::optional<NoiseGate<double>> reference =
+            NoiseGate<double>::create(doubleConfig);
+    ASSERT_TRUE(mixed.has_value());
+    ASSERT_TRUE(reference.has_value());
+    std::optional<NoiseGate<float>> single =
+            NoiseGate<float>::create(floatConfig);
+    ASSERT_TRUE(single.has_value());
+    /// The output passes while the gate is open, so compare the envelopes,
+    /// which follow the input:
+    double largestFloatError = 0.0;
+    for (size_t i = 0; i < 48000; i++) {
+        const float burst = (i % 12000) < 6000 ? 1.0f : 0.01f;
+        const float input =
+                burst * static_cast<float>((i * 37) % 101) / 101.0f;
+        float mixedSample = input;
+        double referenceSample = input;
+        float singleSample = input;
+        mixed->process(mixedSample);
+        reference->process(referenceSample);
+        single->process(singleSample);
+        ASSERT_EQ(mixedSample, static_cast<float>(referenceSample));
+        ASSERT_EQ(mixed->envelope(), reference->envelope());
+        largestFloatError = std::max(
+                largestFloatError,
+                std::fabs(static_cast<double>(single->envelope()) -
+                          reference->envelope()));
+    }
+    EXPECT_GT(reference->envelope(), 0.0);
+    EXPECT_LT(reference->envelope(), 0.05);
+    EXPECT_GT(largestFloatError, 0.0);
+}
+
+TEST(NoiseGateTest, ComputeGainMatchesProcess) {
+    constexpr auto config = NoiseGateConfiguration<float>{
+            .sampleRate = 48000,
+            .threshold = -10.0f,
+            .attack = std::chrono::milliseconds(10),
+            .release = std::chrono::milliseconds(100)};
+    std::optional<NoiseGate<float>> processed =
+            NoiseGate<float>::create(config);
+    std::optional<NoiseGate<float>> detector = NoiseGate<float>::create(config);
+    ASSERT_TRUE(processed.has_value());
+    ASSERT_TRUE(detector.has_value());
+    std::vector<float> samples(4800);
+    for (size_t i = 0; i < samples.size(); i++) {
+        samples[i] = 0.05f + 0.9f * static_cast<float>((i * 37) % 101) / 101.0f;
+    }
+    std::vector<float> gains(samples.size());
+    detector->compute_gain(samples.data(), gains.data(), samples.size());
+    const std::vector<float> input = samples;
+    processed->process(samples.data(), samples.size());
+    for (size_t i = 0; i < samples.size(); i++) {
+        ASSERT_EQ(input[i] * gains[i], samples[i]);
+    }
+}
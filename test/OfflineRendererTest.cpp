@@ -0,0 +1,144 @@
+/// OfflineRendererTest.cpp
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "Compressor.h"
+#include "Limiter.h"
+#include "OfflineRenderer.h"
+
+namespace {
+constexpr auto limiterConfig = LimiterConfiguration<double>{
+        .sampleRate = 48000,
+        .threshold = -6.0,
+        .attack = std::chrono::milliseconds(5),
+        .release = std::chrono::milliseconds(50),
+        .makeupGain = 1.0};
+
+/// Quiet noise with full-scale bursts, alternating in sign
+auto make_signal(const size_t count) -> std::vector<double> {
+    std::vector<double> samples(count);
+    for (size_t i = 0; i < count; i++) {
+        const double magnitude =
+                (i % 20000) > 15000 ? 1.0 : 0.05 + 0.001 * (i % 7);
+        samples[i] = (i % 2 == 0) ? magnitude : -magnitude;
+    }
+    return samples;
+}
+
+auto peak(const std::vector<double> &samples) -> double {
+    double result = 0.0;
+    for (const double sample: samples) {
+        result = std::max(result, std::fabs(sample));
+    }
+    return result;
+}
+} // namespace
+
+TEST(OfflineRendererTest, CreateOfflineRendererSuccess) {
+    const std::optional<Limiter<double>> limiter =
+            Limiter<double>::create(limiterConfig);
+    ASSERT_TRUE(limiter.has_value());
+    const std::optional<OfflineRenderer<Limiter<double>>> renderer =
+            OfflineRenderer<Limiter<double>>::create(*limiter, 4096);
+    ASSERT_TRUE(renderer.has_value());
+    ASSERT_GT(renderer->lookahead(), 0u);
+}
+
+TEST(OfflineRendererTest, CreateOfflineRendererFailureInvalidChunkSize) {
+    const std::optional<Limiter<double>> limiter =
+            Limiter<double>::create(limiterConfig);
+    ASSERT_TRUE(limiter.has_value());
+    const std::optional<OfflineRenderer<Limiter<double>>> renderer =
+            OfflineRenderer<Limiter<double>>::create(*limiter, 0);
+    ASSERT_FALSE(renderer.has_value());
+}
+
+TEST(OfflineRendererTest, RenderLimiterHasNoOvershoot) {
+    std::optional<Limiter<double>> limiter =
+            Limiter<double>::create(limiterConfig);
+    ASSERT_TRUE(limiter.has_value());
+    std::optional<OfflineRenderer<Limiter<double>>> renderer =
+            OfflineRenderer<Limiter<double>>::create(*limiter, 4096);
+    ASSERT_TRUE(renderer.has_value());
+    std::vector<double> samples = make_signal(100000);
+    renderer->render(samples.data(), samples.size());
+    ASSERT_LE(20.0 * std::log10(peak(samples)), -6.0 + 1e-6);
+}
+
+TEST(OfflineRendererTest, RenderLeavesQuietPassagesUntouched) {
+    std::optional<Limiter<double>> limiter =
+            Limiter<double>::create(limiterConfig);
+    ASSERT_TRUE(limiter.has_value());
+    std::optional<OfflineRenderer<Limiter<double>>> renderer =
+            OfflineRenderer<Limiter<double>>::create(*limiter, 4096);
+    ASSERT_TRUE(renderer.has_value());
+    const std::vector<double> input = make_signal(100000);
+    std::vector<double> samples = input;
+    renderer->render(samples.data(), samples.size());
+    /// Well before the first burst, far enough that the backward attack ramp
+    /// has decayed:
+    for (size_t i = 0; i < 10000; i++) {
+        ASSERT_NEAR(samples[i], input[i], 1e-9);
+    }
+}
+
+TEST(OfflineRendererTest, RenderChunkSizeDoesNotChangeOutput) {
+    constexpr auto config = CompressorConfiguration<double>{
+            .sampleRate = 48000,
+            .threshold = -20.0,
+            .attack = std::chrono::milliseconds(10),
+            .release = std::chrono::milliseconds(100),
+            .ratio = 4.0,
+            .makeupGain = 1.0,
+            .kneeWidth = 6.0};
+    std::optional<Compressor<double>> compressor =
+            Compressor<double>::create(config);
+    ASSERT_TRUE(compressor.has_value());
+    std::optional<OfflineRenderer<Compressor<double>>> small =
+            OfflineRenderer<Compressor<double>>::create(*compressor, 1000);
+    std::optional<OfflineRenderer<Compressor<double>>> whole =
+            OfflineRenderer<Compressor<double>>::create(*compressor, 1 << 20);
+    ASSERT_TRUE(small.has_value());
+    ASSERT_TRUE(whole.has_value());
+    std::vector<double> a = make_signal(100000);
+    std::vector<double> b = a;
+    small->render(a.data(), a.size());
+    whole->render(b.data(), b.size());
+    for (size_t i = 0; i < a.size(); i++) {
+        ASSERT_NEAR(20.0 * std::log10(std::fabs(a[i])),
+                    20.0 * std::log10(std::fabs(b[i])), 1e-4);
+    }
+}
+
+TEST(OfflineRendererTest, RenderStreamsThroughReaderAndWriter) {
+    std::optional<Limiter<double>> limiter =
+            Limiter<double>::create(limiterConfig);
+    ASSERT_TRUE(limiter.has_value());
+    std::optional<OfflineRenderer<Limiter<double>>> renderer =
+            OfflineRenderer<Limiter<double>>::create(*limiter, 2048);
+    ASSERT_TRUE(renderer.has_value());
+    const std::vector<double> input = make_signal(50000);
+    std::vector<double> inPlace = input;
+    renderer->render(inPlace.data(), inPlace.size());
+
+    /// Reads of an awkward size, like a file reader would deliver:
+    size_t position = 0;
+    std::vector<double> output;
+    const size_t rendered = renderer->render(
+            [&](double *destination, const size_t maximum) -> size_t {
+                const size_t n = std::min({maximum, size_t{777},
+                                           input.size() - position});
+                std::copy(input.begin() + position,
+                          input.begin() + position + n, destination);
+                position += n;
+                return n;
+            },
+            [&](const double *source, const size_t n) {
+                output.insert(output.end(), source, source + n);
+            });
+    ASSERT_EQ(rendered, input.size());
+    ASSERT_EQ(output.size(), input.size());
+    for (size_t i = 0; i < input.size(); i++) {
+        ASSERT_NEAR(output[i], inPlace[i], 1e-12);
+    }
+}
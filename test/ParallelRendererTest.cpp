@@ -0,0 +1,168 @@
+/// ParallelRendererTest.cpp
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "Compressor.h"
+#include "Expander.h"
+#include "NoiseGate.h"
+#include "ParallelRenderer.h"
+
+namespace {
+/// Positive levels with bursts, plus runs of silence for the gate
+auto make_signal(const size_t count, const bool silences)
+        -> std::vector<double> {
+    std::vector<double> samples(count);
+    for (size_t i = 0; i < count; i++) {
+        const double burst = (i % 30000) > 20000 ? 0.9 : 0.05;
+        samples[i] = burst + 0.001 * static_cast<double>((i * 37) % 101);
+        if (silences && (i % 5000) > 3000) {
+            samples[i] = 0.0;
+        }
+    }
+    return samples;
+}
+} // namespace
+
+TEST(ParallelRendererTest, CreateParallelRendererSuccess) {
+    constexpr auto config = NoiseGateConfiguration<double>{
+            .sampleRate = 48000,
+            .threshold = -10.0,
+            .attack = std::chrono::milliseconds(10),
+            .release = std::chrono::milliseconds(100)};
+    const std::optional<NoiseGate<double>> noiseGate =
+            NoiseGate<double>::create(config);
+    ASSERT_TRUE(noiseGate.has_value());
+    const std::optional<ParallelRenderer<NoiseGate<double>>> renderer =
+            ParallelRenderer<NoiseGate<double>>::create(*noiseGate);
+    ASSERT_TRUE(renderer.has_value());
+}
+
+TEST(ParallelRendererTest, CompressorMatchesSerial) {
+    constexpr auto config = CompressorConfiguration<double>{
+            .sampleRate = 48000,
+            .threshold = -20.0,
+            .attack = std::chrono::milliseconds(10),
+            .release = std::chrono::milliseconds(100),
+            .ratio = 4.0,
+            .makeupGain = 1.0,
+            .kneeWidth = 6.0};
+    std::optional<Compressor<double>> serial =
+            Compressor<double>::create(config);
+    ASSERT_TRUE(serial.has_value());
+    std::optional<ParallelRenderer<Compressor<double>>> parallel =
+            ParallelRenderer<Compressor<double>>::create(*serial, 7);
+    ASSERT_TRUE(parallel.has_value());
+    std::vector<double> a = make_signal(400000, false);
+    std::vector<double> b = a;
+    /// Two blocks, to check state is carried between calls:
+    parallel->render(a.data(), 250000);
+    parallel->render(a.data() + 250000, a.size() - 250000);
+    serial->process(b.data(), b.size());
+    for (size_t i = 0; i < a.size(); i++) {
+        ASSERT_NEAR(a[i], b[i], 1e-9 * std::fabs(b[i]));
+    }
+}
+
+TEST(ParallelRendererTest, ExpanderMatchesSerial) {
+    constexpr auto config = ExpanderConfiguration<double>{
+            .sampleRate = 48000,
+            .threshold = -20.0,
+            .attack = std::chrono::milliseconds(5),
+            .release = std::chrono::milliseconds(50),
+            .ratio = 2.0,
+            .makeupGain = 1.0};
+    std::optional<Expander<double>> serial = Expander<double>::create(config);
+    ASSERT_TRUE(serial.has_value());
+    std::optional<ParallelRenderer<Expander<double>>> parallel =
+            ParallelRenderer<Expander<double>>::create(*serial, 4);
+    ASSERT_TRUE(parallel.has_value());
+    std::vector<double> a = make_signal(200000, false);
+    std::vector<double> b = a;
+    parallel->render(a.data(), a.size());
+    serial->process(b.data(), b.size());
+    for (size_t i = 0; i < a.size(); i++) {
+        ASSERT_NEAR(a[i], b[i], 1e-9 * std::fabs(b[i]));
+    }
+}
+
+TEST(ParallelRendererTest, NoiseGateMatchesSerial) {
+    constexpr auto config = NoiseGateConfiguration<double>{
+            .sampleRate = 48000,
+            .threshold = -10.0,
+            .attack = std::chrono::milliseconds(10),
+            .release = std::chrono::milliseconds(100)};
+    std::optional<NoiseGate<double>> serial =
+            NoiseGate<double>::create(config);
+    ASSERT_TRUE(serial.has_value());
+    std::optional<ParallelRenderer<NoiseGate<double>>> parallel =
+            ParallelRenderer<NoiseGate<double>>::create(*serial, 5);
+    ASSERT_TRUE(parallel.has_value());
+    std::vector<double> a = make_signal(300000, true);
+    std::vector<double> b = a;
+    /// The gate stays open at its threshold level, so the output is the input
+    /// and only the envelope shows whether the chunk maps were stitched right:
+    parallel->render(a.data(), 100000);
+    serial->process(b.data(), 100000);
+    ASSERT_GT(serial->envelope(), 0.0);
+    ASSERT_NEAR(parallel->state(), serial->envelope(),
+                1e-12 * serial->envelope());
+    parallel->render(a.data() + 100000, a.size() - 100000);
+    serial->process(b.data() + 100000, b.size() - 100000);
+    ASSERT_GT(serial->envelope(), 0.0);
+    ASSERT_NEAR(parallel->state(), serial->envelope(),
+                1e-12 * serial->envelope());
+    for (size_t i = 0; i < a.size(); i++) {
+        ASSERT_DOUBLE_EQ(a[i], b[i]);
+    }
+}
+
+TEST(ParallelRendererTest, NonContractingSmoothingMatchesSerial) {
+    /// Both coefficients round to 1 in float:
+    constexpr auto config = CompressorConfiguration<float>{
+            .sampleRate = 192000,
+            .threshold = -20.0f,
+            .attack = std::chrono::milliseconds(100000000),
+            .release = std::chrono::milliseconds(100000000),
+            .ratio = 4.0f,
+            .makeupGain = 1.0f};
+    std::optional<Compressor<float>> serial = Compressor<float>::create(config);
+    ASSERT_TRUE(serial.has_value());
+    ASSERT_EQ(serial->attack_coefficient(), 1.0f);
+    std::optional<ParallelRenderer<Compressor<float>>> parallel =
+            ParallelRenderer<Compressor<float>>::create(*serial, 4);
+    ASSERT_TRUE(parallel.has_value());
+    std::vector<float> a(20000);
+    for (size_t i = 0; i < a.size(); i++) {
+        a[i] = 0.05f + 0.001f * static_cast<float>((i * 37) % 101);
+    }
+    std::vector<float> b = a;
+    parallel->render(a.data(), a.size());
+    serial->process(b.data(), b.size());
+    for (size_t i = 0; i < a.size(); i++) {
+        ASSERT_FLOAT_EQ(a[i], b[i]);
+    }
+}
+
+TEST(ParallelRendererTest, ResetParallelRenderer) {
+    constexpr auto config = CompressorConfiguration<double>{
+            .sampleRate = 48000,
+            .threshold = -20.0,
+            .attack = std::chrono::milliseconds(10),
+            .release = std::chrono::milliseconds(100),
+            .ratio = 4.0,
+            .makeupGain = 1.0};
+    std::optional<Compressor<double>> compressor =
+            Compressor<double>::create(config);
+    ASSERT_TRUE(compressor.has_value());
+    std::optional<ParallelRenderer<Compressor<double>>> parallel =
+            ParallelRenderer<Compressor<double>>::create(*compressor, 2);
+    ASSERT_TRUE(parallel.has_value());
+    std::vector<double> a = make_signal(10000, false);
+    std::vector<double> b = a;
+    parallel->render(a.data(), a.size());
+    parallel->reset();
+    parallel->render(b.data(), b.size());
+    for (size_t i = 0; i < a.size(); i++) {
+        ASSERT_DOUBLE_EQ(a[i], b[i]);
+    }
+}
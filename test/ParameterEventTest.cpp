@@ -0,0 +1,136 @@
+/// ParameterEventTest.cpp
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "Compressor.h"
+#include "Limiter.h"
+
+namespace {
+constexpr auto compressorConfig = CompressorConfiguration<double>{
+        .sampleRate = 48000,
+        .threshold = -10.0,
+        .attack = std::chrono::milliseconds(1),
+        .release = std::chrono::milliseconds(10),
+        .ratio = 4.0,
+        .makeupGain = 2.0,
+        .kneeWidth = 6.0};
+
+auto make_signal(const size_t count) -> std::vector<double> {
+    std::vector<double> samples(count);
+    for (size_t i = 0; i < count; i++) {
+        samples[i] = 0.2 + 0.7 * static_cast<double>((i * 37) % 100) / 100.0;
+    }
+    return samples;
+}
+} // namespace
+
+TEST(ParameterEventTest, NoEventsMatchesPlainProcess) {
+    std::optional<Compressor<double>> automated =
+            Compressor<double>::create(compressorConfig);
+    std::optional<Compressor<double>> plain =
+            Compressor<double>::create(compressorConfig);
+    ASSERT_TRUE(automated.has_value());
+    ASSERT_TRUE(plain.has_value());
+    std::vector<double> a = make_signal(256);
+    std::vector<double> b = a;
+    automated->process(a.data(), a.size(), {});
+    plain->process(b.data(), b.size());
+    for (size_t i = 0; i < a.size(); i++) {
+        ASSERT_DOUBLE_EQ(a[i], b[i]);
+    }
+}
+
+TEST(ParameterEventTest, ImmediateEventMatchesSplitBuffer) {
+    std::optional<Compressor<double>> automated =
+            Compressor<double>::create(compressorConfig);
+    std::optional<Compressor<double>> split =
+            Compressor<double>::create(compressorConfig);
+    ASSERT_TRUE(automated.has_value());
+    ASSERT_TRUE(split.has_value());
+    std::vector<double> a = make_signal(256);
+    std::vector<double> b = a;
+
+    const std::vector<ParameterEvent<double>> events = {
+            {.offset = 100, .parameter = Parameter::Threshold, .value = -20.0},
+            {.offset = 180, .parameter = Parameter::Ratio, .value = 8.0}};
+    automated->process(a.data(), a.size(), events);
+
+    auto config = compressorConfig;
+    split->process(b.data(), 100);
+    config.threshold = -20.0;
+    split->set_configuration(config);
+    split->process(b.data() + 100, 80);
+    config.ratio = 8.0;
+    split->set_configuration(config);
+    split->process(b.data() + 180, b.size() - 180);
+
+    for (size_t i = 0; i < a.size(); i++) {
+        ASSERT_DOUBLE_EQ(a[i], b[i]);
+    }
+}
+
+TEST(ParameterEventTest, RampInterpolatesLinearlyAcrossBlocks) {
+    constexpr auto config = LimiterConfiguration<double>{
+            .sampleRate = 48000,
+            .threshold = -6.0,
+            .attack = std::chrono::milliseconds(1),
+            .release = std::chrono::milliseconds(10),
+            .makeupGain = 1.0,
+            .kneeWidth = 3.0};
+    std::optional<Limiter<double>> automated =
+            Limiter<double>::create(config);
+    std::optional<Limiter<double>> reference =
+            Limiter<double>::create(config);
+    ASSERT_TRUE(automated.has_value());
+    ASSERT_TRUE(reference.has_value());
+    std::vector<double> a = make_signal(128);
+    std::vector<double> b = a;
+
+    /// Ramp the threshold from -6 dB to -18 dB over 96 samples starting at
+    /// sample 16, processed as two blocks of 64:
+    const std::vector<ParameterEvent<double>> events = {
+            {.offset = 16,
+             .parameter = Parameter::Threshold,
+             .value = -18.0,
+             .rampLength = 96}};
+    automated->process(a.data(), 64, events);
+    automated->process(a.data() + 64, 64, {});
+
+    auto rampConfig = config;
+    for (size_t i = 0; i < b.size(); i++) {
+        if (i >= 16 && i < 112) {
+            rampConfig.threshold =
+                    -6.0 - 12.0 * static_cast<double>(i - 15) / 96.0;
+            reference->set_configuration(rampConfig);
+        }
+        reference->process(b[i]);
+    }
+
+    for (size_t i = 0; i < a.size(); i++) {
+        ASSERT_NEAR(a[i], b[i], 1e-12);
+    }
+}
+
+TEST(ParameterEventTest, UnsupportedParameterIsIgnored) {
+    constexpr auto config = LimiterConfiguration<double>{
+            .sampleRate = 48000,
+            .threshold = -6.0,
+            .attack = std::chrono::milliseconds(1),
+            .release = std::chrono::milliseconds(10),
+            .makeupGain = 1.0,
+            .kneeWidth = 3.0};
+    std::optional<Limiter<double>> automated =
+            Limiter<double>::create(config);
+    std::optional<Limiter<double>> plain = Limiter<double>::create(config);
+    ASSERT_TRUE(automated.has_value());
+    ASSERT_TRUE(plain.has_value());
+    std::vector<double> a = make_signal(64);
+    std::vector<double> b = a;
+    const std::vector<ParameterEvent<double>> events = {
+            {.offset = 10, .parameter = Parameter::Ratio, .value = 10.0}};
+    automated->process(a.data(), a.size(), events);
+    plain->process(b.data(), b.size());
+    for (size_t i = 0; i < a.size(); i++) {
+        ASSERT_DOUBLE_EQ(a[i], b[i]);
+    }
+}
@@ -0,0 +1,107 @@
+/// ProcessorAllocatorTest.cpp
+
+#include <gtest/gtest.h>
+#include <array>
+#include <cstdint>
+#include "Compressor.h"
+#include "Limiter.h"
+#include "NoiseGate.h"
+#include "ProcessorAllocator.h"
+
+TEST(ProcessorAllocatorTest, CreateInArenaSuccess) {
+    constexpr auto config = CompressorConfiguration<float>{
+            .sampleRate = 48000,
+            .threshold = -10.0f,
+            .attack = std::chrono::milliseconds(10),
+            .release = std::chrono::milliseconds(100),
+            .ratio = 5.0f,
+            .makeupGain = 5.0f,
+            .kneeWidth = 5.0f};
+    alignas(64) std::array<std::byte, 1024> buffer{};
+    std::pmr::monotonic_buffer_resource arena(
+            buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+    const ResourcePtr<Compressor<float>> compressor =
+            create_in<Compressor<float>>(&arena, config, 64);
+    ASSERT_NE(compressor, nullptr);
+    const auto address = reinterpret_cast<std::uintptr_t>(compressor.get());
+    ASSERT_EQ(address % 64, 0u);
+    ASSERT_GE(address, reinterpret_cast<std::uintptr_t>(buffer.data()));
+    ASSERT_LT(address,
+              reinterpret_cast<std::uintptr_t>(buffer.data() + buffer.size()));
+}
+
+TEST(ProcessorAllocatorTest, CreateInArenaFailureInvalidConfiguration) {
+    constexpr auto config = LimiterConfiguration<float>{
+            .sampleRate = 0,
+            .threshold = -10.0f,
+            .attack = std::chrono::milliseconds(10),
+            .release = std::chrono::milliseconds(100),
+            .makeupGain = 5.0f,
+            .kneeWidth = 5.0f};
+    std::pmr::monotonic_buffer_resource arena(std::pmr::null_memory_resource());
+    const ResourcePtr<Limiter<float>> limiter =
+            create_in<Limiter<float>>(&arena, config);
+    ASSERT_EQ(limiter, nullptr);
+}
+
+TEST(ProcessorAllocatorTest, CreateInArenaProcessMatchesHeap) {
+    constexpr auto config = LimiterConfiguration<float>{
+            .sampleRate = 48000,
+            .threshold = -10.0f,
+            .attack = std::chrono::milliseconds(10),
+            .release = std::chrono::milliseconds(100),
+            .makeupGain = 5.0f,
+            .kneeWidth = 5.0f};
+    std::pmr::unsynchronized_pool_resource pool;
+    const ResourcePtr<Limiter<float>> placed =
+            create_in<Limiter<float>>(&pool, config);
+    std::optional<Limiter<float>> heap = Limiter<float>::create(config);
+    ASSERT_NE(placed, nullptr);
+    ASSERT_TRUE(heap.has_value());
+    for (float sample: {1.0f, 0.5f, 0.25f, 0.9f}) {
+        float a = sample;
+        float b = sample;
+        placed->process(a);
+        heap->process(b);
+        ASSERT_FLOAT_EQ(a, b);
+    }
+}
+
+TEST(ProcessorAllocatorTest, CreateBankSuccess) {
+    constexpr auto config = NoiseGateConfiguration<float>{
+            .sampleRate = 48000,
+            .threshold = -10.0f,
+            .attack = std::chrono::milliseconds(10),
+            .release = std::chrono::milliseconds(100),
+            .makeupGain = 5.0f,
+            .kneeWidth = 5.0f};
+    alignas(64) std::array<std::byte, 64 * 16> buffer{};
+    std::pmr::monotonic_buffer_resource arena(
+            buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+    std::optional<ProcessorBank<NoiseGate<float>>> bank =
+            ProcessorBank<NoiseGate<float>>::create(&arena, 16, config);
+    ASSERT_TRUE(bank.has_value());
+    ASSERT_EQ(bank->size(), 16u);
+    ASSERT_EQ(bank->stride() % 64, 0u);
+    for (std::size_t i = 0; i < bank->size(); i++) {
+        const auto address = reinterpret_cast<std::uintptr_t>(&(*bank)[i]);
+        ASSERT_EQ(address % 64, 0u);
+        float sample = 1.0f;
+        (*bank)[i].process(sample);
+        ASSERT_EQ(sample, 1.0f);
+    }
+}
+
+TEST(ProcessorAllocatorTest, CreateBankFailureInvalidConfiguration) {
+    constexpr auto config = NoiseGateConfiguration<float>{
+            .sampleRate = 48000,
+            .threshold = -10.0f,
+            .attack = std::chrono::milliseconds(0),
+            .release = std::chrono::milliseconds(100),
+            .makeupGain = 5.0f,
+            .kneeWidth = 5.0f};
+    std::pmr::monotonic_buffer_resource arena(std::pmr::null_memory_resource());
+    const std::optional<ProcessorBank<NoiseGate<float>>> bank =
+            ProcessorBank<NoiseGate<float>>::create(&arena, 16, config);
+    ASSERT_FALSE(bank.has_value());
+}
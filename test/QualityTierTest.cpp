@@ -0,0 +1,317 @@
+/// QualityTierTest.cpp
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+#include "Compressor.h"
+#include "Expander.h"
+#include "Limiter.h"
+#include "NoiseGate.h"
+#include "QualityTier.h"
+
+namespace {
+auto make_compressor() -> Compressor<double> {
+    return *Compressor<double>::create(
+            {.sampleRate = 48000,
+             .threshold = -20.0,
+             .attack = std::chrono::milliseconds(5),
+             .release = std::chrono::milliseconds(50),
+             .ratio = 4.0,
+             .makeupGain = 1.0,
+             .kneeWidth = 3.0});
+}
+
+/// Quiet, then loud, then quiet again, alternating in sign
+auto make_signal(const size_t count) -> std::vector<double> {
+    std::vector<double> samples(count);
+    for (size_t i = 0; i < count; i++) {
+        const bool loud = i >= count / 3 && i < 2 * count / 3;
+        samples[i] = (loud ? 0.8 : 0.05) * (i % 2 == 0 ? 1.0 : -1.0);
+    }
+    return samples;
+}
+
+/// Largest change of the applied gain between consecutive samples
+auto max_gain_step(const std::vector<double> &input,
+                   const std::vector<double> &output) -> double {
+    double step = 0.0;
+    for (size_t i = 1; i < input.size(); i++) {
+        const double previous = output[i - 1] / input[i - 1];
+        step = std::max(step, std::fabs(output[i] / input[i] - previous));
+    }
+    return step;
+}
+} // namespace
+
+TEST(QualityTierTest, FastLevelMatchesLevelDecibels) {
+    for (double x = 1e-11; x < 1e11; x *= 1.37) {
+        EXPECT_NEAR(fast_level_decibels(x), level_decibels(x), 1e-4) << x;
+        EXPECT_NEAR(fast_level_decibels(-x), level_decibels(-x), 1e-4) << x;
+    }
+    EXPECT_NEAR(fast_level_decibels(0.0), -200.0, 1e-4);
+    EXPECT_NEAR(fast_level_decibels(std::nan("")), -200.0, 1e-4);
+}
+
+TEST(QualityTierTest, FastGainMatchesPow) {
+    for (double decibels = -300.0; decibels < 300.0; decibels += 0.37) {
+        const double exact = std::pow(10.0, decibels / 20.0);
+        if (exact > 1e-37 && exact < 1e37) {
+            EXPECT_NEAR(fast_decibels_to_gain(decibels) / exact, 1.0, 1e-5)
+                    << decibels;
+        }
+    }
+}
+
+TEST(QualityTierTest, CreateTieredProcessorSuccess) {
+    const std::optional<TieredProcessor<Compressor<double>>> tiered =
+            TieredProcessor<Compressor<double>>::create(make_compressor());
+    ASSERT_TRUE(tiered.has_value());
+}
+
+TEST(QualityTierTest, CreateTieredProcessorFailureZeroInterval) {
+    const std::optional<TieredProcessor<Compressor<double>>> tiered =
+            TieredProcessor<Compressor<double>>::create(make_compressor(), 0);
+    ASSERT_FALSE(tiered.has_value());
+}
+
+TEST(QualityTierTest, ExactMatchesProcessor) {
+    Compressor<double> compressor = make_compressor();
+    std::optional<TieredProcessor<Compressor<double>>> tiered =
+            TieredProcessor<Compressor<double>>::create(compressor);
+    ASSERT_TRUE(tiered.has_value());
+    std::vector<double> a = make_signal(4800);
+    std::vector<double> b = a;
+    tiered->process(a.data(), a.size());
+    compressor.process(b.data(), b.size());
+    EXPECT_EQ(a, b);
+}
+
+TEST(QualityTierTest, ExactMatchesEveryProcessor) {
+    Limiter<double> limiter = *Limiter<double>::create(
+            {.sampleRate = 48000,
+             .threshold = -10.0,
+             .attack = std::chrono::milliseconds(1),
+             .release = std::chrono::milliseconds(20)});
+    Expander<double> expander = *Expander<double>::create(
+            {.sampleRate = 48000,
+             .threshold = -30.0,
+             .attack = std::chrono::milliseconds(1),
+             .release = std::chrono::milliseconds(20),
+             .ratio = 2.0});
+    NoiseGate<double> noiseGate = *NoiseGate<double>::create(
+            {.sampleRate = 48000,
+             .threshold = -30.0,
+             .attack = std::chrono::milliseconds(1),
+             .release = std::chrono::milliseconds(20)});
+    auto tieredLimiter = TieredProcessor<Limiter<double>>::create(limiter);
+    auto tieredExpander = TieredProcessor<Expander<double>>::create(expander);
+    auto tieredGate = TieredProcessor<NoiseGate<double>>::create(noiseGate);
+    ASSERT_TRUE(tieredLimiter.has_value());
+    ASSERT_TRUE(tieredExpander.has_value());
+    ASSERT_TRUE(tieredGate.has_value());
+    const std::vector<double> input = make_signal(4800);
+
+    std::vector<double> a = input;
+    std::vector<double> b = input;
+    tieredLimiter->process(a.data(), a.size());
+    limiter.process(b.data(), b.size());
+    EXPECT_EQ(a, b);
+
+    a = input;
+    b = input;
+    tieredExpander->process(a.data(), a.size());
+    expander.process(b.data(), b.size());
+    EXPECT_EQ(a, b);
+
+    a = input;
+    b = input;
+    tieredGate->process(a.data(), a.size());
+    noiseGate.process(b.data(), b.size());
+    EXPECT_EQ(a, b);
+}
+
+TEST(QualityTierTest, FastIsCloseToExact) {
+    auto exact = TieredProcessor<Compressor<double>>::create(make_compressor());
+    auto fast = TieredProcessor<Compressor<double>>::create(make_compressor());
+    ASSERT_TRUE(exact.has_value());
+    ASSERT_TRUE(fast.has_value());
+    fast->set_tier(QualityTier::Fast);
+    std::vector<double> a = make_signal(4800);
+    std::vector<double> b = a;
+    exact->process(a.data(), a.size());
+    fast->process(b.data(), b.size());
+    for (size_t i = 0; i < a.size(); i++) {
+        EXPECT_NEAR(b[i] / a[i], 1.0, 1e-4) << i;
+    }
+}
+
+TEST(QualityTierTest, ControlRateSettlesLikeExact) {
+    auto exact = TieredProcessor<Compressor<double>>::create(make_compressor());
+    auto control =
+            TieredProcessor<Compressor<double>>::create(make_compressor());
+    ASSERT_TRUE(exact.has_value());
+    ASSERT_TRUE(control.has_value());
+    control->set_tier(QualityTier::ControlRate);
+    const std::vector<double> input = make_signal(48000);
+    std::vector<double> a = input;
+    std::vector<double> b = input;
+    /// Odd block size, so the last interval of every block is partial:
+    for (size_t i = 0; i < a.size(); i += 100) {
+        exact->process(a.data() + i, 100);
+        control->process(b.data() + i, 100);
+    }
+    /// Settled at the end of the loud part and at the end of the signal:
+    for (const size_t i: {2 * a.size() / 3 - 1, a.size() - 1}) {
+        EXPECT_NEAR(20.0 * std::log10(b[i] / a[i]), 0.0, 0.01) << i;
+    }
+}
+
+TEST(QualityTierTest, SwitchingTiersDoesNotStepTheGain) {
+    auto exact = TieredProcessor<Compressor<double>>::create(make_compressor());
+    auto switching =
+            TieredProcessor<Compressor<double>>::create(make_compressor());
+    ASSERT_TRUE(exact.has_value());
+    ASSERT_TRUE(switching.has_value());
+    const std::vector<double> input = make_signal(9600);
+    std::vector<double> a = input;
+    std::vector<double> b = input;
+    constexpr QualityTier tiers[] = {QualityTier::Exact,
+                                     QualityTier::ControlRate,
+                                     QualityTier::Fast,
+                                     QualityTier::ControlRate};
+    for (size_t i = 0, block = 0; i < a.size(); i += 64, block++) {
+        switching->set_tier(tiers[block % 4]);
+        exact->process(a.data() + i, 64);
+        switching->process(b.data() + i, 64);
+    }
+    EXPECT_LE(max_gain_step(input, b), 1.05 * max_gain_step(input, a));
+}
+
+TEST(QualityTierTest, TierChangesAtNextBlock) {
+    auto tiered =
+            TieredProcessor<Compressor<double>>::create(make_compressor());
+    ASSERT_TRUE(tiered.has_value());
+    tiered->set_tier(QualityTier::Fast);
+    EXPECT_EQ(tiered->tier(), QualityTier::Fast);
+    /// A single sample still runs at the Exact tier:
+    Compressor<double> compressor = make_compressor();
+    double a = 0.5;
+    double b = 0.5;
+    tiered->process(a);
+    compressor.process(b);
+    EXPECT_EQ(a, b);
+}
+
+TEST(QualityTierTest, CreateBudgetControllerSuccess) {
+    const std::optional<BudgetController<double>> controller =
+            BudgetController<double>::create(
+                    {.deadline = std::chrono::microseconds(100)});
+    ASSERT_TRUE(controller.has_value());
+}
+
+TEST(QualityTierTest, CreateBudgetControllerFailureInvalidDeadline) {
+    const std::optional<BudgetController<double>> controller =
+            BudgetController<double>::create({});
+    ASSERT_FALSE(controller.has_value());
+}
+
+TEST(QualityTierTest, CreateBudgetControllerFailureInvalidLoads) {
+    const std::optional<BudgetController<double>> controller =
+            BudgetController<double>::create(
+                    {.deadline = std::chrono::microseconds(100),
+                     .demoteLoad = 0.5,
+                     .promoteLoad = 0.9});
+    ASSERT_FALSE(controller.has_value());
+}
+
+TEST(QualityTierTest, ControllerDemotesLowestPriorityFirst) {
+    auto low = TieredProcessor<Compressor<double>>::create(make_compressor());
+    auto high = TieredProcessor<Compressor<double>>::create(make_compressor());
+    auto controller = BudgetController<double>::create(
+            {.deadline = std::chrono::microseconds(100)});
+    ASSERT_TRUE(low.has_value());
+    ASSERT_TRUE(high.has_value());
+    ASSERT_TRUE(controller.has_value());
+    controller->add(*high, 10);
+    controller->add(*low, 1);
+    const auto overload = std::chrono::microseconds(150);
+
+    controller->update(overload);
+    EXPECT_EQ(low->tier(), QualityTier::Fast);
+    EXPECT_EQ(high->tier(), QualityTier::Exact);
+    controller->update(overload);
+    EXPECT_EQ(low->tier(), QualityTier::ControlRate);
+    EXPECT_EQ(high->tier(), QualityTier::Exact);
+    controller->update(overload);
+    EXPECT_EQ(high->tier(), QualityTier::Fast);
+    controller->update(overload);
+    controller->update(overload);
+    EXPECT_EQ(controller->tier(0), QualityTier::ControlRate);
+    EXPECT_EQ(controller->tier(1), QualityTier::ControlRate);
+    EXPECT_EQ(controller->demotions(), 4u);
+    EXPECT_DOUBLE_EQ(controller->load(), 1.5);
+}
+
+TEST(QualityTierTest, ControllerPromotesHighestPriorityAfterCalmBlocks) {
+    auto low = TieredProcessor<Compressor<double>>::create(make_compressor());
+    auto high = TieredProcessor<Compressor<double>>::create(make_compressor());
+    auto controller = BudgetController<double>::create(
+            {.deadline = std::chrono::microseconds(100),
+             .promoteBlocks = 4});
+    ASSERT_TRUE(low.has_value());
+    ASSERT_TRUE(high.has_value());
+    ASSERT_TRUE(controller.has_value());
+    controller->add(*low, 1);
+    controller->add(*high, 10);
+    for (int i = 0; i < 4; i++) {
+        controller->update(std::chrono::microseconds(150));
+    }
+    EXPECT_EQ(high->tier(), QualityTier::ControlRate);
+
+    /// Between the promotion and demotion loads nothing changes:
+    for (int i = 0; i < 10; i++) {
+        controller->update(std::chrono::microseconds(70));
+    }
+    EXPECT_EQ(controller->promotions(), 0u);
+
+    for (int i = 0; i < 3; i++) {
+        controller->update(std::chrono::microseconds(10));
+    }
+    EXPECT_EQ(high->tier(), QualityTier::ControlRate);
+    controller->update(std::chrono::microseconds(10));
+    EXPECT_EQ(high->tier(), QualityTier::Fast);
+    EXPECT_EQ(low->tier(), QualityTier::ControlRate);
+    for (int i = 0; i < 4; i++) {
+        controller->update(std::chrono::microseconds(10));
+    }
+    EXPECT_EQ(high->tier(), QualityTier::Exact);
+    for (int i = 0; i < 4; i++) {
+        controller->update(std::chrono::microseconds(10));
+    }
+    EXPECT_EQ(low->tier(), QualityTier::Fast);
+}
+
+TEST(QualityTierTest, ControllerProcessesEveryBuffer) {
+    Compressor<double> compressor = make_compressor();
+    auto first = TieredProcessor<Compressor<double>>::create(compressor);
+    auto second = TieredProcessor<Compressor<double>>::create(compressor);
+    auto controller = BudgetController<double>::create(
+            {.deadline = std::chrono::seconds(10)});
+    ASSERT_TRUE(first.has_value());
+    ASSERT_TRUE(second.has_value());
+    ASSERT_TRUE(controller.has_value());
+    controller->add(*first);
+    controller->add(*second);
+    const std::vector<double> input = make_signal(480);
+    std::vector<double> a = input;
+    std::vector<double> b = input;
+    double *buffers[] = {a.data(), b.data()};
+    controller->process(buffers, input.size());
+    std::vector<double> expected = input;
+    compressor.process(expected.data(), expected.size());
+    EXPECT_EQ(a, expected);
+    EXPECT_EQ(b, expected);
+    EXPECT_LT(controller->load(), 0.5);
+}
@@ -0,0 +1,756 @@
+/// RealtimeSafetyTest.cpp
+
+/**
+ * Real-time safety audit. Heap allocation, pthread mutex locking and exception
+ * allocation are interposed for the whole executable and counted while an
+ * AuditScope is active on the calling thread. Every processor is then driven
+ * through long randomized runs of configurations, block sizes and signals,
+ * and any hit inside `process` fails the test. This target cannot be built
+ * with AddressSanitizer, which interposes the same symbols.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <mutex>
+#include <new>
+#include <pthread.h>
+#include <random>
+#include <string>
+#include <vector>
+#include "Automixer.h"
+#include "BlockAdapter.h"
+#include "Compressor.h"
+#include "DeEsser.h"
+#include "Expander.h"
+#include "Limiter.h"
+#include "LoudnessNormalizer.h"
+#include "NoiseGate.h"
+#include "QualityTier.h"
+#include "SharedPreset.h"
+#include "SpectralProcessor.h"
+#include "StereoProcessor.h"
+#include "TraceRecorder.h"
+#include "TransientShaper.h"
+
+namespace {
+thread_local bool auditing = false;
+std::atomic<size_t> allocations{0};
+std::atomic<size_t> locks{0};
+std::atomic<size_t> throws{0};
+
+/**
+ * @brief Counts an interposed call if the calling thread is being audited
+ * @param counter Counter to increment
+ */
+auto record(std::atomic<size_t> &counter) -> void {
+    if (auditing) {
+        counter.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Audits the calling thread for as long as it is alive
+ */
+class AuditScope {
+public:
+    AuditScope() { auditing = true; }
+    ~AuditScope() { auditing = false; }
+    AuditScope(const AuditScope &) = delete;
+    auto operator=(const AuditScope &) -> AuditScope & = delete;
+};
+
+/**
+ * @brief Snapshot of the interposed call counters
+ */
+struct AuditCounts {
+    size_t allocations = 0;
+    size_t locks = 0;
+    size_t throws = 0;
+};
+
+auto counts() -> AuditCounts {
+    return AuditCounts{.allocations = allocations.load(),
+                       .locks = locks.load(),
+                       .throws = throws.load()};
+}
+
+auto reset_counts() -> void {
+    allocations = 0;
+    locks = 0;
+    throws = 0;
+}
+
+template<typename F>
+auto resolve_next(const char *name) -> F {
+    return reinterpret_cast<F>(dlsym(RTLD_NEXT, name));
+}
+} // namespace
+
+/// Heap interposition. glibc exports its allocator under __libc_* names, which
+/// lets these forward without recursing through dlsym.
+#if defined(__GLIBC__)
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *pointer, size_t size);
+void __libc_free(void *pointer);
+
+void *malloc(size_t size) {
+    record(allocations);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) {
+    record(allocations);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, size_t size) {
+    record(allocations);
+    return __libc_realloc(pointer, size);
+}
+
+void free(void *pointer) {
+    record(allocations);
+    __libc_free(pointer);
+}
+}
+#endif
+
+auto operator new(size_t size) -> void * {
+    record(allocations);
+    if (void *pointer = std::malloc(size == 0 ? 1 : size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+auto operator new[](size_t size) -> void * { return operator new(size); }
+
+auto operator delete(void *pointer) noexcept -> void {
+    record(allocations);
+    std::free(pointer);
+}
+
+auto operator delete[](void *pointer) noexcept -> void {
+    operator delete(pointer);
+}
+
+auto operator delete(void *pointer, size_t) noexcept -> void {
+    operator delete(pointer);
+}
+
+auto operator delete[](void *pointer, size_t) noexcept -> void {
+    operator delete(pointer);
+}
+
+/// Lock and exception interposition
+extern "C" {
+int pthread_mutex_lock(pthread_mutex_t *mutex) {
+    record(locks);
+    static auto next = resolve_next<int (*)(pthread_mutex_t *)>(
+            "pthread_mutex_lock");
+    return next(mutex);
+}
+
+int pthread_mutex_trylock(pthread_mutex_t *mutex) {
+    record(locks);
+    static auto next = resolve_next<int (*)(pthread_mutex_t *)>(
+            "pthread_mutex_trylock");
+    return next(mutex);
+}
+
+void *__cxa_allocate_exception(size_t size) noexcept {
+    record(throws);
+    static auto next = resolve_next<void *(*) (size_t)>(
+            "__cxa_allocate_exception");
+    return next(size);
+}
+}
+
+namespace {
+constexpr size_t runsPerProcessor = 2000;
+constexpr int sampleRates[] = {22050, 44100, 48000, 96000, 192000};
+constexpr size_t blockSizes[] = {1, 37, 64, 256, 441, 512, 1024, 4096};
+
+/**
+ * @brief Randomized inputs shared by every audit
+ */
+struct AuditInput {
+    std::mt19937 engine{20250101};
+
+    auto sample_rate() -> int {
+        return sampleRates[engine() % std::size(sampleRates)];
+    }
+
+    auto block_size() -> size_t {
+        return blockSizes[engine() % std::size(blockSizes)];
+    }
+
+    auto uniform(const double low, const double high) -> double {
+        return std::uniform_real_distribution<double>(low, high)(engine);
+    }
+
+    auto milliseconds() -> std::chrono::milliseconds {
+        return std::chrono::milliseconds(1 + engine() % 500);
+    }
+
+    /**
+     * @brief Fills a block with either silence, a full-scale burst or noise
+     * @param samples Block to fill
+     */
+    template<typename T>
+    auto fill(std::vector<T> &samples) -> void {
+        const unsigned kind = engine() % 4;
+        for (T &sample: samples) {
+            switch (kind) {
+                case 0:
+                    sample = static_cast<T>(1e-9);
+                    break;
+                case 1:
+                    sample = static_cast<T>(uniform(0.9, 1.0));
+                    break;
+                default:
+                    sample = static_cast<T>(uniform(1e-6, 1.0));
+                    break;
+            }
+        }
+    }
+};
+
+/**
+ * @brief Per-block processing time relative to the block's real-time deadline
+ */
+struct BlockLoad {
+    /** Worst case over the whole run */
+    double worst = 0.0;
+
+    /** 99th percentile over the whole run */
+    double percentile99 = 0.0;
+};
+
+/**
+ * @brief Drives a processor through randomized blocks under audit
+ * @tparam T Type of the samples
+ * @param input Randomized input source
+ * @param process Callable processing one block under audit
+ * @param reconfigure Callable re-creating the processor with a random
+ * configuration at the given sample rate, called outside the audit. A fatal
+ * failure inside it ends the run
+ * @return Block load statistics for the run
+ */
+template<typename T, typename Process, typename Reconfigure>
+auto audit(AuditInput &input, Process &&process, Reconfigure &&reconfigure)
+        -> BlockLoad {
+    std::vector<double> loads;
+    loads.reserve(runsPerProcessor);
+    std::vector<T> samples;
+    samples.reserve(blockSizes[std::size(blockSizes) - 1]);
+    int sampleRate = 0;
+    for (size_t run = 0; run < runsPerProcessor; run++) {
+        if (run % 64 == 0) {
+            sampleRate = input.sample_rate();
+            reconfigure(sampleRate);
+            if (testing::Test::HasFatalFailure()) {
+                return {};
+            }
+        }
+        samples.resize(input.block_size());
+        input.fill(samples);
+        const auto start = std::chrono::steady_clock::now();
+        {
+            AuditScope scope;
+            process(samples.data(), samples.size());
+        }
+        const std::chrono::duration<double> elapsed =
+                std::chrono::steady_clock::now() - start;
+        /// Tiny blocks are held to at least 1 ms so that timer resolution does
+        /// not dominate the measurement
+        const double deadline = std::max(
+                static_cast<double>(samples.size()) / sampleRate, 1e-3);
+        loads.push_back(elapsed.count() / deadline);
+    }
+    std::sort(loads.begin(), loads.end());
+    return BlockLoad{.worst = loads.back(),
+                     .percentile99 = loads[loads.size() * 99 / 100]};
+}
+
+/**
+ * @brief Records and checks the outcome of an audit
+ * @details The worst case is recorded but not asserted on, since a single
+ * preemption by the OS scheduler can push any one block past its deadline on
+ * a shared machine. The 99th percentile has to stay within real time.
+ * @param name Name of the processor
+ * @param load Block load statistics for the run
+ */
+auto expect_realtime_safe(const std::string &name, const BlockLoad load)
+        -> void {
+    const AuditCounts hits = counts();
+    testing::Test::RecordProperty(name + "WorstCaseLoadPercent",
+                                  std::to_string(load.worst * 100.0));
+    testing::Test::RecordProperty(name + "P99LoadPercent",
+                                  std::to_string(load.percentile99 * 100.0));
+    EXPECT_EQ(hits.allocations, 0u) << name << " allocated in process()";
+    EXPECT_EQ(hits.locks, 0u) << name << " locked a mutex in process()";
+    EXPECT_EQ(hits.throws, 0u) << name << " threw in process()";
+    EXPECT_LT(load.percentile99, 1.0) << name << " missed real-time deadlines";
+}
+} // namespace
+
+TEST(RealtimeSafetyTest, InterpositionDetectsViolations) {
+    reset_counts();
+    {
+        AuditScope scope;
+        auto *leak = new std::vector<int>(16);
+        delete leak;
+    }
+    std::mutex mutex;
+    {
+        AuditScope scope;
+        const std::lock_guard<std::mutex> lock(mutex);
+    }
+    {
+        AuditScope scope;
+        try {
+            throw std::runtime_error("audit");
+        } catch (const std::runtime_error &) {
+        }
+    }
+    const AuditCounts hits = counts();
+    ASSERT_GT(hits.allocations, 0u);
+    ASSERT_GT(hits.locks, 0u);
+    ASSERT_GT(hits.throws, 0u);
+}
+
+TEST(RealtimeSafetyTest, Limiter) {
+    reset_counts();
+    AuditInput input;
+    std::optional<Limiter<float>> limiter;
+    const BlockLoad load = audit<float>(
+            input, [&](float *samples, size_t count) {
+                limiter->process(samples, count);
+            },
+            [&](const int sampleRate) {
+                auto config = LimiterConfiguration<float>{
+                        .sampleRate = sampleRate,
+                        .threshold = static_cast<float>(input.uniform(-60, 0)),
+                        .attack = input.milliseconds(),
+                        .release = input.milliseconds(),
+                        .makeupGain = static_cast<float>(input.uniform(0, 6))};
+                if (input.engine() % 2 == 0) {
+                    config.kneeWidth = static_cast<float>(input.uniform(1, 12));
+                }
+                limiter = Limiter<float>::create(config);
+                ASSERT_TRUE(limiter.has_value());
+            });
+    expect_realtime_safe("Limiter", load);
+}
+
+TEST(RealtimeSafetyTest, Compressor) {
+    reset_counts();
+    AuditInput input;
+    std::optional<Compressor<float, double>> compressor;
+    const BlockLoad load = audit<float>(
+            input, [&](float *samples, size_t count) {
+                compressor->process(samples, count);
+            },
+            [&](const int sampleRate) {
+                auto config = CompressorConfiguration<float>{
+                        .sampleRate = sampleRate,
+                        .threshold = static_cast<float>(input.uniform(-60, 0)),
+                        .attack = input.milliseconds(),
+                        .release = input.milliseconds(),
+                        .ratio = static_cast<float>(input.uniform(1, 20)),
+                        .makeupGain = static_cast<float>(input.uniform(0, 6))};
+                if (input.engine() % 2 == 0) {
+                    config.kneeWidth = static_cast<float>(input.uniform(1, 12));
+                }
+                compressor = Compressor<float, double>::create(config);
+                ASSERT_TRUE(compressor.has_value());
+            });
+    expect_realtime_safe("Compressor", load);
+}
+
+TEST(RealtimeSafetyTest, CompressorWithAutomation) {
+    reset_counts();
+    AuditInput input;
+    std::optional<Compressor<double>> compressor;
+    std::vector<ParameterEvent<double>> events;
+    const BlockLoad load = audit<double>(
+            input, [&](double *samples, size_t count) {
+                compressor->process(samples, count, events);
+            },
+            [&](const int sampleRate) {
+                auto config = CompressorConfiguration<double>{
+                        .sampleRate = sampleRate,
+                        .threshold = input.uniform(-60, 0),
+                        .attack = input.milliseconds(),
+                        .release = input.milliseconds(),
+                        .ratio = input.uniform(1, 20),
+                        .makeupGain = input.uniform(0, 6),
+                        .kneeWidth = input.uniform(1, 12)};
+                compressor = Compressor<double>::create(config);
+                ASSERT_TRUE(compressor.has_value());
+                events = {{.offset = 0,
+                           .parameter = Parameter::Threshold,
+                           .value = input.uniform(-60, 0),
+                           .rampLength = 100},
+                          {.offset = 20,
+                           .parameter = Parameter::Ratio,
+                           .value = input.uniform(1, 20)}};
+            });
+    expect_realtime_safe("CompressorWithAutomation", load);
+}
+
+TEST(RealtimeSafetyTest, Expander) {
+    reset_counts();
+    AuditInput input;
+    std::optional<Expander<double>> expander;
+    const BlockLoad load = audit<double>(
+            input, [&](double *samples, size_t count) {
+                expander->process(samples, count);
+            },
+            [&](const int sampleRate) {
+                auto config = ExpanderConfiguration<double>{
+                        .sampleRate = sampleRate,
+                        .threshold = input.uniform(-60, 0),
+                        .attack = input.milliseconds(),
+                        .release = input.milliseconds(),
+                        .ratio = input.uniform(1, 20),
+                        .makeupGain = input.uniform(-6, 0)};
+                if (input.engine() % 2 == 0) {
+                    config.kneeWidth = input.uniform(1, 12);
+                }
+                expander = Expander<double>::create(config);
+                ASSERT_TRUE(expander.has_value());
+            });
+    expect_realtime_safe("Expander", load);
+}
+
+TEST(RealtimeSafetyTest, NoiseGate) {
+    reset_counts();
+    AuditInput input;
+    std::optional<NoiseGate<float>> noiseGate;
+    const BlockLoad load = audit<float>(
+            input, [&](float *samples, size_t count) {
+                noiseGate->process(samples, count);
+            },
+            [&](const int sampleRate) {
+                noiseGate = NoiseGate<float>::create(NoiseGateConfiguration<
+                                                     float>{
+                        .sampleRate = sampleRate,
+                        .threshold = static_cast<float>(input.uniform(-80, 0)),
+                        .attack = input.milliseconds(),
+                        .release = input.milliseconds()});
+                ASSERT_TRUE(noiseGate.has_value());
+            });
+    expect_realtime_safe("NoiseGate", load);
+}
+
+TEST(RealtimeSafetyTest, LoudnessNormalizer) {
+    reset_counts();
+    AuditInput input;
+    std::optional<LoudnessNormalizer<float, double>> normalizer;
+    const BlockLoad load = audit<float>(
+            input, [&](float *samples, size_t count) {
+                normalizer->process(samples, count);
+            },
+            [&](const int sampleRate) {
+                const auto window =
+                        static_cast<LoudnessWindow>(input.engine() % 3);
+                normalizer = LoudnessNormalizer<float, double>::create(
+                        LoudnessNormalizerConfiguration<float>{
+                                .sampleRate = sampleRate,
+                                .targetLoudness = static_cast<float>(
+                                        input.uniform(-30, -10)),
+                                .window = window,
+                                .attack = input.milliseconds(),
+                                .release = input.milliseconds(),
+                                .maxGain = static_cast<float>(
+                                        input.uniform(0, 20))});
+                ASSERT_TRUE(normalizer.has_value());
+            });
+    expect_realtime_safe("LoudnessNormalizer", load);
+}
+
+TEST(RealtimeSafetyTest, DeEsser) {
+    reset_counts();
+    AuditInput input;
+    std::optional<DeEsser<float, double>> deEsser;
+    const BlockLoad load = audit<float>(
+            input, [&](float *samples, size_t count) {
+                deEsser->process(samples, count);
+            },
+            [&](const int sampleRate) {
+                auto created = DeEsser<float, double>::create(
+                        DeEsserConfiguration<float>{
+                                .sampleRate = sampleRate,
+                                .frequency = static_cast<float>(
+                                        input.uniform(3000, 10000)),
+                                .detector = static_cast<DeEsserDetector>(
+                                        input.engine() % 2),
+                                .threshold = static_cast<float>(
+                                        input.uniform(-60, 0)),
+                                .attack = input.milliseconds(),
+                                .release = input.milliseconds(),
+                                .ratio = static_cast<float>(
+                                        input.uniform(1, 20)),
+                                .mode = static_cast<DeEsserMode>(
+                                        input.engine() % 2),
+                                .channels = 2});
+                ASSERT_TRUE(created.has_value());
+                deEsser.reset();
+                deEsser.emplace(std::move(*created));
+            });
+    expect_realtime_safe("DeEsser", load);
+}
+
+TEST(RealtimeSafetyTest, SharedProcessor) {
+    reset_counts();
+    AuditInput input;
+    const auto make_preset = [&input](const int sampleRate) {
+        return Compressor<float>::create(CompressorConfiguration<float>{
+                .sampleRate = sampleRate,
+                .threshold = static_cast<float>(input.uniform(-60, 0)),
+                .attack = input.milliseconds(),
+                .release = input.milliseconds(),
+                .ratio = static_cast<float>(input.uniform(1, 20)),
+                .makeupGain = 1.0f});
+    };
+    std::optional<Compressor<float>> preset = make_preset(48000);
+    ASSERT_TRUE(preset.has_value());
+    std::optional<PresetChannel<Compressor<float>>> channel =
+            PresetChannel<Compressor<float>>::create(*preset);
+    ASSERT_TRUE(channel.has_value());
+    /// The audio thread picks up each new preset inside the audited block:
+    SharedProcessor<Compressor<float>> processor(*channel);
+    const BlockLoad load = audit<float>(
+            input, [&](float *samples, size_t count) {
+                processor.process(samples, count);
+            },
+            [&](const int sampleRate) {
+                std::optional<Compressor<float>> next =
+                        make_preset(sampleRate);
+                ASSERT_TRUE(next.has_value());
+                channel->publish(*next);
+            });
+    expect_realtime_safe("SharedProcessor", load);
+}
+
+TEST(RealtimeSafetyTest, TieredProcessor) {
+    reset_counts();
+    AuditInput input;
+    std::optional<TieredProcessor<Compressor<float>>> tiered;
+    const BlockLoad load = audit<float>(
+            input, [&](float *samples, size_t count) {
+                tiered->process(samples, count);
+            },
+            [&](const int sampleRate) {
+                if (!tiered.has_value() || input.engine() % 2 == 0) {
+                    std::optional<Compressor<float>> compressor =
+                            Compressor<float>::create(
+                                    CompressorConfiguration<float>{
+                                            .sampleRate = sampleRate,
+                                            .threshold = static_cast<float>(
+                                                    input.uniform(-60, 0)),
+                                            .attack = input.milliseconds(),
+                                            .release = input.milliseconds(),
+                                            .ratio = static_cast<float>(
+                                                    input.uniform(1, 20))});
+                    ASSERT_TRUE(compressor.has_value());
+                    tiered = TieredProcessor<Compressor<float>>::create(
+                            *compressor, 1 + input.engine() % 64);
+                    ASSERT_TRUE(tiered.has_value());
+                }
+                tiered->set_tier(static_cast<QualityTier>(input.engine() % 3));
+            });
+    expect_realtime_safe("TieredProcessor", load);
+}
+
+TEST(RealtimeSafetyTest, SpectralProcessor) {
+    reset_counts();
+    AuditInput input;
+    std::optional<SpectralProcessor<Compressor<float>>> spectral;
+    const BlockLoad load = audit<float>(
+            input, [&](float *samples, size_t count) {
+                spectral->process(samples, count);
+            },
+            [&](const int sampleRate) {
+                const size_t fftSize = size_t{256} << (input.engine() % 4);
+                std::optional<Compressor<float>> compressor =
+                        Compressor<float>::create(CompressorConfiguration<
+                                                  float>{
+                                .sampleRate = sampleRate,
+                                .threshold = static_cast<float>(
+                                        input.uniform(-60, 0)),
+                                .attack = input.milliseconds(),
+                                .release = input.milliseconds(),
+                                .ratio = static_cast<float>(
+                                        input.uniform(1, 20))});
+                ASSERT_TRUE(compressor.has_value());
+                spectral = SpectralProcessor<Compressor<float>>::create(
+                        *compressor,
+                        {.fftSize = fftSize,
+                         .hopSize = fftSize >> (1 + input.engine() % 2)});
+                ASSERT_TRUE(spectral.has_value());
+            });
+    expect_realtime_safe("SpectralProcessor", load);
+}
+
+TEST(RealtimeSafetyTest, StereoProcessor) {
+    reset_counts();
+    AuditInput input;
+    std::optional<StereoProcessor<Compressor<float>>> stereo;
+    const BlockLoad load = audit<float>(
+            input, [&](float *samples, size_t count) {
+                stereo->process(samples, count);
+            },
+            [&](const int sampleRate) {
+                const auto make = [&]() {
+                    return Compressor<float>::create(
+                            CompressorConfiguration<float>{
+                                    .sampleRate = sampleRate,
+                                    .threshold = static_cast<float>(
+                                            input.uniform(-60, 0)),
+                                    .attack = input.milliseconds(),
+                                    .release = input.milliseconds(),
+                                    .ratio = static_cast<float>(
+                                            input.uniform(1, 20))});
+                };
+                std::optional<Compressor<float>> left = make();
+                std::optional<Compressor<float>> right = make();
+                ASSERT_TRUE(left.has_value());
+                ASSERT_TRUE(right.has_value());
+                stereo = StereoProcessor<Compressor<float>>::create(
+                        *left, *right,
+                        {.mode = static_cast<StereoMode>(input.engine() % 3),
+                         .matrix = {0.9f, 0.2f, -0.4f, 1.1f}});
+                ASSERT_TRUE(stereo.has_value());
+            });
+    expect_realtime_safe("StereoProcessor", load);
+}
+
+TEST(RealtimeSafetyTest, TracedProcessor) {
+    reset_counts();
+    AuditInput input;
+    std::optional<TraceRecorder> recorder;
+    std::optional<TracedProcessor<Compressor<float>>> traced;
+    const BlockLoad load = audit<float>(
+            input, [&](float *samples, size_t count) {
+                traced->process(samples, count);
+            },
+            [&](const int sampleRate) {
+                const CompressorConfiguration<float> config = {
+                        .sampleRate = sampleRate,
+                        .threshold = static_cast<float>(input.uniform(-60, 0)),
+                        .attack = input.milliseconds(),
+                        .release = input.milliseconds(),
+                        .ratio = static_cast<float>(input.uniform(1, 20)),
+                        .makeupGain = 1.0f};
+                if (!traced.has_value() || input.engine() % 2 == 0) {
+                    traced.reset();
+                    recorder.emplace(size_t{1} << 16,
+                                     std::pmr::get_default_resource());
+                    traced = TracedProcessor<Compressor<float>>::create(
+                            config, *recorder);
+                    ASSERT_TRUE(traced.has_value());
+                } else {
+                    traced->set_configuration(config);
+                }
+            });
+    expect_realtime_safe("TracedProcessor", load);
+}
+
+TEST(RealtimeSafetyTest, BlockAdapter) {
+    reset_counts();
+    AuditInput input;
+    std::optional<BlockAdapter<TieredProcessor<Compressor<float>>>> adapter;
+    const BlockLoad load = audit<float>(
+            input, [&](float *samples, size_t count) {
+                adapter->process(samples, count);
+            },
+            [&](const int sampleRate) {
+                std::optional<Compressor<float>> compressor =
+                        Compressor<float>::create(
+                                CompressorConfiguration<float>{
+                                        .sampleRate = sampleRate,
+                                        .threshold = static_cast<float>(
+                                                input.uniform(-60, 0)),
+                                        .attack = input.milliseconds(),
+                                        .release = input.milliseconds(),
+                                        .ratio = static_cast<float>(
+                                                input.uniform(1, 20))});
+                ASSERT_TRUE(compressor.has_value());
+                auto tiered =
+                        TieredProcessor<Compressor<float>>::create(*compressor);
+                ASSERT_TRUE(tiered.has_value());
+                tiered->set_tier(static_cast<QualityTier>(input.engine() % 3));
+                auto created =
+                        BlockAdapter<TieredProcessor<Compressor<float>>>::
+                                create(std::move(*tiered),
+                                       {.blockSize = size_t{1}
+                                                     << (input.engine() % 10),
+                                        .zeroLatency =
+                                                input.engine() % 2 == 0});
+                ASSERT_TRUE(created.has_value());
+                adapter.reset();
+                adapter.emplace(std::move(*created));
+            });
+    expect_realtime_safe("BlockAdapter", load);
+}
+
+TEST(RealtimeSafetyTest, Automixer) {
+    reset_counts();
+    AuditInput input;
+    std::optional<Automixer<float>> automixer;
+    const BlockLoad load = audit<float>(
+            input, [&](float *samples, size_t count) {
+                automixer->process(samples, count);
+            },
+            [&](const int sampleRate) {
+                automixer.reset();
+                automixer = Automixer<float>::create(
+                        {.sampleRate = sampleRate,
+                         .channels = 1 + input.engine() % 8,
+                         .attack = input.milliseconds(),
+                         .release = input.milliseconds(),
+                         .holdThreshold =
+                                 static_cast<float>(input.uniform(-80, -20)),
+                         .lastMicHold = input.engine() % 2 == 0,
+                         .controlInterval = 1 + input.engine() % 64});
+                ASSERT_TRUE(automixer.has_value());
+            });
+    expect_realtime_safe("Automixer", load);
+}
+
+TEST(RealtimeSafetyTest, TransientShaper) {
+    reset_counts();
+    AuditInput input;
+    std::optional<TransientShaper<float>> shaper;
+    const BlockLoad load = audit<float>(
+            input, [&](float *samples, size_t count) {
+                shaper->process(samples, count);
+            },
+            [&](const int sampleRate) {
+                shaper.reset();
+                shaper = TransientShaper<float>::create(
+                        {.sampleRate = sampleRate,
+                         .fastAttack = input.milliseconds(),
+                         .fastRelease = input.milliseconds(),
+                         .slowAttack = input.milliseconds(),
+                         .slowRelease = input.milliseconds(),
+                         .attackGain =
+                                 static_cast<float>(input.uniform(-12, 12)),
+                         .sustainGain =
+                                 static_cast<float>(input.uniform(-12, 12)),
+                         .channels = 1 + input.engine() % 4,
+                         .linked = input.engine() % 2 == 0});
+                ASSERT_TRUE(shaper.has_value());
+            });
+    expect_realtime_safe("TransientShaper", load);
+}
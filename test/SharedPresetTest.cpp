@@ -0,0 +1,135 @@
+/// SharedPresetTest.cpp
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "Compressor.h"
+#include "NoiseGate.h"
+#include "SharedPreset.h"
+
+namespace {
+/// Throws, failing the test, if the configuration is rejected
+auto make_compressor(const double threshold) -> Compressor<double> {
+    return Compressor<double>::create({.sampleRate = 48000,
+                                       .threshold = threshold,
+                                       .attack = std::chrono::milliseconds(5),
+                                       .release = std::chrono::milliseconds(50),
+                                       .ratio = 4.0,
+                                       .makeupGain = 1.0,
+                                       .kneeWidth = 3.0})
+            .value();
+}
+
+auto make_signal(const size_t count) -> std::vector<double> {
+    std::vector<double> samples(count);
+    for (size_t i = 0; i < count; i++) {
+        samples[i] = 0.05 + 0.9 * static_cast<double>((i * 37) % 101) / 101.0;
+        if (i % 2 == 1) {
+            samples[i] = -samples[i];
+        }
+    }
+    return samples;
+}
+} // namespace
+
+TEST(SharedPresetTest, SharedProcessorMatchesProcessor) {
+    std::optional<PresetChannel<Compressor<double>>> channel =
+            PresetChannel<Compressor<double>>::create(make_compressor(-20.0));
+    ASSERT_TRUE(channel.has_value());
+    ASSERT_TRUE(channel.has_value());
+    SharedProcessor<Compressor<double>> shared(*channel);
+    Compressor<double> compressor = make_compressor(-20.0);
+    std::vector<double> a = make_signal(4800);
+    std::vector<double> b = a;
+    shared.process(a.data(), a.size());
+    compressor.process(b.data(), b.size());
+    EXPECT_EQ(a, b);
+}
+
+TEST(SharedPresetTest, NoiseGateMatchesProcessor) {
+    constexpr auto config = NoiseGateConfiguration<double>{
+            .sampleRate = 48000,
+            .threshold = -20.0,
+            .attack = std::chrono::milliseconds(5),
+            .release = std::chrono::milliseconds(50)};
+    std::optional<NoiseGate<double>> noiseGate =
+            NoiseGate<double>::create(config);
+    ASSERT_TRUE(noiseGate.has_value());
+    std::optional<PresetChannel<NoiseGate<double>>> channel =
+            PresetChannel<NoiseGate<double>>::create(*noiseGate);
+    ASSERT_TRUE(channel.has_value());
+    SharedProcessor<NoiseGate<double>> shared(*channel);
+    /// The gate stays open at its threshold level, so the envelopes are
+    /// compared as well as the outputs:
+    for (size_t block = 0; block < 4; block++) {
+        std::vector<double> a = make_signal(1200);
+        std::vector<double> b = a;
+        shared.process(a.data(), a.size());
+        noiseGate->process(b.data(), b.size());
+        EXPECT_EQ(a, b);
+        ASSERT_GT(noiseGate->envelope(), 0.0);
+        ASSERT_EQ(shared.state(), noiseGate->envelope());
+    }
+}
+
+TEST(SharedPresetTest, PublishIsPickedUpAtNextBlock) {
+    std::optional<PresetChannel<Compressor<double>>> channel =
+            PresetChannel<Compressor<double>>::create(make_compressor(-20.0));
+    ASSERT_TRUE(channel.has_value());
+    std::vector<SharedProcessor<Compressor<double>>> fleet;
+    fleet.reserve(100);
+    for (int i = 0; i < 100; i++) {
+        fleet.emplace_back(*channel);
+    }
+    channel->publish(make_compressor(-6.0));
+    /// Nobody has processed a block yet, so the old preset is still held:
+    EXPECT_EQ(channel->collect(), 1u);
+    EXPECT_DOUBLE_EQ(fleet[0].preset().target_gain(-10.0),
+                     make_compressor(-20.0).target_gain(-10.0));
+
+    std::vector<double> samples = make_signal(64);
+    for (SharedProcessor<Compressor<double>> &processor: fleet) {
+        processor.process(samples.data(), samples.size());
+    }
+    EXPECT_DOUBLE_EQ(fleet[99].preset().target_gain(-10.0),
+                     make_compressor(-6.0).target_gain(-10.0));
+    EXPECT_EQ(channel->collect(), 0u);
+}
+
+TEST(SharedPresetTest, ProcessorIsSmallerThanFullProcessor) {
+    EXPECT_LE(sizeof(SharedProcessor<Compressor<float>>), 3 * sizeof(void *));
+    EXPECT_LT(sizeof(SharedProcessor<Compressor<float>>),
+              sizeof(Compressor<float>));
+}
+
+TEST(SharedPresetTest, ConcurrentPublishAndProcess) {
+    std::optional<PresetChannel<Compressor<double>>> channel =
+            PresetChannel<Compressor<double>>::create(make_compressor(-20.0));
+    ASSERT_TRUE(channel.has_value());
+    std::atomic<bool> running = true;
+    std::vector<std::thread> audioThreads;
+    for (int t = 0; t < 4; t++) {
+        audioThreads.emplace_back([&channel, &running]() {
+            std::vector<SharedProcessor<Compressor<double>>> fleet;
+            fleet.reserve(16);
+            for (int i = 0; i < 16; i++) {
+                fleet.emplace_back(*channel);
+            }
+            std::vector<double> samples = make_signal(32);
+            while (running.load()) {
+                for (auto &processor: fleet) {
+                    processor.process(samples.data(), samples.size());
+                }
+            }
+        });
+    }
+    for (int i = 0; i < 2000; i++) {
+        channel->publish(make_compressor(-40.0 + (i % 30)));
+    }
+    running = false;
+    for (std::thread &thread: audioThreads) {
+        thread.join();
+    }
+    EXPECT_EQ(channel->collect(), 0u);
+}
@@ -0,0 +1,129 @@
+/// SpectralProcessorTest.cpp
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <complex>
+#include <numbers>
+#include <vector>
+#include "Compressor.h"
+#include "Expander.h"
+#include "SpectralProcessor.h"
+
+namespace {
+constexpr int sampleRate = 48000;
+
+auto make_compressor(const double ratio) -> Compressor<double> {
+    return *Compressor<double>::create(
+            {.sampleRate = sampleRate,
+             .threshold = -30.0,
+             .attack = std::chrono::milliseconds(5),
+             .release = std::chrono::milliseconds(50),
+             .ratio = ratio,
+             .makeupGain = 1.0});
+}
+
+/// A loud 1 kHz tone at -6 dB and a quiet 5 kHz tone at -40 dB
+auto make_tones(const size_t count) -> std::vector<double> {
+    std::vector<double> samples(count);
+    for (size_t n = 0; n < count; n++) {
+        const double t = static_cast<double>(n) / sampleRate;
+        samples[n] = 0.5 * std::sin(2.0 * std::numbers::pi * 1000.0 * t) +
+                     0.01 * std::sin(2.0 * std::numbers::pi * 5000.0 * t);
+    }
+    return samples;
+}
+
+/// Amplitude of a tone over the last second of a signal
+auto amplitude(const std::vector<double> &samples, const double frequency)
+        -> double {
+    std::complex<double> sum = 0.0;
+    for (size_t n = samples.size() - sampleRate; n < samples.size(); n++) {
+        const double t = static_cast<double>(n) / sampleRate;
+        sum += samples[n] *
+               std::polar(1.0, -2.0 * std::numbers::pi * frequency * t);
+    }
+    return 2.0 * std::abs(sum) / sampleRate;
+}
+} // namespace
+
+TEST(SpectralProcessorTest, CreateSpectralProcessorSuccess) {
+    const std::optional<SpectralProcessor<Compressor<double>>> spectral =
+            SpectralProcessor<Compressor<double>>::create(make_compressor(4.0));
+    ASSERT_TRUE(spectral.has_value());
+}
+
+TEST(SpectralProcessorTest, CreateSpectralProcessorFailureInvalidFftSize) {
+    const std::optional<SpectralProcessor<Compressor<double>>> spectral =
+            SpectralProcessor<Compressor<double>>::create(
+                    make_compressor(4.0), {.fftSize = 1000, .hopSize = 250});
+    ASSERT_FALSE(spectral.has_value());
+}
+
+TEST(SpectralProcessorTest, CreateSpectralProcessorFailureZeroHop) {
+    const std::optional<SpectralProcessor<Compressor<double>>> spectral =
+            SpectralProcessor<Compressor<double>>::create(
+                    make_compressor(4.0), {.fftSize = 1024, .hopSize = 0});
+    ASSERT_FALSE(spectral.has_value());
+}
+
+TEST(SpectralProcessorTest, CreateSpectralProcessorFailureHopOverHalf) {
+    const std::optional<SpectralProcessor<Compressor<double>>> spectral =
+            SpectralProcessor<Compressor<double>>::create(
+                    make_compressor(4.0), {.fftSize = 1024, .hopSize = 768});
+    ASSERT_FALSE(spectral.has_value());
+}
+
+TEST(SpectralProcessorTest, CreateSpectralProcessorFailureHopNotDivisor) {
+    const std::optional<SpectralProcessor<Compressor<double>>> spectral =
+            SpectralProcessor<Compressor<double>>::create(
+                    make_compressor(4.0), {.fftSize = 1024, .hopSize = 384});
+    ASSERT_FALSE(spectral.has_value());
+}
+
+TEST(SpectralProcessorTest, UnityRatioReconstructsDelayedInput) {
+    auto spectral = SpectralProcessor<Compressor<double>>::create(
+            make_compressor(1.0), {.fftSize = 512, .hopSize = 128});
+    ASSERT_TRUE(spectral.has_value());
+    EXPECT_EQ(spectral->latency(), 511u);
+    EXPECT_EQ(spectral->bins(), 257u);
+    const std::vector<double> input = make_tones(8192);
+    std::vector<double> output = input;
+    /// Odd block size, so frames straddle blocks:
+    for (size_t i = 0; i < output.size(); i += 100) {
+        spectral->process(output.data() + i,
+                          std::min<size_t>(100, output.size() - i));
+    }
+    for (size_t n = spectral->latency(); n < output.size(); n++) {
+        EXPECT_NEAR(output[n], input[n - spectral->latency()], 1e-9) << n;
+    }
+}
+
+TEST(SpectralProcessorTest, CompressesOnlyTheLoudBins) {
+    auto spectral = SpectralProcessor<Compressor<double>>::create(
+            make_compressor(4.0));
+    ASSERT_TRUE(spectral.has_value());
+    std::vector<double> samples = make_tones(3 * sampleRate);
+    spectral->process(samples.data(), samples.size());
+    /// -6 dB over a -30 dB threshold at 4:1 settles 18 dB lower:
+    EXPECT_LT(amplitude(samples, 1000.0), 0.5 * std::pow(10.0, -12.0 / 20.0));
+    EXPECT_NEAR(amplitude(samples, 5000.0), 0.01, 0.0005);
+}
+
+TEST(SpectralProcessorTest, ExpanderLiftsOnlyTheQuietBins) {
+    const std::optional<Expander<double>> expander = Expander<double>::create(
+            {.sampleRate = sampleRate,
+             .threshold = -30.0,
+             .attack = std::chrono::milliseconds(5),
+             .release = std::chrono::milliseconds(50),
+             .ratio = 4.0,
+             .makeupGain = 1.0});
+    ASSERT_TRUE(expander.has_value());
+    auto spectral = SpectralProcessor<Expander<double>>::create(*expander);
+    ASSERT_TRUE(spectral.has_value());
+    std::vector<double> samples = make_tones(3 * sampleRate);
+    spectral->process(samples.data(), samples.size());
+    EXPECT_NEAR(amplitude(samples, 1000.0), 0.5, 0.01);
+    /// -40 dB lifted towards -32.5 dB, more in the window's side bins:
+    EXPECT_GT(amplitude(samples, 5000.0), 0.02);
+    EXPECT_LT(amplitude(samples, 5000.0), 0.0316);
+}
@@ -0,0 +1,52 @@
+/// SpscRingTest.cpp
+
+#include <gtest/gtest.h>
+#include <thread>
+#include "SpscRing.h"
+
+TEST(SpscRingTest, CapacityIsRoundedUpToPowerOfTwo) {
+    const SpscRing<int> ring(5);
+    EXPECT_EQ(ring.capacity(), 8u);
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(SpscRingTest, PushAndPopInOrder) {
+    SpscRing<int> ring(4);
+    for (int i = 0; i < 4; i++) {
+        int value = i;
+        ASSERT_TRUE(ring.try_push(value));
+    }
+    EXPECT_TRUE(ring.full());
+    int extra = 4;
+    EXPECT_FALSE(ring.try_push(extra));
+    EXPECT_EQ(ring.size(), 4u);
+    for (int i = 0; i < 4; i++) {
+        int value = -1;
+        ASSERT_TRUE(ring.try_pop(value));
+        EXPECT_EQ(value, i);
+    }
+    int value = -1;
+    EXPECT_FALSE(ring.try_pop(value));
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(SpscRingTest, TwoThreadsPreserveOrder) {
+    constexpr size_t count = 200000;
+    SpscRing<size_t> ring(16);
+    std::thread producer([&ring]() {
+        for (size_t i = 0; i < count; i++) {
+            size_t value = i;
+            while (!ring.try_push(value)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    for (size_t i = 0; i < count; i++) {
+        size_t value = 0;
+        while (!ring.try_pop(value)) {
+            std::this_thread::yield();
+        }
+        ASSERT_EQ(value, i);
+    }
+    producer.join();
+}
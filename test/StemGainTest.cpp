@@ -0,0 +1,65 @@
+/// StemGainTest.cpp
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "Compressor.h"
+#include "StemGain.h"
+
+TEST(StemGainTest, ApplyGainMultipliesEveryStem) {
+    constexpr size_t count = 3 * gainTileSize + 17;
+    std::vector<double> gains(count);
+    std::vector<std::vector<double>> stems(5, std::vector<double>(count));
+    for (size_t i = 0; i < count; i++) {
+        gains[i] = 0.5 + static_cast<double>(i % 7) / 7.0;
+        for (size_t k = 0; k < stems.size(); k++) {
+            stems[k][i] = static_cast<double>(k + 1) * 0.1 -
+                          static_cast<double>(i % 3);
+        }
+    }
+    const std::vector<std::vector<double>> input = stems;
+    std::vector<double *> pointers;
+    for (std::vector<double> &stem: stems) {
+        pointers.push_back(stem.data());
+    }
+    apply_gain<double>(gains, pointers);
+    for (size_t k = 0; k < stems.size(); k++) {
+        for (size_t i = 0; i < count; i++) {
+            ASSERT_EQ(stems[k][i], input[k][i] * gains[i]);
+        }
+    }
+}
+
+TEST(StemGainTest, OneAnalysisDrivesStemsLikeProcess) {
+    constexpr auto config = CompressorConfiguration<float>{
+            .sampleRate = 48000,
+            .threshold = -20.0f,
+            .attack = std::chrono::milliseconds(5),
+            .release = std::chrono::milliseconds(50),
+            .ratio = 4.0f,
+            .makeupGain = 1.0f};
+    std::optional<Compressor<float>> bus = Compressor<float>::create(config);
+    std::optional<Compressor<float>> reference =
+            Compressor<float>::create(config);
+    ASSERT_TRUE(bus.has_value());
+    ASSERT_TRUE(reference.has_value());
+    constexpr size_t count = 2000;
+    std::vector<float> mix(count);
+    std::vector<float> drums(count);
+    std::vector<float> vocals(count);
+    for (size_t i = 0; i < count; i++) {
+        drums[i] = 0.6f * static_cast<float>((i * 37) % 101) / 101.0f;
+        vocals[i] = 0.3f - 0.2f * static_cast<float>(i % 11) / 11.0f;
+        mix[i] = drums[i] + vocals[i];
+    }
+    std::vector<float> gains(count);
+    bus->compute_gain(mix, gains);
+    float *stems[] = {drums.data(), vocals.data()};
+    apply_gain(gains.data(), stems, 2, count);
+
+    /// The stems sum to the mix compressed by the same gains, within
+    /// rounding of the two products:
+    reference->process(mix.data(), count);
+    for (size_t i = 0; i < count; i++) {
+        EXPECT_NEAR(drums[i] + vocals[i], mix[i], 1e-6f);
+    }
+}
@@ -0,0 +1,155 @@
+/// StereoProcessorTest.cpp
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <numbers>
+#include <vector>
+#include "Compressor.h"
+#include "StereoProcessor.h"
+
+namespace {
+constexpr int sampleRate = 48000;
+constexpr size_t frames = 4800;
+
+auto make_compressor(const double threshold) -> Compressor<double> {
+    return *Compressor<double>::create(
+            {.sampleRate = sampleRate,
+             .threshold = threshold,
+             .attack = std::chrono::milliseconds(1),
+             .release = std::chrono::milliseconds(20),
+             .ratio = 4.0,
+             .makeupGain = 1.0});
+}
+
+/// Interleaved stereo with different content on each side
+auto make_stereo() -> std::vector<double> {
+    std::vector<double> samples(2 * frames);
+    for (size_t i = 0; i < frames; i++) {
+        const double t = static_cast<double>(i) / sampleRate;
+        samples[2 * i] = 0.8 * std::sin(2.0 * std::numbers::pi * 440.0 * t);
+        samples[2 * i + 1] =
+                0.3 * std::sin(2.0 * std::numbers::pi * 1300.0 * t);
+    }
+    return samples;
+}
+} // namespace
+
+TEST(StereoProcessorTest, CreateStereoProcessorSuccess) {
+    const std::optional<StereoProcessor<Compressor<double>>> stereo =
+            StereoProcessor<Compressor<double>>::create(
+                    make_compressor(-20.0),
+                    {.mode = StereoMode::Matrix,
+                     .matrix = {1.0, 2.0, 3.0, 4.0}});
+    ASSERT_TRUE(stereo.has_value());
+}
+
+TEST(StereoProcessorTest, CreateStereoProcessorFailureSingularMatrix) {
+    const std::optional<StereoProcessor<Compressor<double>>> stereo =
+            StereoProcessor<Compressor<double>>::create(
+                    make_compressor(-20.0),
+                    {.mode = StereoMode::Matrix,
+                     .matrix = {1.0, 2.0, 2.0, 4.0}});
+    ASSERT_FALSE(stereo.has_value());
+}
+
+TEST(StereoProcessorTest, IdentityMatrixMatchesTwoProcessors) {
+    Compressor<double> left = make_compressor(-20.0);
+    Compressor<double> right = make_compressor(-30.0);
+    auto stereo = StereoProcessor<Compressor<double>>::create(
+            left, right, {.mode = StereoMode::Matrix});
+    ASSERT_TRUE(stereo.has_value());
+    std::vector<double> samples = make_stereo();
+    std::vector<double> expected = samples;
+    stereo->process(samples.data(), samples.size());
+    for (size_t i = 0; i < frames; i++) {
+        left.process(expected[2 * i]);
+        right.process(expected[2 * i + 1]);
+    }
+    for (size_t i = 0; i < samples.size(); i++) {
+        EXPECT_DOUBLE_EQ(samples[i], expected[i]);
+    }
+}
+
+TEST(StereoProcessorTest, LinkedKeepsTheStereoImage) {
+    auto stereo = StereoProcessor<Compressor<double>>::create(
+            make_compressor(-20.0));
+    ASSERT_TRUE(stereo.has_value());
+    std::vector<double> samples(2 * frames);
+    for (size_t i = 0; i < frames; i++) {
+        samples[2 * i] = 0.8 * std::sin(0.05 * static_cast<double>(i));
+        samples[2 * i + 1] = 0.25 * samples[2 * i];
+    }
+    stereo->process(samples.data(), samples.size());
+    EXPECT_LT(stereo->gain(), -10.0);
+    for (size_t i = 0; i < frames; i++) {
+        EXPECT_NEAR(samples[2 * i + 1], 0.25 * samples[2 * i], 1e-15);
+    }
+}
+
+TEST(StereoProcessorTest, MidSideMatchesEncodeProcessDecode) {
+    Compressor<double> mid = make_compressor(-20.0);
+    Compressor<double> side = make_compressor(-40.0);
+    auto stereo = StereoProcessor<Compressor<double>>::create(
+            mid, side, {.mode = StereoMode::MidSide});
+    ASSERT_TRUE(stereo.has_value());
+    std::vector<double> samples = make_stereo();
+    std::vector<double> expected = samples;
+    stereo->process(samples.data(), samples.size());
+    for (size_t i = 0; i < frames; i++) {
+        double m = (expected[2 * i] + expected[2 * i + 1]) / 2.0;
+        double s = (expected[2 * i] - expected[2 * i + 1]) / 2.0;
+        mid.process(m);
+        side.process(s);
+        expected[2 * i] = m + s;
+        expected[2 * i + 1] = m - s;
+    }
+    for (size_t i = 0; i < samples.size(); i++) {
+        EXPECT_NEAR(samples[i], expected[i], 1e-12);
+    }
+}
+
+TEST(StereoProcessorTest, UnityGainMidSideReconstructsInput) {
+    const std::optional<Compressor<double>> unity = Compressor<double>::create(
+            {.sampleRate = sampleRate,
+             .threshold = 0.0,
+             .attack = std::chrono::milliseconds(1),
+             .release = std::chrono::milliseconds(20),
+             .ratio = 1.0,
+             .makeupGain = 0.0});
+    ASSERT_TRUE(unity.has_value());
+    auto stereo = StereoProcessor<Compressor<double>>::create(
+            *unity, {.mode = StereoMode::MidSide});
+    ASSERT_TRUE(stereo.has_value());
+    std::vector<double> samples = make_stereo();
+    const std::vector<double> input = samples;
+    stereo->process(samples.data(), samples.size());
+    for (size_t i = 0; i < samples.size(); i++) {
+        EXPECT_NEAR(samples[i], input[i], 1e-15);
+    }
+}
+
+TEST(StereoProcessorTest, PlanarMatchesInterleaved) {
+    const Compressor<double> compressor = make_compressor(-25.0);
+    const StereoConfiguration<double> config = {
+            .mode = StereoMode::Matrix, .matrix = {0.9, 0.1, -0.3, 1.2}};
+    auto interleaved =
+            StereoProcessor<Compressor<double>>::create(compressor, config);
+    auto planar =
+            StereoProcessor<Compressor<double>>::create(compressor, config);
+    ASSERT_TRUE(interleaved.has_value());
+    ASSERT_TRUE(planar.has_value());
+    std::vector<double> samples = make_stereo();
+    std::vector<double> left(frames);
+    std::vector<double> right(frames);
+    for (size_t i = 0; i < frames; i++) {
+        left[i] = samples[2 * i];
+        right[i] = samples[2 * i + 1];
+    }
+    interleaved->process(samples.data(), samples.size());
+    double *channels[] = {left.data(), right.data()};
+    planar->process(channels, frames);
+    for (size_t i = 0; i < frames; i++) {
+        EXPECT_DOUBLE_EQ(left[i], samples[2 * i]);
+        EXPECT_DOUBLE_EQ(right[i], samples[2 * i + 1]);
+    }
+}
@@ -0,0 +1,203 @@
+/// StreamingPipelineTest.cpp
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include "Compressor.h"
+#include "Limiter.h"
+#include "NoiseGate.h"
+#include "StreamingPipeline.h"
+
+namespace {
+constexpr auto gateConfig = NoiseGateConfiguration<float>{
+        .sampleRate = 48000,
+        .threshold = -40.0f,
+        .attack = std::chrono::milliseconds(1),
+        .release = std::chrono::milliseconds(50)};
+
+constexpr auto compressorConfig = CompressorConfiguration<float>{
+        .sampleRate = 48000,
+        .threshold = -20.0f,
+        .attack = std::chrono::milliseconds(10),
+        .release = std::chrono::milliseconds(100),
+        .ratio = 4.0f,
+        .makeupGain = 1.0f,
+        .kneeWidth = 6.0f};
+
+constexpr auto limiterConfig = LimiterConfiguration<float>{
+        .sampleRate = 48000,
+        .threshold = -3.0f,
+        .attack = std::chrono::milliseconds(1),
+        .release = std::chrono::milliseconds(50),
+        .makeupGain = 1.0f};
+
+auto make_signal(const size_t count) -> std::vector<float> {
+    std::vector<float> samples(count);
+    for (size_t i = 0; i < count; i++) {
+        const float level = (i / 3000) % 2 == 0 ? 0.9f : 0.05f;
+        samples[i] = (i % 2 == 0 ? 1.0f : -1.0f) * level;
+    }
+    return samples;
+}
+
+/// The same chain run serially, as the reference
+auto process_serially(std::vector<float> samples) -> std::vector<float> {
+    std::optional<NoiseGate<float>> gate =
+            NoiseGate<float>::create(gateConfig);
+    std::optional<Compressor<float>> compressor =
+            Compressor<float>::create(compressorConfig);
+    std::optional<Limiter<float>> limiter =
+            Limiter<float>::create(limiterConfig);
+    gate->process(samples.data(), samples.size());
+    compressor->process(samples.data(), samples.size());
+    limiter->process(samples.data(), samples.size());
+    return samples;
+}
+
+/// Reader over a vector, in irregular read sizes
+struct VectorSource {
+    const std::vector<float> &samples;
+    size_t position = 0;
+
+    auto operator()(float *destination, const size_t maximum) -> size_t {
+        const size_t n = std::min({maximum, samples.size() - position,
+                                   static_cast<size_t>(333)});
+        std::copy_n(samples.begin() + position, n, destination);
+        position += n;
+        return n;
+    }
+};
+} // namespace
+
+TEST(StreamingPipelineTest, CreateStreamingPipelineFailureInvalidBlockSize) {
+    const std::optional<StreamingPipeline<float>> pipeline =
+            StreamingPipeline<float>::create({.blockSize = 0});
+    ASSERT_FALSE(pipeline.has_value());
+}
+
+TEST(StreamingPipelineTest, ChainMatchesSerialProcessing) {
+    const std::vector<float> input = make_signal(100000);
+    const std::vector<float> expected = process_serially(input);
+    for (const size_t threads: {size_t{0}, size_t{1}, size_t{2}}) {
+        std::optional<NoiseGate<float>> gate =
+                NoiseGate<float>::create(gateConfig);
+        std::optional<Compressor<float>> compressor =
+                Compressor<float>::create(compressorConfig);
+        std::optional<Limiter<float>> limiter =
+                Limiter<float>::create(limiterConfig);
+        std::optional<StreamingPipeline<float>> pipeline =
+                StreamingPipeline<float>::create(
+                        {.blockSize = 512,
+                         .blockCount = 8,
+                         .queueCapacity = 2,
+                         .threads = threads});
+        ASSERT_TRUE(pipeline.has_value());
+        pipeline->add_stage(*gate);
+        pipeline->add_stage(*compressor);
+        pipeline->add_stage(*limiter);
+
+        std::vector<float> output;
+        output.reserve(input.size());
+        const PipelineStatistics statistics = pipeline->run(
+                VectorSource{.samples = input},
+                [&output](const float *samples, const size_t count) {
+                    output.insert(output.end(), samples, samples + count);
+                });
+
+        ASSERT_EQ(output.size(), expected.size());
+        for (size_t i = 0; i < output.size(); i++) {
+            ASSERT_FLOAT_EQ(output[i], expected[i]) << "at sample " << i;
+        }
+        EXPECT_EQ(statistics.samples, input.size());
+        ASSERT_EQ(statistics.stages.size(), 3u);
+        for (const StageStatistics &stage: statistics.stages) {
+            EXPECT_EQ(stage.blocks, statistics.blocks);
+            EXPECT_LE(stage.maxQueueDepth, 2u);
+            EXPECT_GE(stage.meanQueueDepth, 1.0);
+        }
+        EXPECT_GT(statistics.samples_per_second(), 0.0);
+    }
+}
+
+TEST(StreamingPipelineTest, BackpressureHoldsSlowSink) {
+    const std::vector<float> input = make_signal(20000);
+    std::optional<Compressor<float>> compressor =
+            Compressor<float>::create(compressorConfig);
+    std::optional<StreamingPipeline<float>> pipeline =
+            StreamingPipeline<float>::create(
+                    {.blockSize = 256, .blockCount = 4, .queueCapacity = 2});
+    ASSERT_TRUE(pipeline.has_value());
+    pipeline->add_stage(*compressor);
+    size_t received = 0;
+    const PipelineStatistics statistics = pipeline->run(
+            VectorSource{.samples = input},
+            [&received](const float *, const size_t count) {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+                received += count;
+            });
+    EXPECT_EQ(received, input.size());
+    EXPECT_GT(statistics.stages[0].stalls, 0u);
+}
+
+TEST(StreamingPipelineTest, FileSource) {
+    const std::vector<float> input = make_signal(5000);
+    char path[] = "/tmp/streaming_pipeline_test_XXXXXX";
+    const int descriptor = mkstemp(path);
+    ASSERT_GE(descriptor, 0);
+    std::FILE *output = fdopen(descriptor, "wb");
+    std::fwrite(input.data(), sizeof(float), input.size(), output);
+    std::fclose(output);
+
+    std::optional<FileSource<float>> source = FileSource<float>::create(path);
+    ASSERT_TRUE(source.has_value());
+    std::optional<StreamingPipeline<float>> pipeline =
+            StreamingPipeline<float>::create({.blockSize = 1000});
+    ASSERT_TRUE(pipeline.has_value());
+    std::vector<float> result;
+    pipeline->run(*source, [&result](const float *samples, const size_t n) {
+        result.insert(result.end(), samples, samples + n);
+    });
+    std::remove(path);
+    EXPECT_EQ(result, input);
+    EXPECT_FALSE(FileSource<float>::create("/nonexistent/file").has_value());
+}
+
+TEST(StreamingPipelineTest, LoopbackSource) {
+    const std::vector<float> input = make_signal(50000);
+    const std::vector<float> expected = process_serially(input);
+    std::optional<NoiseGate<float>> gate = NoiseGate<float>::create(gateConfig);
+    std::optional<Compressor<float>> compressor =
+            Compressor<float>::create(compressorConfig);
+    std::optional<Limiter<float>> limiter =
+            Limiter<float>::create(limiterConfig);
+    std::optional<StreamingPipeline<float>> pipeline =
+            StreamingPipeline<float>::create({.blockSize = 480});
+    ASSERT_TRUE(pipeline.has_value());
+    pipeline->add_stage(*gate);
+    pipeline->add_stage(*compressor);
+    pipeline->add_stage(*limiter);
+
+    LoopbackSource<float> network(1024);
+    std::thread sender([&network, &input]() {
+        /// Packets of varying size, as they would arrive off the wire:
+        for (size_t position = 0; position < input.size();) {
+            const size_t n = std::min<size_t>(100 + position % 700,
+                                              input.size() - position);
+            network.send(input.data() + position, n);
+            position += n;
+        }
+        network.close();
+    });
+    std::vector<float> output;
+    pipeline->run(network, [&output](const float *samples, const size_t n) {
+        output.insert(output.end(), samples, samples + n);
+    });
+    sender.join();
+    ASSERT_EQ(output.size(), expected.size());
+    for (size_t i = 0; i < output.size(); i++) {
+        ASSERT_FLOAT_EQ(output[i], expected[i]);
+    }
+}
@@ -0,0 +1,224 @@
+/// TraceRecorderTest.cpp
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <string>
+#include <vector>
+#include "Compressor.h"
+#include "Expander.h"
+#include "TraceRecorder.h"
+
+namespace {
+constexpr auto baseConfig = CompressorConfiguration<float>{
+        .sampleRate = 48000,
+        .threshold = -20.0f,
+        .attack = std::chrono::milliseconds(2),
+        .release = std::chrono::milliseconds(40),
+        .ratio = 4.0f,
+        .makeupGain = 1.0f};
+
+auto signal(const size_t count) -> std::vector<float> {
+    std::vector<float> samples(count);
+    for (size_t i = 0; i < count; i++) {
+        samples[i] = 0.9f * std::sin(0.01f * static_cast<float>(i)) *
+                     std::sin(0.0003f * static_cast<float>(i));
+    }
+    return samples;
+}
+
+auto trace_path(const char *name) -> std::string {
+    return testing::TempDir() + name;
+}
+} // namespace
+
+TEST(TraceRecorderTest, CreateTraceRecorderSuccess) {
+    const std::optional<TraceRecorder> recorder = TraceRecorder::create(1000);
+    ASSERT_TRUE(recorder.has_value());
+    EXPECT_EQ(recorder->capacity(), 1024);
+}
+
+TEST(TraceRecorderTest, CreateTraceRecorderFailureTinyRing) {
+    const std::optional<TraceRecorder> recorder = TraceRecorder::create(8);
+    ASSERT_FALSE(recorder.has_value());
+}
+
+TEST(TraceRecorderTest, ReplayIsBitIdentical) {
+    const std::string path = trace_path("replay.trace");
+    std::optional<TraceRecorder> recorder = TraceRecorder::create(1 << 20);
+    ASSERT_TRUE(recorder.has_value());
+    std::vector<std::vector<float>> outputs;
+    {
+        std::optional<TraceFile> file =
+                TraceFile::create(path.c_str(), 1 << 20);
+        ASSERT_TRUE(file.has_value());
+        auto traced =
+                TracedProcessor<Compressor<float>>::create(baseConfig,
+                                                           *recorder);
+        ASSERT_TRUE(traced.has_value());
+        const std::vector<float> input = signal(20000);
+        const size_t sizes[] = {512, 17, 1, 333, 2048, 64};
+        size_t offset = 0;
+        for (size_t block = 0; offset < input.size(); block++) {
+            const size_t count =
+                    std::min(sizes[block % 6], input.size() - offset);
+            std::vector<float> samples(input.begin() + offset,
+                                       input.begin() + offset + count);
+            traced->process(samples.data(), count);
+            outputs.push_back(samples);
+            offset += count;
+            if (block == 7) {
+                CompressorConfiguration<float> config = baseConfig;
+                config.threshold = -35.0f;
+                config.kneeWidth = 6.0f;
+                traced->set_configuration(config);
+            }
+            if (block == 13) {
+                traced->reset();
+            }
+            recorder->flush(*file);
+        }
+    }
+    EXPECT_EQ(recorder->dropped(), 0);
+    EXPECT_EQ(recorder->lost(), 0);
+
+    std::optional<TraceReader> reader = TraceReader::open(path.c_str());
+    ASSERT_TRUE(reader.has_value());
+    size_t visited = 0;
+    const auto compare = [&](const TraceBlock<float> &block) {
+        const std::vector<float> &expected = outputs[block.index];
+        ASSERT_EQ(block.samples.size(), expected.size());
+        for (size_t i = 0; i < expected.size(); i++) {
+            EXPECT_EQ(block.samples[i], expected[i]);
+        }
+        EXPECT_FALSE(block.gap);
+        visited++;
+    };
+    const std::optional<size_t> blocks =
+            replay_trace<Compressor<float>>(reader->records(), compare);
+    ASSERT_TRUE(blocks.has_value());
+    EXPECT_EQ(*blocks, outputs.size());
+    EXPECT_EQ(visited, outputs.size());
+}
+
+TEST(TraceRecorderTest, FullRingDropsAndFlagsTheGap) {
+    std::optional<TraceRecorder> recorder = TraceRecorder::create(4096);
+    ASSERT_TRUE(recorder.has_value());
+    auto traced =
+            TracedProcessor<Compressor<float>>::create(baseConfig, *recorder);
+    ASSERT_TRUE(traced.has_value());
+    std::vector<float> samples = signal(512);
+    for (int i = 0; i < 4; i++) {
+        traced->process(samples.data(), samples.size());
+    }
+    EXPECT_EQ(recorder->dropped(), 3);
+
+    const std::string path = trace_path("gap.trace");
+    std::optional<TraceFile> file = TraceFile::create(path.c_str(), 1 << 16);
+    ASSERT_TRUE(file.has_value());
+    recorder->flush(*file);
+    traced->process(samples.data(), samples.size());
+    recorder->flush(*file);
+    file->close();
+
+    std::optional<TraceReader> reader = TraceReader::open(path.c_str());
+    ASSERT_TRUE(reader.has_value());
+    std::vector<bool> gaps;
+    replay_trace<Compressor<float>>(
+            reader->records(),
+            [&](const TraceBlock<float> &block) { gaps.push_back(block.gap); });
+    EXPECT_EQ(gaps, (std::vector<bool>{false, true}));
+}
+
+TEST(TraceRecorderTest, FullFileLosesRecords) {
+    std::optional<TraceRecorder> recorder = TraceRecorder::create(1 << 16);
+    ASSERT_TRUE(recorder.has_value());
+    auto traced =
+            TracedProcessor<Compressor<float>>::create(baseConfig, *recorder);
+    ASSERT_TRUE(traced.has_value());
+    std::vector<float> samples = signal(256);
+    for (int i = 0; i < 4; i++) {
+        traced->process(samples.data(), samples.size());
+    }
+    const std::string path = trace_path("full.trace");
+    std::optional<TraceFile> file = TraceFile::create(path.c_str(), 3000);
+    ASSERT_TRUE(file.has_value());
+    recorder->flush(*file);
+    EXPECT_EQ(recorder->lost(), 2);
+    file->close();
+    std::optional<TraceReader> reader = TraceReader::open(path.c_str());
+    ASSERT_TRUE(reader.has_value());
+    EXPECT_EQ(replay_trace<Compressor<float>>(reader->records(),
+                                              [](const auto &) {}),
+              std::optional<size_t>(2));
+}
+
+TEST(TraceRecorderTest, FullFileFlagsTheGap) {
+    std::optional<TraceRecorder> recorder = TraceRecorder::create(1 << 16);
+    ASSERT_TRUE(recorder.has_value());
+    auto traced =
+            TracedProcessor<Compressor<float>>::create(baseConfig, *recorder);
+    ASSERT_TRUE(traced.has_value());
+    /// The middle block does not fit, the smaller one after it does:
+    for (const size_t count: {256, 512, 16}) {
+        std::vector<float> samples = signal(count);
+        traced->process(samples.data(), samples.size());
+    }
+    const std::string path = trace_path("lost.trace");
+    std::optional<TraceFile> file = TraceFile::create(path.c_str(), 1300);
+    ASSERT_TRUE(file.has_value());
+    recorder->flush(*file);
+    EXPECT_EQ(recorder->lost(), 1);
+    file->close();
+    std::optional<TraceReader> reader = TraceReader::open(path.c_str());
+    ASSERT_TRUE(reader.has_value());
+    std::vector<bool> gaps;
+    replay_trace<Compressor<float>>(
+            reader->records(),
+            [&](const TraceBlock<float> &block) { gaps.push_back(block.gap); });
+    EXPECT_EQ(gaps, (std::vector<bool>{false, true}));
+}
+
+TEST(TraceRecorderTest, ReplayRejectsAnotherProcessorType) {
+    /// Same configuration size, so only the processor type tag differs:
+    static_assert(sizeof(CompressorConfiguration<float>) ==
+                  sizeof(ExpanderConfiguration<float>));
+    std::optional<TraceRecorder> recorder = TraceRecorder::create(1 << 16);
+    ASSERT_TRUE(recorder.has_value());
+    auto traced =
+            TracedProcessor<Compressor<float>>::create(baseConfig, *recorder);
+    ASSERT_TRUE(traced.has_value());
+    std::vector<float> samples = signal(128);
+    traced->process(samples.data(), samples.size());
+
+    const std::string path = trace_path("compressor.trace");
+    {
+        std::optional<TraceFile> file =
+                TraceFile::create(path.c_str(), 1 << 16);
+        ASSERT_TRUE(file.has_value());
+        recorder->flush(*file);
+    }
+    std::optional<TraceReader> reader = TraceReader::open(path.c_str());
+    ASSERT_TRUE(reader.has_value());
+    EXPECT_FALSE(replay_trace<Expander<float>>(reader->records(),
+                                               [](const auto &) {})
+                         .has_value());
+    using MixedCompressor = Compressor<float, double>;
+    EXPECT_FALSE(replay_trace<MixedCompressor>(reader->records(),
+                                               [](const auto &) {})
+                         .has_value());
+    EXPECT_EQ(replay_trace<Compressor<float>>(reader->records(),
+                                              [](const auto &) {}),
+              std::optional<size_t>(1));
+}
+
+TEST(TraceRecorderTest, OpenRejectsOtherFiles) {
+    EXPECT_FALSE(TraceReader::open("/nonexistent/trace").has_value());
+    const std::string path = trace_path("empty.trace");
+    {
+        std::optional<TraceFile> file = TraceFile::create(path.c_str(), 64);
+        ASSERT_TRUE(file.has_value());
+    }
+    std::optional<TraceReader> reader = TraceReader::open(path.c_str());
+    ASSERT_TRUE(reader.has_value());
+    EXPECT_TRUE(reader->records().empty());
+}
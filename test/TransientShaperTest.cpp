@@ -0,0 +1,210 @@
+/// TransientShaperTest.cpp
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "TransientShaper.h"
+
+namespace {
+constexpr auto baseConfig = TransientShaperConfiguration<float>{
+        .sampleRate = 48000,
+        .fastAttack = std::chrono::milliseconds(1),
+        .fastRelease = std::chrono::milliseconds(20),
+        .slowAttack = std::chrono::milliseconds(20),
+        .slowRelease = std::chrono::milliseconds(200)};
+
+/// Silence, then a step to 0.5 for half a second, then a drop to 0.1
+auto steps() -> std::vector<float> {
+    std::vector<float> samples(48000 + 480, 0.0f);
+    std::fill(samples.begin() + 480, samples.begin() + 24480, 0.5f);
+    std::fill(samples.begin() + 24480, samples.end(), 0.1f);
+    return samples;
+}
+
+auto music(const size_t count, const float phase) -> std::vector<float> {
+    std::vector<float> samples(count);
+    for (size_t i = 0; i < count; i++) {
+        const float t = static_cast<float>(i);
+        samples[i] = std::sin(0.03f * t + phase) *
+                     std::exp(-0.002f * static_cast<float>(i % 4000));
+    }
+    return samples;
+}
+} // namespace
+
+TEST(TransientShaperTest, CreateTransientShaperSuccess) {
+    const std::optional<TransientShaper<float>> shaper =
+            TransientShaper<float>::create(baseConfig);
+    ASSERT_TRUE(shaper.has_value());
+}
+
+TEST(TransientShaperTest, CreateTransientShaperFailureInvalidSampleRate) {
+    TransientShaperConfiguration<float> config = baseConfig;
+    config.sampleRate = 0;
+    const std::optional<TransientShaper<float>> shaper =
+            TransientShaper<float>::create(config);
+    ASSERT_FALSE(shaper.has_value());
+}
+
+TEST(TransientShaperTest, CreateTransientShaperFailureInvalidRelease) {
+    TransientShaperConfiguration<float> config = baseConfig;
+    config.slowRelease = std::chrono::milliseconds(0);
+    const std::optional<TransientShaper<float>> shaper =
+            TransientShaper<float>::create(config);
+    ASSERT_FALSE(shaper.has_value());
+}
+
+TEST(TransientShaperTest, CreateTransientShaperFailureZeroChannels) {
+    TransientShaperConfiguration<float> config = baseConfig;
+    config.channels = 0;
+    const std::optional<TransientShaper<float>> shaper =
+            TransientShaper<float>::create(config);
+    ASSERT_FALSE(shaper.has_value());
+}
+
+TEST(TransientShaperTest, NeutralGainsPassThrough) {
+    auto shaper = TransientShaper<float>::create(baseConfig);
+    ASSERT_TRUE(shaper.has_value());
+    std::vector<float> samples = music(10000, 0.0f);
+    const std::vector<float> expected = samples;
+    shaper->process(samples.data(), samples.size());
+    EXPECT_EQ(samples, expected);
+}
+
+TEST(TransientShaperTest, AttackGainShapesTheOnset) {
+    TransientShaperConfiguration<float> config = baseConfig;
+    config.attackGain = 6.0f;
+    auto louder = TransientShaper<float>::create(config);
+    config.attackGain = -6.0f;
+    auto softer = TransientShaper<float>::create(config);
+    ASSERT_TRUE(louder.has_value());
+    ASSERT_TRUE(softer.has_value());
+    std::vector<float> up = steps();
+    std::vector<float> down = up;
+    louder->process(up.data(), up.size());
+    softer->process(down.data(), down.size());
+    /// 2 ms after the onset, then once both envelopes have settled:
+    EXPECT_GT(up[480 + 96], 0.5f * 1.6f);
+    EXPECT_LT(down[480 + 96], 0.5f * 0.8f);
+    EXPECT_NEAR(up[24000], 0.5f, 1e-3f);
+    EXPECT_NEAR(down[24000], 0.5f, 1e-3f);
+}
+
+TEST(TransientShaperTest, SustainGainShapesTheDecay) {
+    TransientShaperConfiguration<float> config = baseConfig;
+    config.sustainGain = -12.0f;
+    auto tighter = TransientShaper<float>::create(config);
+    config.sustainGain = 6.0f;
+    auto longer = TransientShaper<float>::create(config);
+    ASSERT_TRUE(tighter.has_value());
+    ASSERT_TRUE(longer.has_value());
+    std::vector<float> tight = steps();
+    std::vector<float> sustained = tight;
+    tighter->process(tight.data(), tight.size());
+    longer->process(sustained.data(), sustained.size());
+    /// The onset is untouched, the decay 50 ms after the drop is not:
+    EXPECT_FLOAT_EQ(tight[480 + 96], 0.5f);
+    EXPECT_LT(tight[24480 + 2400], 0.1f * 0.6f);
+    EXPECT_GT(sustained[24480 + 2400], 0.1f * 1.5f);
+}
+
+TEST(TransientShaperTest, LinkedChannelsShareOneGain) {
+    TransientShaperConfiguration<float> config = baseConfig;
+    config.attackGain = 6.0f;
+    config.channels = 2;
+    auto unlinked = TransientShaper<float>::create(config);
+    config.linked = true;
+    auto linked = TransientShaper<float>::create(config);
+    ASSERT_TRUE(unlinked.has_value());
+    ASSERT_TRUE(linked.has_value());
+    /// A constant on the right channel, then a step on the left:
+    std::vector<float> settle(2 * 48000, 0.0f);
+    for (size_t i = 0; i < 48000; i++) {
+        settle[2 * i + 1] = 0.01f;
+    }
+    std::vector<float> settleLinked = settle;
+    unlinked->process(settle.data(), settle.size());
+    linked->process(settleLinked.data(), settleLinked.size());
+    const std::vector<float> step = steps();
+    std::vector<float> samples(2 * step.size());
+    for (size_t i = 0; i < step.size(); i++) {
+        samples[2 * i] = step[i];
+        samples[2 * i + 1] = 0.01f;
+    }
+    std::vector<float> shared = samples;
+    unlinked->process(samples.data(), samples.size());
+    linked->process(shared.data(), shared.size());
+    const size_t onset = 2 * (480 + 96);
+    EXPECT_NEAR(samples[onset + 1], 0.01f, 1e-4f);
+    EXPECT_FLOAT_EQ(shared[onset] / 0.5f, shared[onset + 1] / 0.01f);
+    EXPECT_GT(shared[onset + 1], 0.01f * 1.6f);
+}
+
+TEST(TransientShaperTest, PlanarMatchesInterleaved) {
+    constexpr size_t frames = 3000;
+    for (const bool link: {false, true}) {
+        TransientShaperConfiguration<float> config = baseConfig;
+        config.attackGain = 4.0f;
+        config.sustainGain = -3.0f;
+        config.channels = 3;
+        config.linked = link;
+        auto interleaved = TransientShaper<float>::create(config);
+        auto planar = TransientShaper<float>::create(config);
+        ASSERT_TRUE(interleaved.has_value());
+        ASSERT_TRUE(planar.has_value());
+        std::vector<std::vector<float>> channels = {
+                music(frames, 0.0f), music(frames, 1.0f), music(frames, 2.0f)};
+        std::vector<float> samples(3 * frames);
+        for (size_t i = 0; i < frames; i++) {
+            for (size_t c = 0; c < 3; c++) {
+                samples[i * 3 + c] = channels[c][i];
+            }
+        }
+        float *pointers[] = {channels[0].data(), channels[1].data(),
+                             channels[2].data()};
+        interleaved->process(samples.data(), samples.size());
+        planar->process(pointers, frames);
+        for (size_t i = 0; i < frames; i++) {
+            for (size_t c = 0; c < 3; c++) {
+                EXPECT_EQ(channels[c][i], samples[i * 3 + c]);
+            }
+        }
+    }
+}
+
+TEST(TransientShaperTest, RecoversFromNaN) {
+    for (const bool link: {false, true}) {
+        TransientShaperConfiguration<float> config = baseConfig;
+        config.attackGain = 6.0f;
+        config.channels = 2;
+        config.linked = link;
+        std::optional<TransientShaper<float>> shaper =
+                TransientShaper<float>::create(config);
+        ASSERT_TRUE(shaper.has_value());
+        std::vector<float> samples(2 * 48000);
+        for (size_t i = 0; i < samples.size(); i++) {
+            samples[i] = (i % 4) < 2 ? 0.3f : -0.3f;
+        }
+        samples[1000] = std::numeric_limits<float>::quiet_NaN();
+        samples[2001] = std::numeric_limits<float>::infinity();
+        shaper->process(samples.data(), samples.size());
+        EXPECT_TRUE(std::isfinite(shaper->fast_envelope(0)));
+        EXPECT_TRUE(std::isfinite(shaper->slow_envelope(0)));
+        for (size_t i = 4000; i < samples.size(); i++) {
+            ASSERT_TRUE(std::isfinite(samples[i])) << i;
+        }
+        EXPECT_NEAR(samples.back(), -0.3f, 1e-3f);
+    }
+}
+
+TEST(TransientShaperTest, ResetClearsTheEnvelopes) {
+    auto shaper = TransientShaper<float>::create(baseConfig);
+    ASSERT_TRUE(shaper.has_value());
+    std::vector<float> samples = steps();
+    shaper->process(samples.data(), samples.size());
+    EXPECT_GT(shaper->slow_envelope(0), 0.0f);
+    shaper->reset();
+    EXPECT_EQ(shaper->fast_envelope(0), 0.0f);
+    EXPECT_EQ(shaper->slow_envelope(0), 0.0f);
+}